@@ -0,0 +1,28 @@
+# Copies a generation baseline with one case's hash or step time replaced, so the tests can show the
+# regression run failing on it. Run as
+#    cmake -DIN_FILE=<baseline> -DOUT_FILE=<copy> -DCASE_KEY="<generator> <width> <height> <seed>"
+#          [-DHASH=<hex>] [-DMICROSECONDS_PER_STEP=<us>] -P TamperGenerationBaseline.cmake
+
+file(STRINGS ${IN_FILE} baselineLines)
+set(tamperedText "")
+set(didTamper FALSE)
+foreach(line IN LISTS baselineLines)
+   if(line MATCHES "^${CASE_KEY} ([0-9a-fA-F]+) ([0-9.]+)$")
+      set(hash ${CMAKE_MATCH_1})
+      set(microsecondsPerStep ${CMAKE_MATCH_2})
+      if(DEFINED HASH)
+         set(hash ${HASH})
+      endif()
+      if(DEFINED MICROSECONDS_PER_STEP)
+         set(microsecondsPerStep ${MICROSECONDS_PER_STEP})
+      endif()
+      set(line "${CASE_KEY} ${hash} ${microsecondsPerStep}")
+      set(didTamper TRUE)
+   endif()
+   string(APPEND tamperedText "${line}\n")
+endforeach()
+
+if(NOT didTamper)
+   message(FATAL_ERROR "No \"${CASE_KEY}\" line in ${IN_FILE}")
+endif()
+file(WRITE ${OUT_FILE} "${tamperedText}")
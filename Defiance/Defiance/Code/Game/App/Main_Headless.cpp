@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include <string>
+#include "Game/Generators/LevelBaker.hpp"
+#include "Game/Generators/GenerationRegression.hpp"
+#include "Game/Core/HeadlessSimulation.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+// The windowless modes of Main_Win32, for builds with no renderer. Run from Run_Win32 so Data/ is found
+int main(int argc, char* argv[])
+{
+   std::string commandLine;
+   for (int argumentIndex = 1; argumentIndex < argc; ++argumentIndex)
+   {
+      if (argumentIndex > 1)
+      {
+         commandLine += " ";
+      }
+      commandLine += argv[argumentIndex];
+   }
+
+   std::string bakeReport;
+   if (LevelBaker::RunFromCommandLine(commandLine, &bakeReport))
+   {
+      printf("%s\n", bakeReport.c_str());
+      return 0;
+   }
+
+   std::string regressionReport;
+   int regressionExitCode = 0;
+   if (GenerationRegression::RunFromCommandLine(commandLine, &regressionReport, &regressionExitCode))
+   {
+      printf("%s\n", regressionReport.c_str());
+      return regressionExitCode;
+   }
+
+   std::string simulationReport;
+   int simulationExitCode = 0;
+   if (HeadlessSimulation::RunFromCommandLine(commandLine, &simulationReport, &simulationExitCode))
+   {
+      printf("%s\n", simulationReport.c_str());
+      return simulationExitCode;
+   }
+
+   printf("Usage: DefianceHeadless -bake <environment> <firstSeed> <lastSeed> [threads] [outFile]\n");
+   printf("       DefianceHeadless -genregress [record] [baselineFile] [maxStepTimeGrowth]\n");
+   printf("       DefianceHeadless -simulate <environment> [npcs] [agent turns] [seed]\n");
+   return 1;
+}
\ No newline at end of file
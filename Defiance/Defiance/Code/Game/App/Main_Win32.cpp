@@ -10,6 +10,9 @@
 #include "Engine/Debug/Console.hpp"
 #include "Game/App/TheApp.hpp"
 #include "Game/Core/TheGame.hpp"
+#include "Game/Core/HeadlessSimulation.hpp"
+#include "Game/Generators/LevelBaker.hpp"
+#include "Game/Generators/GenerationRegression.hpp"
 #include <gl/Gl.h>
 
 
@@ -215,6 +218,26 @@ void Shutdown()
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// This is a windowed app, so text only reaches a command prompt if we attach to the one that launched us
+void PrintToLaunchingConsole(const std::string& text)
+{
+   DebuggerPrintf("%s\n", text.c_str());
+
+   if (AttachConsole(ATTACH_PARENT_PROCESS))
+   {
+      FILE* consoleOutput = nullptr;
+      if (fopen_s(&consoleOutput, "CONOUT$", "w") == 0)
+      {
+         fprintf(consoleOutput, "%s\n", text.c_str());
+         fclose(consoleOutput);
+      }
+
+      FreeConsole();
+   }
+}
+
+
 //-----------------------------------------------------------------------------------------------
 int WINAPI WinMain(HINSTANCE applicationInstanceHandle, HINSTANCE, LPSTR commandLineString, int)
 {
@@ -222,7 +245,30 @@ int WINAPI WinMain(HINSTANCE applicationInstanceHandle, HINSTANCE, LPSTR command
    // Or not. It's kinda useful and doesn't show up in release
    _CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
 
-   UNUSED(commandLineString);
+   // Baking levels, regression runs and headless simulations need no window
+   std::string bakeReport;
+   if (LevelBaker::RunFromCommandLine(commandLineString, &bakeReport))
+   {
+      PrintToLaunchingConsole(bakeReport);
+      return 0;
+   }
+
+   std::string regressionReport;
+   int regressionExitCode = 0;
+   if (GenerationRegression::RunFromCommandLine(commandLineString, &regressionReport, &regressionExitCode))
+   {
+      PrintToLaunchingConsole(regressionReport);
+      return regressionExitCode;
+   }
+
+   std::string simulationReport;
+   int simulationExitCode = 0;
+   if (HeadlessSimulation::RunFromCommandLine(commandLineString, &simulationReport, &simulationExitCode))
+   {
+      PrintToLaunchingConsole(simulationReport);
+      return simulationExitCode;
+   }
+
    Initialize(applicationInstanceHandle);
    while (!TheApp::IsQuitting())
    {
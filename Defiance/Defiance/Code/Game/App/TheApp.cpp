@@ -1,5 +1,7 @@
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Renderer/TheRenderer.hpp"
+#include "Engine/Renderer/Texture.hpp"
+#include "Engine/Renderer/BitmapFont.hpp"
 #include "Engine/Audio/TheAudioSystem.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Time/Time.hpp"
@@ -69,7 +71,12 @@ void TheApp::Shutdown()
    delete g_theDebugRenderer;
    delete g_theConsole;
    delete g_theRenderer;
+
+   // The game's textures and fonts come from the renderer, so they're freed here rather than by the game
+   g_theGame->CleanUpPlayingUI();
    delete g_theGame;
+   Texture::FreeAllTextures();
+   BitmapFont::FreeAllFonts();
 }
 
 
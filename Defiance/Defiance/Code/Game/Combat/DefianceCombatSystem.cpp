@@ -1,6 +1,6 @@
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/StringUtils.hpp"
-#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Game/Combat/DefianceCombatSystem.hpp"
 #include "Game/Entities/Agents/Agent.hpp"
 #include "Game/UI/GameMessageBox.hpp"
@@ -12,7 +12,8 @@
 //-----------------------------------------------------------------------------------------------
 STATIC void DefianceCombatSystem::PerformAttack(AttackData& attackData)
 {
-   bool didAttackLand = GetRandomTrueOrFalseWithProbability(attackData.percentChanceToHit);
+   RandomNumberGenerator* combatRandom = &g_theGame->GetGameContext()->combatRandom;
+   bool didAttackLand = combatRandom->GetTrueOrFalseWithProbability(attackData.percentChanceToHit);
 
    if (!didAttackLand)
    {
@@ -34,11 +35,11 @@ STATIC void DefianceCombatSystem::PerformAttack(AttackData& attackData)
    //else didAttackLand
    if (attackData.minDamage < 0)
    {
-      attackData.damageDealt = GetRandomIntBetweenInclusive(attackData.maxDamage, attackData.minDamage);
+      attackData.damageDealt = combatRandom->GetIntBetweenInclusive(attackData.maxDamage, attackData.minDamage);
    }
    else
    {
-      attackData.damageDealt = GetRandomIntBetweenInclusive(attackData.minDamage, attackData.maxDamage);
+      attackData.damageDealt = combatRandom->GetIntBetweenInclusive(attackData.minDamage, attackData.maxDamage);
       ApplyWeaponBonus(attackData);
       ApplyArmorBonus(attackData);
    }
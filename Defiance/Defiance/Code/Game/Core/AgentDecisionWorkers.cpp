@@ -0,0 +1,134 @@
+#include "Engine/Core/EngineCommon.hpp"
+#include "Game/Core/AgentDecisionWorkers.hpp"
+#include "Game/Entities/Agents/Agent.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC const int AgentDecisionWorkers::MIN_AGENTS_FOR_WORKERS = 32;
+STATIC const int AgentDecisionWorkers::AGENTS_PER_GRAB = 8;
+
+
+//-----------------------------------------------------------------------------------------------
+AgentDecisionWorkers::AgentDecisionWorkers(int numWorkerThreads)
+   : m_batchAgents(nullptr)
+   , m_batchStep(nullptr)
+   , m_nextAgentIndex(0)
+   , m_batchNumber(0)
+   , m_numBusyWorkers(0)
+   , m_isShuttingDown(false)
+{
+   for (int workerIndex = 0; workerIndex < numWorkerThreads; ++workerIndex)
+   {
+      m_workerThreads.push_back(std::thread(&AgentDecisionWorkers::RunWorker, this));
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+AgentDecisionWorkers::~AgentDecisionWorkers()
+{
+   {
+      std::lock_guard<std::mutex> lock(m_batchMutex);
+      m_isShuttingDown = true;
+   }
+
+   m_batchReadyCondition.notify_all();
+   for (std::thread& workerThread : m_workerThreads)
+   {
+      workerThread.join();
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns once every agent has run the step. Small batches aren't worth waking the workers for
+void AgentDecisionWorkers::RunForAll(const std::vector<Agent*>& agents, AgentDecisionStep step)
+{
+   if (m_workerThreads.empty() || (int)agents.size() < MIN_AGENTS_FOR_WORKERS)
+   {
+      for (Agent* agent : agents)
+      {
+         (agent->*step)();
+      }
+      return;
+   }
+
+   {
+      std::lock_guard<std::mutex> lock(m_batchMutex);
+      m_batchAgents = &agents;
+      m_batchStep = step;
+      m_nextAgentIndex = 0;
+      m_numBusyWorkers = (int)m_workerThreads.size();
+      ++m_batchNumber;
+   }
+   m_batchReadyCondition.notify_all();
+
+   RunUntilBatchIsEmpty();
+
+   std::unique_lock<std::mutex> lock(m_batchMutex);
+   while (m_numBusyWorkers > 0)
+   {
+      m_batchDoneCondition.wait(lock);
+   }
+
+   m_batchAgents = nullptr;
+   m_batchStep = nullptr;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void AgentDecisionWorkers::RunWorker()
+{
+   unsigned int lastBatchNumber = 0;
+
+   std::unique_lock<std::mutex> lock(m_batchMutex);
+   while (true)
+   {
+      while (!m_isShuttingDown && m_batchNumber == lastBatchNumber)
+      {
+         m_batchReadyCondition.wait(lock);
+      }
+
+      if (m_isShuttingDown)
+      {
+         break;
+      }
+
+      lastBatchNumber = m_batchNumber;
+      lock.unlock();
+
+      RunUntilBatchIsEmpty();
+
+      lock.lock();
+      --m_numBusyWorkers;
+      if (m_numBusyWorkers == 0)
+      {
+         m_batchDoneCondition.notify_all();
+      }
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Agents are handed out a few at a time so one slow pathfind doesn't hold up a whole share
+void AgentDecisionWorkers::RunUntilBatchIsEmpty()
+{
+   const std::vector<Agent*>& agents = *m_batchAgents;
+   AgentDecisionStep step = m_batchStep;
+   const int numAgents = (int)agents.size();
+
+   while (true)
+   {
+      int firstAgentIndex = m_nextAgentIndex.fetch_add(AGENTS_PER_GRAB);
+      if (firstAgentIndex >= numAgents)
+      {
+         break;
+      }
+
+      int endAgentIndex = (firstAgentIndex + AGENTS_PER_GRAB < numAgents) ? firstAgentIndex + AGENTS_PER_GRAB : numAgents;
+      for (int agentIndex = firstAgentIndex; agentIndex < endAgentIndex; ++agentIndex)
+      {
+         (agents[agentIndex]->*step)();
+      }
+   }
+}
\ No newline at end of file
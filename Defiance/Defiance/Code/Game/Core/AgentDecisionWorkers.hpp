@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+
+//-----------------------------------------------------------------------------------------------
+class Agent;
+
+
+//-----------------------------------------------------------------------------------------------
+typedef void (Agent::*AgentDecisionStep)();
+
+
+//-----------------------------------------------------------------------------------------------
+// Runs one decision step (Agent::Perceive, Agent::PlanChosenBehavior, ...) for a batch of agents on a fixed set of worker threads, with the calling
+// thread pitching in. Each step only writes to its own agent, so the batch can go in any order;
+// the caller applies the decisions afterwards, in turn order, on its own thread
+class AgentDecisionWorkers
+{
+public:
+   explicit AgentDecisionWorkers(int numWorkerThreads);
+   ~AgentDecisionWorkers();
+
+   void RunForAll(const std::vector<Agent*>& agents, AgentDecisionStep step);
+   int GetNumberOfWorkerThreads() const { return (int)m_workerThreads.size(); }
+
+   static const int MIN_AGENTS_FOR_WORKERS;
+   static const int AGENTS_PER_GRAB;
+
+private:
+   AgentDecisionWorkers(const AgentDecisionWorkers&);
+   AgentDecisionWorkers& operator=(const AgentDecisionWorkers&);
+
+   void RunWorker();
+   void RunUntilBatchIsEmpty();
+
+   std::vector<std::thread> m_workerThreads;
+   std::mutex m_batchMutex;
+   std::condition_variable m_batchReadyCondition;
+   std::condition_variable m_batchDoneCondition;
+   const std::vector<Agent*>* m_batchAgents;
+   AgentDecisionStep m_batchStep;
+   std::atomic<int> m_nextAgentIndex;
+   unsigned int m_batchNumber;
+   int m_numBusyWorkers;
+   bool m_isShuttingDown;
+};
\ No newline at end of file
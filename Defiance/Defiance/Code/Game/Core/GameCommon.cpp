@@ -1,10 +1,10 @@
-#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Game/Core/GameCommon.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
-TileDirection GetRandomTileDirection()
+TileDirection GetRandomTileDirection(RandomNumberGenerator* random)
 {
-   int directionIndex = GetRandomIntBetweenInclusive(0, 7);
+   int directionIndex = random->GetIntBetweenInclusive(0, 7);
    return (TileDirection)directionIndex;
 }
\ No newline at end of file
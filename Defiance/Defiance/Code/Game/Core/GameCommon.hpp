@@ -5,29 +5,48 @@
 
 //-----------------------------------------------------------------------------------------------
 class Vector2i;
+class Entity;
 class Agent;
 class Item;
 class Feature;
+class RandomNumberGenerator;
+
+
+//-----------------------------------------------------------------------------------------------
+// Refers to an entity without owning it. Resolves to nullptr through the EntityRegistry once the
+// entity is destroyed, since its slot's generation moves on
+struct EntityHandle
+{
+   EntityHandle() : index(0), generation(0) {}
+   EntityHandle(unsigned int handleIndex, unsigned int handleGeneration) : index(handleIndex), generation(handleGeneration) {}
+
+   bool IsNull() const { return (generation == 0); }
+   bool operator==(const EntityHandle& rhs) const { return (index == rhs.index && generation == rhs.generation); }
+   bool operator!=(const EntityHandle& rhs) const { return !(*this == rhs); }
+
+   unsigned int index;
+   unsigned int generation;
+};
 
 
 //-----------------------------------------------------------------------------------------------
 typedef Vector2i TileCoords;
 typedef unsigned int TileIndex;
-typedef std::multimap<float, Agent*> TurnOrderMap;
-typedef std::pair<float, Agent*> TurnOrderMapPair;
-typedef TurnOrderMap::iterator TurnOrderMapIter;
 typedef int EntityID;
 typedef int FactionID;
-typedef std::multimap<float, Agent*> DistanceToAgentMap;
-typedef std::pair<float, Agent*> DistanceToAgentPair;
+typedef std::multimap<float, EntityHandle> DistanceToAgentMap;
+typedef std::pair<float, EntityHandle> DistanceToAgentPair;
 typedef DistanceToAgentMap::iterator DistanceToAgentIter;
 typedef DistanceToAgentMap::const_iterator DistanceToAgentConstIter;
-typedef std::multimap<float, Item*> DistanceToItemMap;
-typedef std::pair<float, Item*> DistanceToItemPair;
+typedef std::multimap<float, EntityHandle> DistanceToItemMap;
+typedef std::pair<float, EntityHandle> DistanceToItemPair;
 typedef DistanceToItemMap::iterator DistanceToItemIter;
-typedef std::multimap<float, Feature*> DistanceToFeatureMap;
-typedef std::pair<float, Feature*> DistanceToFeaturePair;
+typedef std::multimap<float, EntityHandle> DistanceToFeatureMap;
+typedef std::pair<float, EntityHandle> DistanceToFeaturePair;
 typedef DistanceToFeatureMap::iterator DistanceToFeatureIter;
+typedef std::multimap<float, Entity*> DistanceToEntityMap;
+typedef std::pair<float, Entity*> DistanceToEntityPair;
+typedef DistanceToEntityMap::iterator DistanceToEntityIter;
 
 
 //-----------------------------------------------------------------------------------------------
@@ -48,4 +67,42 @@ const int NUM_CARDINAL_DIRECTIONS = NUM_TILE_DIRECTIONS / 2;
 
 
 //-----------------------------------------------------------------------------------------------
-TileDirection GetRandomTileDirection();
\ No newline at end of file
+// How much of an agent's turn gets simulated, from most to least. Set by distance to the player
+enum AgentDetailLevel
+{
+   FULL_DETAIL,
+   REDUCED_DETAIL,
+   DORMANT_DETAIL,
+   NUM_AGENT_DETAIL_LEVELS,
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// How tiles are ordered inside each map chunk. TILED_LAYOUT stores 8x8 blocks contiguously (Morton order inside
+// each block) so 2D neighborhoods share cache lines. TileIndex is row-major in either layout
+enum TileIndexLayout
+{
+   INVALID_TILE_INDEX_LAYOUT = -1,
+   ROW_MAJOR_LAYOUT,
+   TILED_LAYOUT,
+   NUM_TILE_INDEX_LAYOUTS,
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Each stream is seeded from the game seed and its ID, so draws in one system never shift another
+enum RandomStreamID
+{
+   INVALID_RANDOM_STREAM = -1,
+   GENERATION_RANDOM_STREAM,
+   AI_RANDOM_STREAM,
+   COMBAT_RANDOM_STREAM,
+   SPAWN_RANDOM_STREAM,
+   STEP_COUNT_RANDOM_STREAM,
+   AREA_GENERATION_RANDOM_STREAM, // one per area stage, with the stage index in the high bits
+   NUM_RANDOM_STREAMS,
+};
+
+
+//-----------------------------------------------------------------------------------------------
+TileDirection GetRandomTileDirection(RandomNumberGenerator* random);
\ No newline at end of file
@@ -1,29 +1,30 @@
 #include "Game/Core/GameContext.hpp"
-#include "Game/Generators/Generator.hpp"
+#include "Game/Generators/MapGenerationJob.hpp"
 #include "Game/Map/Map.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
 GameContext::GameContext()
    : activeEnvironment(nullptr)
-   , activeGenerator(nullptr)
+   , activeGenerationJob(nullptr)
    , activeMap(nullptr)
    , activePathfinder(nullptr)
    , activePlayer(nullptr)
-   , activeGeneratorStep(0)
    , isGenerationAutomatic(false)
-   , isEnvironmentFinished(false)
    , numberOfPlayerStepsTaken(0)
    , numberOfEnemiesSlainByPlayer(0)
-{}
+   , gameSeed(0)
+{
+   SeedRandomStreams(gameSeed);
+}
 
 
 //-----------------------------------------------------------------------------------------------
 GameContext::~GameContext()
 {
-   if (activeGenerator != nullptr)
+   if (activeGenerationJob != nullptr)
    {
-      delete activeGenerator;
+      delete activeGenerationJob;
    }
 
    CleanUpEntities();
@@ -48,6 +49,9 @@ void GameContext::UpdateEntities()
 //-----------------------------------------------------------------------------------------------
 void GameContext::CleanUpEntities()
 {
+   // Agents are about to be deleted, so nothing may still have a turn
+   activeAgents.Clear();
+
    for (Entity* entity : activeEntities)
    {
       if (entity == nullptr)
@@ -62,4 +66,14 @@ void GameContext::CleanUpEntities()
    activeEntities.erase(activeEntities.begin(), activeEntities.end());
 
    activePlayer = nullptr;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void GameContext::SeedRandomStreams(unsigned int seed)
+{
+   gameSeed = seed;
+   aiRandom.Seed(seed, AI_RANDOM_STREAM);
+   combatRandom.Seed(seed, COMBAT_RANDOM_STREAM);
+   spawnRandom.Seed(seed, SPAWN_RANDOM_STREAM);
 }
\ No newline at end of file
@@ -2,12 +2,14 @@
 
 #include <vector>
 #include <set>
+#include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Game/Entities/Entity.hpp"
+#include "Game/Core/TurnScheduler.hpp"
 //#include <stack>
 
 
 //-----------------------------------------------------------------------------------------------
-class Generator;
+class MapGenerationJob;
 class Map;
 class EnvironmentBlueprint;
 class PathfinderAStar;
@@ -22,18 +24,23 @@ struct GameContext
 
    void UpdateEntities();
    void CleanUpEntities();
+   void SeedRandomStreams(unsigned int seed);
 
    EnvironmentBlueprint* activeEnvironment;
-   Generator* activeGenerator;
+   MapGenerationJob* activeGenerationJob;
    Map* activeMap;
    PathfinderAStar* activePathfinder;
    Player* activePlayer;
-   TurnOrderMap activeAgents;
+   TurnScheduler activeAgents;
    std::vector<Entity*> activeEntities;
-   int activeGeneratorStep;
    bool isGenerationAutomatic;
-   bool isEnvironmentFinished;
    int numberOfPlayerStepsTaken;
    int numberOfEnemiesSlainByPlayer;
+
+   // The generation stream lives on the MapGenerationJob, since jobs can run off the main thread
+   unsigned int gameSeed;
+   RandomNumberGenerator aiRandom;
+   RandomNumberGenerator combatRandom;
+   RandomNumberGenerator spawnRandom;
    // std::stack<GameState> gameStateStack;
 };
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include <stdlib.h>
+#include <vector>
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Tokenizer.hpp"
+#include "Engine/Profile/MemoryAnalytics.hpp"
+#include "Engine/Time/Time.hpp"
+#include "Game/Core/HeadlessSimulation.hpp"
+#include "Game/Core/TheGame.hpp"
+#include "Game/Core/GameContext.hpp"
+#include "Game/Environments/EnvironmentBlueprint.hpp"
+#include "Game/Generators/MapGenerationJob.hpp"
+#include "Game/Generators/LevelBaker.hpp"
+#include "Game/IO/LevelLibrary.hpp"
+#include "Game/Map/Map.hpp"
+#include "Game/Entities/Agents/NPCs/NPC.hpp"
+#include "Game/Entities/Agents/NPCs/NPCFactory.hpp"
+#include "Game/Entities/Items/Item.hpp"
+#include "Game/Entities/Items/ItemFactory.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC const int HeadlessSimulation::DEFAULT_NUM_NPCS = 64;
+STATIC const int HeadlessSimulation::DEFAULT_NUM_AGENT_TURNS = 10000;
+STATIC const int HeadlessSimulation::NUM_ITEMS_TO_SPAWN = 20;
+
+
+//-----------------------------------------------------------------------------------------------
+// Runs the same gather, decide, act and clean up phases as TheGame::UpdatePlaying, timing each.
+// The clock jumps straight to the next scheduled turn rather than ticking towards it, so every
+// step has agents to run. Stops after numAgentTurns agent turns, or once every NPC is dead
+STATIC void HeadlessSimulation::Simulate(EnvironmentBlueprint* environment, int numNPCs, int numAgentTurns, unsigned int seed, HeadlessSimulationReport* outReport)
+{
+   GameContext* context = g_theGame->GetGameContext();
+   context->activeEnvironment = environment;
+   context->SeedRandomStreams(seed);
+
+   double startTime = Time::GetCurrentTimeSeconds();
+   LoadOrGenerateMap(environment, seed, outReport);
+   SpawnAgentsAndItems(numNPCs, outReport);
+   outReport->setupSeconds = Time::GetCurrentTimeSeconds() - startTime;
+
+   TurnScheduler& turnScheduler = context->activeAgents;
+   while (outReport->numAgentTurns < numAgentTurns && !turnScheduler.IsEmpty())
+   {
+      double gatherStartTime = Time::GetCurrentTimeSeconds();
+      g_theGame->AdvanceSimulationClockToNextTurn();
+      g_theGame->GatherDueAgents();
+
+      double decideStartTime = Time::GetCurrentTimeSeconds();
+      g_theGame->DecideDueAgents();
+
+      double actStartTime = Time::GetCurrentTimeSeconds();
+      outReport->numAgentTurns += g_theGame->ActDueAgents();
+
+      double cleanUpStartTime = Time::GetCurrentTimeSeconds();
+      g_theGame->CleanUpDeadEntities();
+
+      double stepEndTime = Time::GetCurrentTimeSeconds();
+      outReport->gatherSeconds += decideStartTime - gatherStartTime;
+      outReport->decideSeconds += actStartTime - decideStartTime;
+      outReport->actSeconds += cleanUpStartTime - actStartTime;
+      outReport->cleanUpSeconds += stepEndTime - cleanUpStartTime;
+      ++outReport->numSchedulerSteps;
+   }
+
+   outReport->numNPCsRemaining = turnScheduler.GetNumberOfScheduledAgents();
+   outReport->peakBytesAllocated = g_peakAllocated.load();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC bool HeadlessSimulation::RunFromCommandLine(const std::string& commandLine, std::string* outReport, int* outExitCode)
+{
+   std::vector<std::string> arguments;
+   Tokenizer argumentTokens(commandLine, " \t");
+   while (!argumentTokens.IsFinished())
+   {
+      std::string argument = argumentTokens.GetNextToken();
+      if (!argument.empty())
+      {
+         arguments.push_back(argument);
+      }
+   }
+
+   if (arguments.empty() || arguments[0] != "-simulate")
+   {
+      return false;
+   }
+
+   *outExitCode = 1;
+   if (arguments.size() < 2)
+   {
+      *outReport = "Usage: -simulate <environment> [npcs] [agent turns] [seed]";
+      return true;
+   }
+
+   const std::string& environmentName = arguments[1];
+   int numNPCs = (arguments.size() > 2) ? atoi(arguments[2].c_str()) : DEFAULT_NUM_NPCS;
+   int numAgentTurns = (arguments.size() > 3) ? atoi(arguments[3].c_str()) : DEFAULT_NUM_AGENT_TURNS;
+   unsigned int seed = (arguments.size() > 4) ? (unsigned int)strtoul(arguments[4].c_str(), nullptr, 10) : 1;
+
+   g_theGame = new TheGame;
+   g_theGame->InitHeadless();
+
+   EnvironmentBlueprintMap* environments = EnvironmentBlueprint::s_environmentBlueprintMap;
+   if (environments == nullptr || environments->find(environmentName) == environments->end())
+   {
+      *outReport = Stringf("Unknown environment %s", environmentName.c_str());
+   }
+   else if (environments->find(environmentName)->second->IsGeneratedByRegion())
+   {
+      // Region maps generate as agents wander into them, which needs chunk streaming
+      *outReport = Stringf("%s is generated by region and can't be simulated headless", environmentName.c_str());
+   }
+   else
+   {
+      HeadlessSimulationReport report;
+      Simulate(environments->find(environmentName)->second, numNPCs, numAgentTurns, seed, &report);
+
+      *outReport = Stringf("Simulated %d agent turns in %d scheduler steps of %s (%s map, seed %u) with %d NPCs, %d left alive\n",
+         report.numAgentTurns, report.numSchedulerSteps, environmentName.c_str(), report.mapSource.c_str(), seed, report.numNPCsSpawned, report.numNPCsRemaining);
+      *outReport += Stringf("  %.1f agent turns/sec, %.1f scheduler steps/sec over %.3fs (setup %.3fs)\n",
+         report.GetAgentTurnsPerSecond(), report.GetSchedulerStepsPerSecond(), report.GetSimulationSeconds(), report.setupSeconds);
+      *outReport += Stringf("  gather %.3fs, decide %.3fs, act %.3fs, clean up %.3fs\n",
+         report.gatherSeconds, report.decideSeconds, report.actSeconds, report.cleanUpSeconds);
+      *outReport += Stringf("  peak memory %.2f MB", (double)report.peakBytesAllocated / (1024.0 * 1024.0));
+      *outExitCode = 0;
+   }
+
+   // Frees the context and every blueprint
+   delete g_theGame;
+   g_theGame = nullptr;
+   return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC void HeadlessSimulation::LoadOrGenerateMap(EnvironmentBlueprint* environment, unsigned int seed, HeadlessSimulationReport* outReport)
+{
+   GameContext* context = g_theGame->GetGameContext();
+
+   // A level that fails to load is generated instead, just like a missing one
+   LevelLibrary library;
+   std::string libraryPath = Stringf("%s/%s%s", LevelBaker::LEVEL_LIBRARY_DIRECTORY, environment->GetName().c_str(), LevelBaker::LEVEL_LIBRARY_EXTENSION);
+   if (library.Open(libraryPath) && library.GetDimensions() == environment->GetSize() && library.HasLevel(seed))
+   {
+      context->activeMap = library.LoadLevel(seed, &context->activeEntities);
+      if (context->activeMap != nullptr)
+      {
+         outReport->mapSource = "baked";
+         return;
+      }
+   }
+
+   MapGenerationJob generationJob(environment, seed);
+   generationJob.RunToCompletion();
+   context->activeMap = generationJob.TakeMap(&context->activeEntities);
+   outReport->mapSource = "generated";
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// NPCs cycle through every blueprint so each faction is represented
+STATIC void HeadlessSimulation::SpawnAgentsAndItems(int numNPCs, HeadlessSimulationReport* outReport)
+{
+   GameContext* context = g_theGame->GetGameContext();
+   Map* activeMap = context->activeMap;
+
+   NPCFactoryMap::iterator npcIter = NPCFactory::s_factoryMap->begin();
+   for (int npcIndex = 0; npcIndex < numNPCs && !NPCFactory::s_factoryMap->empty(); ++npcIndex)
+   {
+      if (activeMap->GetNumberOfOpenTiles() == 0)
+      {
+         break;
+      }
+
+      NPC* npc = npcIter->second->CreateNPC(&context->spawnRandom);
+      TileCoords spawnCoords = activeMap->GetRandomOpenCoords(&context->spawnRandom);
+      npc->AddToMap(activeMap, spawnCoords);
+      context->activeAgents.Schedule(npc, .1f);
+      context->activeEntities.push_back(npc);
+      ++outReport->numNPCsSpawned;
+
+      ++npcIter;
+      if (npcIter == NPCFactory::s_factoryMap->end())
+      {
+         npcIter = NPCFactory::s_factoryMap->begin();
+      }
+   }
+
+   for (int itemIndex = 0; itemIndex < NUM_ITEMS_TO_SPAWN; ++itemIndex)
+   {
+      if (activeMap->GetNumberOfOpenTiles() == 0)
+      {
+         break;
+      }
+
+      Item* item = ItemFactory::CreateRandomItem(&context->spawnRandom);
+      TileCoords spawnCoords = activeMap->GetRandomOpenCoords(&context->spawnRandom);
+      item->AddToMap(activeMap, spawnCoords);
+      context->activeEntities.push_back(item);
+   }
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+
+
+//-----------------------------------------------------------------------------------------------
+class EnvironmentBlueprint;
+
+
+//-----------------------------------------------------------------------------------------------
+struct HeadlessSimulationReport
+{
+   HeadlessSimulationReport() : numNPCsSpawned(0), numNPCsRemaining(0), numAgentTurns(0), numSchedulerSteps(0), setupSeconds(0.0),
+      gatherSeconds(0.0), decideSeconds(0.0), actSeconds(0.0), cleanUpSeconds(0.0), peakBytesAllocated(0) {}
+   double GetSimulationSeconds() const { return gatherSeconds + decideSeconds + actSeconds + cleanUpSeconds; }
+   double GetAgentTurnsPerSecond() const { return (GetSimulationSeconds() > 0.0) ? ((double)numAgentTurns / GetSimulationSeconds()) : 0.0; }
+   double GetSchedulerStepsPerSecond() const { return (GetSimulationSeconds() > 0.0) ? ((double)numSchedulerSteps / GetSimulationSeconds()) : 0.0; }
+
+   std::string mapSource;
+   int numNPCsSpawned;
+   int numNPCsRemaining;
+   int numAgentTurns;      // Turns agents actually took
+   int numSchedulerSteps;  // Distinct turn times the clock stopped at
+   double setupSeconds;
+   double gatherSeconds;
+   double decideSeconds;
+   double actSeconds;
+   double cleanUpSeconds;
+   size_t peakBytesAllocated;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Fast-forwards the turn loop with no window, input or audio. The map comes from the environment's
+// baked library when it has the seed, otherwise it is generated. Only NPCs are spawned, so nothing
+// waits on input and every turn runs back to back
+class HeadlessSimulation
+{
+public:
+   static void Simulate(EnvironmentBlueprint* environment, int numNPCs, int numAgentTurns, unsigned int seed, HeadlessSimulationReport* outReport);
+
+   // -simulate <environment> [npcs] [agent turns] [seed]. Returns false if the command line isn't a simulation
+   static bool RunFromCommandLine(const std::string& commandLine, std::string* outReport, int* outExitCode);
+
+   static const int DEFAULT_NUM_NPCS;
+   static const int DEFAULT_NUM_AGENT_TURNS;
+   static const int NUM_ITEMS_TO_SPAWN;
+
+private:
+   static void LoadOrGenerateMap(EnvironmentBlueprint* environment, unsigned int seed, HeadlessSimulationReport* outReport);
+   static void SpawnAgentsAndItems(int numNPCs, HeadlessSimulationReport* outReport);
+};
\ No newline at end of file
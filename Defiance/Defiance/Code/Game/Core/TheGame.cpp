@@ -1,3 +1,4 @@
+#include <stdlib.h>
 #include "Engine/Renderer/TheRenderer.hpp"
 #include "Engine/Renderer/BitmapFont.hpp"
 #include "Engine/Input/InputSystem.hpp"
@@ -10,16 +11,23 @@
 #include "Game/App/TheApp.hpp"
 #include "Game/Core/TheGame.hpp"
 #include "Game/Core/GameContext.hpp"
+#include "Game/Core/AgentDecisionWorkers.hpp"
 #include "Game/IO/SaveGame.hpp"
 #include "Game/IO/LoadGame.hpp"
+#include "Game/IO/LevelLibrary.hpp"
 #include "Game/Map/Map.hpp"
 #include "Game/Generators/Generator.hpp"
+#include "Game/Generators/MapGenerationJob.hpp"
+#include "Game/Generators/MapGenerationService.hpp"
+#include "Game/Generators/LevelBaker.hpp"
+#include "Game/Generators/GenerationRegression.hpp"
 #include "Game/Environments/EnvironmentBlueprint.hpp"
 #include "Game/Entities/Agents/NPCs/NPCFactory.hpp"
 #include "Game/Pathfinding/PathfinderAStar.hpp"
 #include "Game/Entities/Agents/Player.hpp"
 #include "Game/Entities/Agents/NPCs/NPC.hpp"
 #include "Game/Entities/Agents/Behaviors/Behavior.hpp"
+#include "Game/Entities/Agents/Behaviors/UtilityScoringBatch.hpp"
 #include "Game/Entities/Agents/Factions/Faction.hpp"
 #include "Game/Entities/Items/ItemFactory.hpp"
 #include "Game/Entities/Features/FeatureFactory.hpp"
@@ -29,44 +37,8 @@
 
 //-----------------------------------------------------------------------------------------------
 STATIC bool TheGame::s_isDebug = false;
-
-
-//-----------------------------------------------------------------------------------------------
-extern TheGame* g_theGame = nullptr;
-
-
-//-----------------------------------------------------------------------------------------------
-TheGame::TheGame()
-   : m_secondsSinceLastFrame(0.f)
-   , m_gameContext(nullptr)
-   , m_testCast()
-   , m_showTestCast(false)
-   , m_simulationClock(0.f)
-   , m_simulationDelta(0.1f)
-   , m_isGameOver(false)
-   , m_isGodMode(false)
-   , m_doesSaveExist(false)
-   , m_didJustSave(false)
-{
-   m_gameStateStack.push(STARTING_STATE);
-}
-
-
-//-----------------------------------------------------------------------------------------------
-TheGame::~TheGame()
-{
-   CleanUpPlayingUI();
-   Texture::FreeAllTextures();
-   BitmapFont::FreeAllFonts();
-   GeneratorRegistration::FreeAllGeneratorRegistrations();
-   EnvironmentBlueprint::CleanUpEnvironmentBlueprints();
-   BehaviorRegistration::FreeAllBehaviorRegistrations();
-   NPCFactory::FreeAllNPCBlueprints();
-   Faction::FreeAllFactions();
-   ItemFactory::FreeAllItemBlueprints();
-   FeatureFactory::FreeAllFeatureBlueprints();
-   delete m_gameContext;
-}
+STATIC const char* TheGame::MAP_CHUNK_CACHE_DIRECTORY = "Data/Saves";
+STATIC const int TheGame::MIN_MAP_CHUNKS_FOR_STREAMING = 16;
 
 
 //-----------------------------------------------------------------------------------------------
@@ -78,12 +50,18 @@ void TheGame::Init()
    BitmapFont::CreateOrGetFont("CourierNew");
 
    m_gameContext = new GameContext;
+   LoadAllBlueprints();
+
+   m_mapGenerationService = new MapGenerationService(m_seedRandom.GetNextUint());
+   if (!EnvironmentBlueprint::s_environmentBlueprintMap->empty())
+   {
+      m_mapGenerationService->SetLikelyEnvironment(EnvironmentBlueprint::s_environmentBlueprintMap->begin()->second);
+   }
 
-   EnvironmentBlueprint::LoadEnvironmentBlueprints();
-   Faction::LoadAllFactions();
-   NPCFactory::LoadAllNPCBlueprints();
-   ItemFactory::LoadAllItemBlueprints();
-   FeatureFactory::LoadAllFeatureBlueprints();
+   // The main thread decides alongside the workers
+   int numHardwareThreads = (int)std::thread::hardware_concurrency();
+   m_agentDecisionWorkers = new AgentDecisionWorkers((numHardwareThreads > 1) ? numHardwareThreads - 1 : 0);
+   m_utilityScoringBatch = new UtilityScoringBatch;
 
    CheckForSaveGame();
    m_gameStateStack.push(MAIN_MENU_STATE);
@@ -95,6 +73,11 @@ void TheGame::RegisterConsoleCommands()
 {
    g_theConsole->RegisterCommand("debug", "toggles the current debug state", ToggleDebug);
    g_theConsole->RegisterCommand("god", "toggles God mode for the player", ToggleGodMode);
+   g_theConsole->RegisterCommand("entities", "lists entities within [radius] of the player", ListNearbyEntities);
+   g_theConsole->RegisterCommand("layoutbench", "times generation, FOV and pathfinding for each tile layout [width] [height]", RunTileLayoutBenchmark);
+   g_theConsole->RegisterCommand("genregress", "checks every generator's output and step times against the recorded baseline", RunGenerationRegression);
+   g_theConsole->RegisterCommand("chunks", "lists how many map chunks are resident in memory", ListMapChunks);
+   g_theConsole->RegisterCommand("seed", "prints the game seed, or fixes the seed for new games [seed] (0 for random)", SetGameSeed);
 }
 
 
@@ -130,6 +113,7 @@ void TheGame::Update()
   m_secondsSinceLastFrame = Time::GetDeltaSeconds();
 
    HandleInput();
+   m_mapGenerationService->Update();
 
    if (m_gameStateStack.top() == GENERATION_STATE)
    {
@@ -151,65 +135,24 @@ void TheGame::UpdateGeneration()
       return;
    }
 
-
-   while (TryGenerationStep());
-
-   delete m_gameContext->activeGenerator;
-   m_gameContext->activeGenerator = nullptr;
-   m_gameContext->activeGeneratorStep = 0;
-   m_gameContext->isEnvironmentFinished = false;
-
-   Generator::FinalizeMap(m_gameContext->activeMap);
-   AddPlayerAtRandomLocation();
-   AddRandomNPCs();
-   AddRandomItems();
-   InitPlayingUI();
-
-   m_gameStateStack.push(PLAYING_STATE);
+   m_gameContext->activeGenerationJob->RunToCompletion();
+   StartPlayingGeneratedMap();
 }
 
 
 //-----------------------------------------------------------------------------------------------
 void TheGame::UpdatePlaying()
 {
-   bool isSimulating = true;
-   bool advanceTime = true;
-
-   while (isSimulating)
-   {
-      TurnOrderMapIter agentIter = m_gameContext->activeAgents.begin();
-      Agent* agent = agentIter->second;
-
-      if (agentIter->first > m_simulationClock)
-      {
-         break;
-      }
-
-      if (!agent->IsReadyToUpdate())
-      {
-         advanceTime = false;
-         break;
-      }
-
-      m_gameContext->activeAgents.erase(agentIter);
-
-      float duration = 0.f;
-      if (agent->IsAlive())
-      {
-         duration = agent->Update();
-      }
-      
-      if (agent->IsAlive())
-      {
-         m_gameContext->activeAgents.insert(TurnOrderMapPair(m_simulationClock + duration, agent));
-      }
-   }
+   bool advanceTime = GatherDueAgents();
+   DecideDueAgents();
+   ActDueAgents();
 
    if (advanceTime)
    {
-      m_simulationClock += m_simulationDelta;
+      AdvanceSimulationClock();
    }
    CleanUpDeadEntities();
+   UpdateMapChunkResidency();
 
    if (m_showTestCast)
    {
@@ -298,109 +241,79 @@ void TheGame::HandleInputMapSelect()
       m_gameContext->isGenerationAutomatic = !m_gameContext->isGenerationAutomatic;
    }
 
-   if (g_theInputSystem->WasKeyJustPressed('1'))
+   // Number keys pick environments in the order they are listed
+   EnvironmentBlueprintMap::iterator environIter = EnvironmentBlueprint::s_environmentBlueprintMap->begin();
+   for (char environmentKey = '1'; environmentKey <= '9' && environIter != EnvironmentBlueprint::s_environmentBlueprintMap->end(); ++environmentKey, ++environIter)
    {
-      EnvironmentBlueprint* activeEnvironment = EnvironmentBlueprint::s_environmentBlueprintMap->begin()->second;
-
-      EnvironmentGenerationProcess* genProc = nullptr;
-      genProc = activeEnvironment->GetGenerationProcesses()[0];
-      Generator* activeGenerator = GeneratorRegistration::CreateGeneratorByName(genProc->generatorName);
-      Map* activeMap = activeGenerator->GenerateEmptyMap(activeEnvironment->GetSize(), activeEnvironment->GetName());
-      activeGenerator->InitializeMap(activeMap);
-
-      m_gameContext->activeEnvironment = activeEnvironment;
-      m_gameContext->activeGenerator = activeGenerator;
-      m_gameContext->activeMap = activeMap;
-
-      m_gameStateStack.push(GENERATION_STATE);
+      if (g_theInputSystem->WasKeyJustPressed(environmentKey))
+      {
+         BeginEnvironment(environIter->second);
+         return;
+      }
    }
 
-   if (g_theInputSystem->WasKeyJustPressed('2'))
+   if (g_theInputSystem->WasKeyJustPressed(VK_ESCAPE))
    {
-      EnvironmentBlueprintMap::iterator environIter = EnvironmentBlueprint::s_environmentBlueprintMap->begin();
-      ++environIter;
-      EnvironmentBlueprint* activeEnvironment = environIter->second;
-
-      EnvironmentGenerationProcess* genProc = nullptr;
-      genProc = activeEnvironment->GetGenerationProcesses()[0];
-      Generator* activeGenerator = GeneratorRegistration::CreateGeneratorByName(genProc->generatorName);
-      Map* activeMap = activeGenerator->GenerateEmptyMap(activeEnvironment->GetSize(), activeEnvironment->GetName());
-      activeGenerator->InitializeMap(activeMap);
-
-      m_gameContext->activeEnvironment = activeEnvironment;
-      m_gameContext->activeGenerator = activeGenerator;
-      m_gameContext->activeMap = activeMap;
-
-      m_gameStateStack.push(GENERATION_STATE);
+      m_gameStateStack.pop();
    }
+}
 
-   if (g_theInputSystem->WasKeyJustPressed('3'))
-   {
-      EnvironmentBlueprintMap::iterator environIter = EnvironmentBlueprint::s_environmentBlueprintMap->begin();
-      ++environIter;
-      ++environIter;
-      EnvironmentBlueprint* activeEnvironment = environIter->second;
-
-      EnvironmentGenerationProcess* genProc = nullptr;
-      genProc = activeEnvironment->GetGenerationProcesses()[0];
-      Generator* activeGenerator = GeneratorRegistration::CreateGeneratorByName(genProc->generatorName);
-      Map* activeMap = activeGenerator->GenerateEmptyMap(activeEnvironment->GetSize(), activeEnvironment->GetName());
-      activeGenerator->InitializeMap(activeMap);
 
-      m_gameContext->activeEnvironment = activeEnvironment;
-      m_gameContext->activeGenerator = activeGenerator;
-      m_gameContext->activeMap = activeMap;
+//-----------------------------------------------------------------------------------------------
+void TheGame::BeginEnvironment(EnvironmentBlueprint* environment)
+{
+   m_gameContext->activeEnvironment = environment;
 
-      m_gameStateStack.push(GENERATION_STATE);
-   }
+   // Random seeds stay positive so the seed command can type them back in
+   unsigned int gameSeed = (m_fixedGameSeed != 0) ? m_fixedGameSeed : (unsigned int)m_seedRandom.GetIntBetweenInclusive(1, 0x7FFFFFFF);
+   m_gameContext->SeedRandomStreams(gameSeed);
 
-   if (g_theInputSystem->WasKeyJustPressed('4'))
+   if (environment->IsGeneratedByRegion())
    {
-      EnvironmentBlueprintMap::iterator environIter = EnvironmentBlueprint::s_environmentBlueprintMap->begin();
-      ++environIter;
-      ++environIter;
-      ++environIter;
-      EnvironmentBlueprint* activeEnvironment = environIter->second;
+      EnvironmentGenerationProcess* genProc = environment->GetGenerationProcesses()[0];
+      Generator* regionGenerator = GeneratorRegistration::CreateGeneratorByName(genProc->generatorName);
 
-      EnvironmentGenerationProcess* genProc = nullptr;
-      genProc = activeEnvironment->GetGenerationProcesses()[0];
-      Generator* activeGenerator = GeneratorRegistration::CreateGeneratorByName(genProc->generatorName);
-      Map* activeMap = activeGenerator->GenerateEmptyMap(activeEnvironment->GetSize(), activeEnvironment->GetName());
-      activeGenerator->InitializeMap(activeMap);
+      if (regionGenerator->CanGenerateRegions())
+      {
+         unsigned int worldSeed = (environment->GetWorldSeed() != 0) ? (unsigned int)environment->GetWorldSeed() : gameSeed;
 
-      m_gameContext->activeEnvironment = activeEnvironment;
-      m_gameContext->activeGenerator = activeGenerator;
-      m_gameContext->activeMap = activeMap;
+         // The map owns the generator from here on
+         m_gameContext->activeMap = new Map(environment->GetSize(), environment->GetName(), environment->GetTileIndexLayout(), regionGenerator, worldSeed);
+         StartPlayingRegionMap();
+         return;
+      }
 
-      m_gameStateStack.push(GENERATION_STATE);
+      delete regionGenerator;
    }
 
-   if (g_theInputSystem->WasKeyJustPressed('5'))
+   // A baked level is just a finished map, so it skips generation entirely
+   if (m_gameContext->isGenerationAutomatic && TryStartPlayingBakedLevel(environment))
    {
-      EnvironmentBlueprintMap::iterator environIter = EnvironmentBlueprint::s_environmentBlueprintMap->begin();
-      ++environIter;
-      ++environIter;
-      ++environIter;
-      ++environIter;
-      EnvironmentBlueprint* activeEnvironment = environIter->second;
-
-      EnvironmentGenerationProcess* genProc = nullptr;
-      genProc = activeEnvironment->GetGenerationProcesses()[0];
-      Generator* activeGenerator = GeneratorRegistration::CreateGeneratorByName(genProc->generatorName);
-      Map* activeMap = activeGenerator->GenerateEmptyMap(activeEnvironment->GetSize(), activeEnvironment->GetName());
-      activeGenerator->InitializeMap(activeMap);
-
-      m_gameContext->activeEnvironment = activeEnvironment;
-      m_gameContext->activeGenerator = activeGenerator;
-      m_gameContext->activeMap = activeMap;
-
-      m_gameStateStack.push(GENERATION_STATE);
+      return;
    }
 
-   if (g_theInputSystem->WasKeyJustPressed(VK_ESCAPE))
+   // Whatever gets played now is likely to be played again, so keep a spare map of it ready
+   m_mapGenerationService->SetLikelyEnvironment(environment);
+
+   // Step by step generation always starts fresh so it can be watched. A fixed seed has to be
+   // generated from that seed, not whatever the pregenerated map used
+   if (m_gameContext->isGenerationAutomatic && m_fixedGameSeed == 0)
    {
-      m_gameStateStack.pop();
+      MapGenerationJob* readyJob = m_mapGenerationService->TakeReadyJob(environment);
+      if (readyJob != nullptr)
+      {
+         m_gameContext->SeedRandomStreams(readyJob->GetGameSeed());
+         m_gameContext->activeGenerationJob = readyJob;
+         StartPlayingGeneratedMap();
+         return;
+      }
    }
+
+   MapGenerationJob* generationJob = new MapGenerationJob(environment, gameSeed);
+   generationJob->Begin();
+   m_gameContext->activeGenerationJob = generationJob;
+
+   m_gameStateStack.push(GENERATION_STATE);
 }
 
 
@@ -409,33 +322,18 @@ void TheGame::HandleInputGeneration()
 {
    if (g_theInputSystem->WasKeyJustPressed(VK_SPACE))
    {
-      TryGenerationStep();
+      m_gameContext->activeGenerationJob->TryGenerationStep();
    }
 
    if (g_theInputSystem->WasKeyJustPressed(VK_RETURN))
    {
-      delete m_gameContext->activeGenerator;
-      m_gameContext->activeGenerator = nullptr;
-      m_gameContext->activeGeneratorStep = 0;
-      m_gameContext->isEnvironmentFinished = false;
-
-      Generator::FinalizeMap(m_gameContext->activeMap);
-      AddPlayerAtRandomLocation();
-      AddRandomNPCs();
-      AddRandomItems();
-      InitPlayingUI();
-
-      m_gameStateStack.push(PLAYING_STATE);
+      StartPlayingGeneratedMap();
    }
 
    if (g_theInputSystem->WasKeyJustPressed(VK_ESCAPE))
    {
-      delete m_gameContext->activeMap;
-      m_gameContext->activeMap = nullptr;
-      delete m_gameContext->activeGenerator;
-      m_gameContext->activeGenerator = nullptr;
-      m_gameContext->activeGeneratorStep = 0;
-      m_gameContext->isEnvironmentFinished = false;
+      delete m_gameContext->activeGenerationJob;
+      m_gameContext->activeGenerationJob = nullptr;
 
       m_gameStateStack.pop();
    }
@@ -512,7 +410,7 @@ void TheGame::HandleInputPlaying()
    if (g_theInputSystem->WasKeyJustPressed('R'))
    {
       m_showTestCast = true;
-      m_testTarget = Map::GetTileCenterFromTileCoords(m_gameContext->activeMap->GetRandomOpenCoords());
+      m_testTarget = Map::GetTileCenterFromTileCoords(m_gameContext->activeMap->GetRandomOpenCoords(&m_gameContext->spawnRandom));
    }
 
    if (m_gameContext->activePlayer != nullptr)
@@ -648,7 +546,20 @@ void TheGame::RenderMapSelect() const
    int currentEnvironmentIndex = 0;
    for (environmentIter; environmentIter != EnvironmentBlueprint::s_environmentBlueprintMap->end(); ++environmentIter)
    {
-      g_theRenderer->DrawText2D(Vector2f(200.f, 600.f - (45.f * currentEnvironmentIndex)), Stringf("%d - %s", currentEnvironmentIndex + 1, environmentIter->first.c_str()), Rgba::WHITE, 20.f, font);
+      Vector2f environmentTextPosition(200.f, 600.f - (45.f * currentEnvironmentIndex));
+      g_theRenderer->DrawText2D(environmentTextPosition, Stringf("%d - %s", currentEnvironmentIndex + 1, environmentIter->first.c_str()), Rgba::WHITE, 20.f, font);
+
+      // Only automatic generation plays pregenerated maps
+      float pregenerationProgress = m_mapGenerationService->GetProgressForEnvironment(environmentIter->second);
+      if (pregenerationProgress >= 1.f)
+      {
+         g_theRenderer->DrawText2D(environmentTextPosition + Vector2f(400.f, 0.f), "Ready", Rgba(120, 120, 120, 255), 20.f, font);
+      }
+      else if (environmentIter->second == m_mapGenerationService->GetLikelyEnvironment() && m_mapGenerationService->GetNumberOfQueuedJobs() > 0)
+      {
+         g_theRenderer->DrawText2D(environmentTextPosition + Vector2f(400.f, 0.f), Stringf("Preparing %d%%", (int)(pregenerationProgress * 100.f)), Rgba(120, 120, 120, 255), 20.f, font);
+      }
+
       ++currentEnvironmentIndex;
    }
 
@@ -674,7 +585,10 @@ void TheGame::RenderGeneration() const
    g_theRenderer->DrawText2D(Vector2f(200.f, 850.f), "Map Generation", Rgba::WHITE, 40.f, font);
    g_theRenderer->DrawText2D(Vector2f(200.f, 100.f), "Enter - Play Map", Rgba::WHITE, 20.f, font);
 
-   if (m_gameContext->isEnvironmentFinished)
+   const MapGenerationJob* generationJob = m_gameContext->activeGenerationJob;
+   g_theRenderer->DrawText2D(Vector2f(200.f, 800.f), Stringf("Step %d / %d", generationJob->GetNumberOfStepsTaken(), generationJob->GetTotalNumberOfSteps()), Rgba::WHITE, 20.f, font);
+
+   if (generationJob->IsGenerationFinished())
    {
       g_theRenderer->DrawText2D(Vector2f(400.f, 100.f), "Generation Complete", Rgba::WHITE, 20.f, font);
    }
@@ -693,7 +607,7 @@ void TheGame::RenderGeneration() const
 
    g_theRenderer->DrawText2D(Vector2f(700.f, 100.f), "Escape - Back to Map Select", Rgba::WHITE, 20.f, font);
 
-   m_gameContext->activeMap->Render();
+   generationJob->GetMap()->Render();
 }
 
 
@@ -756,72 +670,14 @@ int TheGame::GetPlayerStepCount() const
 }
 
 
-//-----------------------------------------------------------------------------------------------
-bool TheGame::TryGenerationStep() const
-{
-   bool didGenerateStep = true;
-
-   EnvironmentBlueprint* currentEnvironment = m_gameContext->activeEnvironment;
-   Generator* activeGenerator = m_gameContext->activeGenerator;
-   Map* activeMap = m_gameContext->activeMap;
-   const std::vector<EnvironmentGenerationProcess*>& genProcs = currentEnvironment->GetGenerationProcesses();
-   
-   int* stepCount = &m_gameContext->activeGeneratorStep;
-   int genProcStepCount = genProcs[0]->numSteps;
-   unsigned int genProcToUse = 0;
-
-   for (genProcToUse; genProcToUse < genProcs.size() && genProcStepCount < *stepCount; ++genProcToUse)
-   {
-      genProcStepCount += genProcs[genProcToUse]->numSteps;
-   }
-
-   if (genProcStepCount == *stepCount)
-   {
-      genProcToUse++;
-
-      if (genProcToUse >= genProcs.size())
-      {
-         m_gameContext->isEnvironmentFinished = true;
-         return !didGenerateStep;
-      }
-      else
-      {
-         genProcStepCount += genProcs[genProcToUse]->numSteps;
-      }
-   }
-
-   // Check which generator to use
-   if (activeGenerator->GetName() != genProcs[genProcToUse]->generatorName)
-   {
-      delete activeGenerator;
-      activeGenerator = GeneratorRegistration::CreateGeneratorByName(genProcs[genProcToUse]->generatorName);
-      m_gameContext->activeGenerator = activeGenerator;
-   }
-
-   activeGenerator->GenerateStep(activeMap, stepCount, genProcs[genProcToUse]);
-   
-   if (*stepCount >= genProcStepCount)
-   {
-      genProcToUse++;
-      if (genProcToUse >= genProcs.size())
-      {
-         m_gameContext->isEnvironmentFinished = true;
-         return !didGenerateStep;
-      }
-   }
-
-   return didGenerateStep;
-}
-
-
 //-----------------------------------------------------------------------------------------------
 void TheGame::AddPlayerAtRandomLocation()
 {
-   TileCoords spawnCoords = m_gameContext->activeMap->GetRandomOpenCoords();
+   TileCoords spawnCoords = m_gameContext->activeMap->GetRandomOpenCoords(&m_gameContext->spawnRandom);
    Player* player = new Player(20, AGENT_TYPE, spawnCoords, '@', Rgba::YELLOW, Rgba(70, 70, 70, 255), "Player");
    player->AddToMap(m_gameContext->activeMap, spawnCoords);
    m_gameContext->activePlayer = player;
-   m_gameContext->activeAgents.insert(TurnOrderMapPair(0.f, player));
+   m_gameContext->activeAgents.Schedule(player, 0.f);
    m_gameContext->activeEntities.push_back(player);
    player->UpdateFOV();
 }
@@ -832,10 +688,15 @@ void TheGame::AddRandomNPCs()
 {
    for (NPCFactoryMap::iterator npcIter = NPCFactory::s_factoryMap->begin(); npcIter != NPCFactory::s_factoryMap->end(); ++npcIter)
    {
-      NPC* npc = npcIter->second->CreateNPC();
-      TileCoords spawnCoords = m_gameContext->activeMap->GetRandomOpenCoords();
+      if (m_gameContext->activeMap->GetNumberOfOpenTiles() == 0)
+      {
+         break;
+      }
+
+      NPC* npc = npcIter->second->CreateNPC(&m_gameContext->spawnRandom);
+      TileCoords spawnCoords = m_gameContext->activeMap->GetRandomOpenCoords(&m_gameContext->spawnRandom);
       npc->AddToMap(m_gameContext->activeMap, spawnCoords);
-      m_gameContext->activeAgents.insert(TurnOrderMapPair(.1f, npc));
+      m_gameContext->activeAgents.Schedule(npc, .1f);
       m_gameContext->activeEntities.push_back(npc);
    }
 }
@@ -846,8 +707,8 @@ void TheGame::AddRandomItems()
 {
    for (int itemIndex = 0; itemIndex < 20; ++itemIndex)
    {
-      Item* item = ItemFactory::CreateRandomItem();
-      TileCoords spawnCoords = m_gameContext->activeMap->GetRandomOpenCoords();
+      Item* item = ItemFactory::CreateRandomItem(&m_gameContext->spawnRandom);
+      TileCoords spawnCoords = m_gameContext->activeMap->GetRandomOpenCoords(&m_gameContext->spawnRandom);
       item->AddToMap(m_gameContext->activeMap, spawnCoords);
       m_gameContext->activeEntities.push_back(item);
    }
@@ -857,7 +718,7 @@ void TheGame::AddRandomItems()
 //-----------------------------------------------------------------------------------------------
 void TheGame::InitPathfinder()
 {
-   TileCoords goal = m_gameContext->activeMap->GetRandomOpenCoords();
+   TileCoords goal = m_gameContext->activeMap->GetRandomOpenCoords(&m_gameContext->spawnRandom);
    m_gameContext->activePathfinder = new PathfinderAStar(m_gameContext->activePlayer->GetPosition(), goal, m_gameContext->activeMap);
 }
 
@@ -868,7 +729,7 @@ void TheGame::RunPathfindingTest()
    double startTime = Time::GetCurrentTimeSeconds();
    for (int testIndex = 0; testIndex < 10000; ++testIndex)
    {
-      TileCoords goal = m_gameContext->activeMap->GetRandomOpenCoords();
+      TileCoords goal = m_gameContext->activeMap->GetRandomOpenCoords(&m_gameContext->spawnRandom);
       PathfinderAStar finder = PathfinderAStar(m_gameContext->activePlayer->GetPosition(), goal, m_gameContext->activeMap);
       finder.FindPath();
    }
@@ -879,65 +740,6 @@ void TheGame::RunPathfindingTest()
 }
 
 
-//-----------------------------------------------------------------------------------------------
-void TheGame::CleanUpDeadEntities()
-{
-   std::vector<Entity*>& entities = m_gameContext->activeEntities;
-
-   for (std::vector<Entity*>::iterator entityIter = entities.begin(); entityIter != entities.end();)
-   {
-      Entity* currentEntity = *entityIter;
-      if (!currentEntity->IsAlive())
-      {
-         RemoveReferencesToEntity(currentEntity);
-         delete currentEntity;
-         currentEntity = nullptr;
-         entityIter = entities.erase(entityIter);
-      }
-      else
-      {
-         ++entityIter;
-      }
-   }
-}
-
-
-//-----------------------------------------------------------------------------------------------
-void TheGame::RemoveReferencesToEntity(Entity* entityToDereference)
-{
-   if (entityToDereference->IsAgent())
-   {
-      // Clear Tile
-      Tile* tileToClear = m_gameContext->activeMap->GetTileAtTileCoords(entityToDereference->GetPosition());
-      tileToClear->ClearAgent();
-
-
-      // Remove from turn order
-      for (TurnOrderMapIter turnOrderIter = m_gameContext->activeAgents.begin(); turnOrderIter != m_gameContext->activeAgents.end(); ++turnOrderIter)
-      {
-         Entity* currentEntity = turnOrderIter->second;
-         if (currentEntity == entityToDereference)
-         {
-            m_gameContext->activeAgents.erase(turnOrderIter);
-            break;
-         }
-      }
-   }
-
-   // Remove from all entities
-   for (Entity* currentEntity : m_gameContext->activeEntities)
-   {
-      currentEntity->DereferenceEntity(entityToDereference);
-   }
-
-   // Remove player from context
-   if (entityToDereference->IsPlayer())
-   {
-      m_gameContext->activePlayer = nullptr;
-   }
-}
-
-
 //-----------------------------------------------------------------------------------------------
 void TheGame::ResetGame()
 {
@@ -947,29 +749,13 @@ void TheGame::ResetGame()
    CleanUpPlayingUI();
 
    delete m_gameContext;
-   m_gameContext = new GameContext;
-}
-
 
-//-----------------------------------------------------------------------------------------------
-void TheGame::IncrementPlayerTurnCount()
-{
-   ++m_gameContext->numberOfPlayerStepsTaken;
-}
+   // Every entity from the last game is gone, so drop the emptied slabs and repack the free lists
+   NPC::s_objectPool.Reset();
+   Item::s_objectPool.Reset();
+   Feature::s_objectPool.Reset();
 
-
-//-----------------------------------------------------------------------------------------------
-void TheGame::IncrementPlayerKillCount()
-{
-   ++m_gameContext->numberOfEnemiesSlainByPlayer;
-}
-
-
-//-----------------------------------------------------------------------------------------------
-void TheGame::SetStateGameOver()
-{
-   m_isGameOver = true;
-   g_thePlayerStatusBar->SetGameOver();
+   m_gameContext = new GameContext;
 }
 
 
@@ -1031,6 +817,132 @@ void TheGame::DrawDebugInfo() const
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void TheGame::StartPlayingGeneratedMap()
+{
+   MapGenerationJob* generationJob = m_gameContext->activeGenerationJob;
+   if (!generationJob->IsFinalized())
+   {
+      generationJob->Finalize();
+   }
+
+   // Stage timings go to the console history
+   g_theConsole->ConsolePrintf(Stringf("Generated %s (seed %u)", generationJob->GetEnvironment()->GetName().c_str(), generationJob->GetGameSeed()), Rgba::GREEN);
+   const std::vector<GenerationStage>& stages = generationJob->GetStages();
+   for (int stageIndex = 0; stageIndex < (int)stages.size(); ++stageIndex)
+   {
+      const GenerationStage& stage = stages[stageIndex];
+      std::string parallelNote = (stage.parallelGroup >= 0) ? Stringf(", parallel group from stage %d", stage.parallelGroup + 1) : "";
+      g_theConsole->ConsolePrintf(Stringf("  Stage %d %s: %d/%d steps in %.2fms%s", stageIndex + 1, stage.process->generatorName.c_str(),
+         stage.numStepsTaken, stage.numSteps, stage.elapsedSeconds * 1000.0, parallelNote.c_str()), Rgba::WHITE);
+   }
+
+   m_gameContext->activeMap = generationJob->TakeMap(&m_gameContext->activeEntities);
+   delete generationJob;
+   m_gameContext->activeGenerationJob = nullptr;
+
+   AddPlayerAtRandomLocation();
+   AddRandomNPCs();
+   AddRandomItems();
+   EnableMapChunkStreamingIfLarge();
+   InitPlayingUI();
+
+   m_gameStateStack.push(PLAYING_STATE);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Plays a level from Data/Levels/<environment>.levels if one was baked. A fixed seed has to be in
+// the library, otherwise any baked seed will do. Libraries stay open once looked up
+bool TheGame::TryStartPlayingBakedLevel(EnvironmentBlueprint* environment)
+{
+   bool didStart = true;
+
+   const std::string& environmentName = environment->GetName();
+   std::map<std::string, LevelLibrary*>::iterator libraryIter = m_levelLibraries.find(environmentName);
+   if (libraryIter == m_levelLibraries.end())
+   {
+      LevelLibrary* library = new LevelLibrary;
+      std::string libraryPath = Stringf("%s/%s%s", LevelBaker::LEVEL_LIBRARY_DIRECTORY, environmentName.c_str(), LevelBaker::LEVEL_LIBRARY_EXTENSION);
+
+      // Remember missing or stale libraries too, so the disk is only checked once
+      if (!library->Open(libraryPath) || library->GetDimensions() != environment->GetSize() || library->GetNumberOfLevels() == 0)
+      {
+         delete library;
+         library = nullptr;
+      }
+
+      libraryIter = m_levelLibraries.insert(std::pair<std::string, LevelLibrary*>(environmentName, library)).first;
+   }
+
+   LevelLibrary* library = libraryIter->second;
+   if (library == nullptr)
+   {
+      return !didStart;
+   }
+
+   unsigned int gameSeed = m_fixedGameSeed;
+   if (gameSeed == 0)
+   {
+      gameSeed = library->GetSeedAtIndex(m_seedRandom.GetIntBetweenInclusive(0, library->GetNumberOfLevels() - 1));
+   }
+
+   Map* bakedMap = library->LoadLevel(gameSeed, &m_gameContext->activeEntities);
+   if (bakedMap == nullptr)
+   {
+      return !didStart;
+   }
+
+   m_gameContext->SeedRandomStreams(gameSeed);
+   m_gameContext->activeMap = bakedMap;
+   g_theConsole->ConsolePrintf(Stringf("Loaded baked %s (seed %u)", environmentName.c_str(), gameSeed), Rgba::GREEN);
+
+   AddPlayerAtRandomLocation();
+   AddRandomNPCs();
+   AddRandomItems();
+   EnableMapChunkStreamingIfLarge();
+   InitPlayingUI();
+
+   m_gameStateStack.push(PLAYING_STATE);
+   return didStart;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Only the regions around the middle of the world exist at first. Spawns land there
+void TheGame::StartPlayingRegionMap()
+{
+   Map* activeMap = m_gameContext->activeMap;
+   const Vector2i& dimensions = activeMap->GetDimensions();
+   TileCoords worldCenter(dimensions.x / 2, dimensions.y / 2);
+   activeMap->GenerateRegionsInArea(worldCenter - TileCoords(Map::CHUNK_SIZE, Map::CHUNK_SIZE), worldCenter + TileCoords(Map::CHUNK_SIZE, Map::CHUNK_SIZE));
+
+   AddPlayerAtRandomLocation();
+   AddRandomNPCs();
+   AddRandomItems();
+   EnableMapChunkStreamingIfLarge();
+   InitPlayingUI();
+
+   m_gameStateStack.push(PLAYING_STATE);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void TheGame::EnableMapChunkStreamingIfLarge()
+{
+   Map* activeMap = m_gameContext->activeMap;
+   if (activeMap->GetNumberOfChunks() < MIN_MAP_CHUNKS_FOR_STREAMING)
+   {
+      return;
+   }
+
+   if (!activeMap->EnableChunkStreaming(MAP_CHUNK_CACHE_DIRECTORY))
+   {
+      g_theConsole->ConsolePrintf(Stringf("Could not create a map chunk cache in %s. Keeping the whole map in memory.", MAP_CHUNK_CACHE_DIRECTORY), Rgba::RED);
+   }
+}
+
+
 //-----------------------------------------------------------------------------------------------
 void TheGame::CheckForSaveGame()
 {
@@ -1066,6 +978,7 @@ void TheGame::LoadGameFromFile()
    LoadGame load(m_gameContext);
    load.Load();
    m_doesSaveExist = false;
+   EnableMapChunkStreamingIfLarge();
 
    m_gameContext->activePlayer->UpdateFOV();
    InitPlayingUI();
@@ -1101,4 +1014,200 @@ STATIC void TheGame::ToggleGodMode(ConsoleCommandArgs&)
    {
       g_theConsole->ConsolePrintf("God mode disabled.", Rgba::RED);
    }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC void TheGame::ListNearbyEntities(ConsoleCommandArgs& args)
+{
+   const GameContext* context = g_theGame->m_gameContext;
+   if (context->activeMap == nullptr || context->activePlayer == nullptr)
+   {
+      g_theConsole->ConsolePrintf("No active map.", Rgba::RED);
+      return;
+   }
+
+   float radius;
+   args.GetNextArgAsFloat(&radius, 10.f);
+
+   DistanceToEntityMap nearbyEntities;
+   context->activeMap->GetEntityGrid()->FindEntitiesInRadius(context->activePlayer->GetPosition(), radius, &nearbyEntities);
+
+   g_theConsole->ConsolePrintf(Stringf("%d entities within %.1f tiles:", nearbyEntities.size(), radius), Rgba::GREEN);
+   for (const DistanceToEntityPair& entityPair : nearbyEntities)
+   {
+      const Entity* entity = entityPair.second;
+      g_theConsole->ConsolePrintf(Stringf("  %s (id %d) at %s, distance %.1f", entity->GetName().c_str(), entity->GetID(), entity->GetPosition().ToString().c_str(), entityPair.first), Rgba::WHITE);
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static Map* GenerateBenchmarkMap(const std::string& generatorName, const Vector2i& mapSize, TileIndexLayout layout, int maxSteps, unsigned int seed)
+{
+   RandomNumberGenerator generationRandom(seed, GENERATION_RANDOM_STREAM);
+   Generator* generator = GeneratorRegistration::CreateGeneratorByName(generatorName);
+   Map* map = generator->GenerateEmptyMap(mapSize, generatorName, layout);
+   generator->InitializeMap(map, &generationRandom);
+
+   int currentStep = 0;
+   while (currentStep < maxSteps && generator->GenerateStep(map, &currentStep, &generationRandom));
+
+   delete generator;
+   return map;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Benchmark maps are never finalized, so any features the generators placed are still ours
+static void DeleteBenchmarkMap(Map* map)
+{
+   const TileIndex numTilesInMap = map->GetNumberOfTilesInMap();
+   for (TileIndex tileIndex = 0; tileIndex < numTilesInMap; ++tileIndex)
+   {
+      Tile* tile = map->GetTileAtIndex(tileIndex);
+      delete tile->occupyingFeature;
+      tile->occupyingFeature = nullptr;
+   }
+
+   delete map;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC void TheGame::RunTileLayoutBenchmark(ConsoleCommandArgs& args)
+{
+   const int NUM_FOV_UPDATES = 100;
+   const int NUM_PATHS = 1000;
+
+   Vector2i mapSize;
+   args.GetNextArgAsInt(&mapSize.x, 128);
+   args.GetNextArgAsInt(&mapSize.y, 128);
+
+   g_theConsole->SetDisplayMode(Console::HISTORY_DISPLAY);
+   g_theConsole->ConsolePrintf(Stringf("Tile layout benchmark on %dx%d maps", mapSize.x, mapSize.y), Rgba::GREEN);
+
+   unsigned int benchmarkSeed = g_theGame->m_seedRandom.GetNextUint();
+
+   // FOV and pathfinding run on the same cave in both layouts
+   Map* caveMap = GenerateBenchmarkMap("CellularAutomata", mapSize, ROW_MAJOR_LAYOUT, 100, benchmarkSeed);
+   Generator::FinalizeMap(caveMap);
+
+   for (int layoutIndex = 0; layoutIndex < NUM_TILE_INDEX_LAYOUTS; ++layoutIndex)
+   {
+      TileIndexLayout layout = (TileIndexLayout)layoutIndex;
+
+      double startTime = Time::GetCurrentTimeSeconds();
+      DeleteBenchmarkMap(GenerateBenchmarkMap("CellularAutomata", mapSize, layout, 100, benchmarkSeed));
+      double cavesTime = Time::GetCurrentTimeSeconds() - startTime;
+
+      startTime = Time::GetCurrentTimeSeconds();
+      DeleteBenchmarkMap(GenerateBenchmarkMap("Dungeon", mapSize, layout, 50, benchmarkSeed));
+      double dungeonTime = Time::GetCurrentTimeSeconds() - startTime;
+
+      caveMap->SetTileIndexLayout(layout);
+      RandomNumberGenerator spawnRandom(benchmarkSeed, SPAWN_RANDOM_STREAM);
+
+      Player* viewer = new Player(20, AGENT_TYPE, caveMap->GetRandomOpenCoords(&spawnRandom), '@', Rgba::YELLOW, Rgba::BLACK, "Benchmark");
+      viewer->AddToMap(caveMap, viewer->GetPosition());
+      startTime = Time::GetCurrentTimeSeconds();
+      for (int updateIndex = 0; updateIndex < NUM_FOV_UPDATES; ++updateIndex)
+      {
+         viewer->UpdateFOV();
+      }
+      double fovTime = Time::GetCurrentTimeSeconds() - startTime;
+
+      startTime = Time::GetCurrentTimeSeconds();
+      for (int pathIndex = 0; pathIndex < NUM_PATHS; ++pathIndex)
+      {
+         PathfinderAStar finder(viewer->GetPosition(), caveMap->GetRandomOpenCoords(&spawnRandom), caveMap);
+         finder.FindPath();
+      }
+      double pathTime = Time::GetCurrentTimeSeconds() - startTime;
+
+      caveMap->RemoveAgent(viewer->GetPosition());
+      caveMap->GetEntityGrid()->RemoveEntity(viewer);
+      delete viewer;
+
+      g_theConsole->ConsolePrintf(Stringf("%s: caves %.3fs, dungeon %.3fs, %d FOV %.3fs, %d paths %.3fs",
+         Map::GetStringForTileIndexLayout(layout).c_str(), cavesTime, dungeonTime, NUM_FOV_UPDATES, fovTime, NUM_PATHS, pathTime), Rgba::GREEN);
+   }
+
+   DeleteBenchmarkMap(caveMap);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Same cases as -genregress, without recording
+STATIC void TheGame::RunGenerationRegression(ConsoleCommandArgs&)
+{
+   g_theConsole->SetDisplayMode(Console::HISTORY_DISPLAY);
+
+   std::vector<GenerationRegressionCase> cases;
+   std::vector<GenerationRegressionResult> results;
+   GenerationRegression::GetDefaultCases(&cases);
+   GenerationRegression::RunCases(cases, &results);
+
+   std::string baselineText;
+   if (!LoadTextFileToBuffer(GenerationRegression::BASELINE_FILE_PATH, baselineText))
+   {
+      g_theConsole->ConsolePrintf(Stringf("No baseline at %s; run -genregress record first", GenerationRegression::BASELINE_FILE_PATH), Rgba::RED);
+      baselineText.clear();
+   }
+
+   std::vector<std::string> reportLines;
+   int numFailures = GenerationRegression::CompareToBaseline(results, baselineText, GenerationRegression::MAX_STEP_TIME_GROWTH, &reportLines);
+   for (const std::string& reportLine : reportLines)
+   {
+      g_theConsole->ConsolePrintf(reportLine, Rgba::WHITE);
+   }
+
+   g_theConsole->ConsolePrintf(Stringf("%d of %d generation results failed", numFailures, (int)results.size()), (numFailures > 0) ? Rgba::RED : Rgba::GREEN);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC void TheGame::ListMapChunks(ConsoleCommandArgs&)
+{
+   g_theConsole->SetDisplayMode(Console::HISTORY_DISPLAY);
+
+   Map* activeMap = g_theGame->m_gameContext->activeMap;
+   if (activeMap == nullptr)
+   {
+      g_theConsole->ConsolePrintf("No active map.", Rgba::RED);
+      return;
+   }
+
+   g_theConsole->ConsolePrintf(Stringf("%d of %d chunks resident. Streaming %s.", activeMap->GetNumberOfResidentChunks(), activeMap->GetNumberOfChunks(),
+      activeMap->IsChunkStreamingEnabled() ? "enabled" : "disabled"), Rgba::GREEN);
+
+   if (activeMap->IsGeneratingRegions())
+   {
+      g_theConsole->ConsolePrintf(Stringf("%d of %d regions generated from world seed %u.", activeMap->GetNumberOfGeneratedChunks(), activeMap->GetNumberOfChunks(), activeMap->GetWorldSeed()), Rgba::GREEN);
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC void TheGame::SetGameSeed(ConsoleCommandArgs& args)
+{
+   g_theConsole->SetDisplayMode(Console::HISTORY_DISPLAY);
+
+   int newSeed = -1;
+   args.GetNextArgAsInt(&newSeed, -1);
+   if (newSeed < 0)
+   {
+      g_theConsole->ConsolePrintf(Stringf("Current game seed is %u.", g_theGame->m_gameContext->gameSeed), Rgba::GREEN);
+      return;
+   }
+
+   g_theGame->m_fixedGameSeed = (unsigned int)newSeed;
+   if (newSeed == 0)
+   {
+      g_theConsole->ConsolePrintf("New games will pick a random seed.", Rgba::GREEN);
+   }
+   else
+   {
+      g_theConsole->ConsolePrintf(Stringf("New games will use seed %u.", g_theGame->m_fixedGameSeed), Rgba::GREEN);
+   }
 }
\ No newline at end of file
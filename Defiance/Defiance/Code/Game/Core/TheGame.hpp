@@ -1,6 +1,12 @@
 #pragma once
 
 #include <stack>
+#include <map>
+#include <string>
+#include <vector>
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Game/Core/GameCommon.hpp"
+#include "Game/Core/AgentDecisionWorkers.hpp"
 #include "Game/FieldOfView/FieldOfView.hpp"
 
 
@@ -10,6 +16,11 @@ class Framebuffer;
 class MeshRenderer;
 class ConsoleCommandArgs;
 struct GameContext;
+class EnvironmentBlueprint;
+class MapGenerationService;
+class UtilityScoringBatch;
+class Agent;
+class LevelLibrary;
 
 
 //-----------------------------------------------------------------------------------------------
@@ -38,6 +49,8 @@ public:
    ~TheGame();
 
    void Init();
+   void InitHeadless();
+   void LoadAllBlueprints();
    void RegisterConsoleCommands();
    
    void InitPlayingUI();
@@ -46,6 +59,14 @@ public:
    void Update();
    void UpdateGeneration();
    void UpdatePlaying();
+   bool GatherDueAgents();
+   AgentDetailLevel GetDetailLevelForAgent(const Agent* agent) const;
+   void DecideDueAgents();
+   void RunForDecidingAgents(AgentDecisionStep step);
+   int ActDueAgents();
+   void AdvanceSimulationClock() { m_simulationClock += m_simulationDelta; }
+   void AdvanceSimulationClockToNextTurn();
+   void UpdateMapChunkResidency();
 
    void HandleInput();
    void HandleInputMainMenu();
@@ -77,13 +98,18 @@ public:
    void SetStateGameOver();
 
    int GetPlayerStepCount() const;
-   bool TryGenerationStep() const;
    bool GameHasFocus() const;
    void ClearScreen() const;
    void SetUpWorldCoordinateSystem() const;
    void Setup2DView() const;
    void DrawDebugInfo() const;
 
+   void BeginEnvironment(EnvironmentBlueprint* environment);
+   void StartPlayingGeneratedMap();
+   bool TryStartPlayingBakedLevel(EnvironmentBlueprint* environment);
+   void StartPlayingRegionMap();
+   void EnableMapChunkStreamingIfLarge();
+
    void CheckForSaveGame();
    void SaveGameToFile();
    void LoadGameFromFile();
@@ -94,7 +120,23 @@ public:
    static bool s_isDebug;
 
    static void ToggleGodMode(ConsoleCommandArgs&);
+   static void ListNearbyEntities(ConsoleCommandArgs& args);
+   static void RunTileLayoutBenchmark(ConsoleCommandArgs& args);
+   static void RunGenerationRegression(ConsoleCommandArgs& args);
+   static void ListMapChunks(ConsoleCommandArgs& args);
+   static void SetGameSeed(ConsoleCommandArgs& args);
+   static const char* MAP_CHUNK_CACHE_DIRECTORY;
+   static const int MIN_MAP_CHUNKS_FOR_STREAMING;
+
+   // Agents within FULL_DETAIL_DISTANCE of the player run every turn as normal. Out to
+   // DORMANT_DETAIL_DISTANCE they still act every turn but only refresh their FOV every few turns.
+   // Past that they are frozen and check again every DORMANT_WAKE_CHECK_INTERVAL. The full detail
+   // distance leaves room past FOV range, so anything the player can see is always at full detail
+   static const float FULL_DETAIL_DISTANCE;
+   static const float DORMANT_DETAIL_DISTANCE;
+   static const float DORMANT_WAKE_CHECK_INTERVAL;
    bool IsGodModeEnabled() const { return m_isGodMode; }
+   bool IsGameOver() const { return m_isGameOver; }
 
    RaycastResult m_testCast;
    Vector2f m_testTarget;
@@ -109,6 +151,14 @@ private:
    bool m_doesSaveExist;
    bool m_didJustSave;
    GameContext* m_gameContext;
+   MapGenerationService* m_mapGenerationService;
+   AgentDecisionWorkers* m_agentDecisionWorkers;
+   UtilityScoringBatch* m_utilityScoringBatch;
+   std::vector<Agent*> m_turnBatch;
+   std::vector<Agent*> m_decidingAgents;
+   std::map<std::string, LevelLibrary*> m_levelLibraries;
+   RandomNumberGenerator m_seedRandom;
+   unsigned int m_fixedGameSeed;
 
    std::stack<GameState> m_gameStateStack; // #TODO - make this custom like the matrix stack
 };
@@ -0,0 +1,345 @@
+#include <thread>
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Time/Time.hpp"
+#include "Game/Core/TheGame.hpp"
+#include "Game/Core/GameContext.hpp"
+#include "Game/Core/AgentDecisionWorkers.hpp"
+#include "Game/IO/LevelLibrary.hpp"
+#include "Game/Map/Map.hpp"
+#include "Game/Generators/Generator.hpp"
+#include "Game/Generators/MapGenerationService.hpp"
+#include "Game/Environments/EnvironmentBlueprint.hpp"
+#include "Game/Entities/Agents/Player.hpp"
+#include "Game/Entities/Agents/NPCs/NPCFactory.hpp"
+#include "Game/Entities/Agents/Behaviors/Behavior.hpp"
+#include "Game/Entities/Agents/Behaviors/UtilityScoringBatch.hpp"
+#include "Game/Entities/Agents/Factions/Faction.hpp"
+#include "Game/Entities/Items/ItemFactory.hpp"
+#include "Game/Entities/Features/FeatureFactory.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC const float TheGame::FULL_DETAIL_DISTANCE = 32.f;
+STATIC const float TheGame::DORMANT_DETAIL_DISTANCE = 80.f;
+STATIC const float TheGame::DORMANT_WAKE_CHECK_INTERVAL = 5.f;
+
+
+//-----------------------------------------------------------------------------------------------
+extern TheGame* g_theGame = nullptr;
+
+
+//-----------------------------------------------------------------------------------------------
+TheGame::TheGame()
+   : m_secondsSinceLastFrame(0.f)
+   , m_gameContext(nullptr)
+   , m_mapGenerationService(nullptr)
+   , m_agentDecisionWorkers(nullptr)
+   , m_utilityScoringBatch(nullptr)
+   , m_seedRandom((unsigned int)(Time::GetCurrentTimeSeconds() * 1000.0))
+   , m_fixedGameSeed(0)
+   , m_testCast()
+   , m_showTestCast(false)
+   , m_simulationClock(0.f)
+   , m_simulationDelta(0.1f)
+   , m_isGameOver(false)
+   , m_isGodMode(false)
+   , m_doesSaveExist(false)
+   , m_didJustSave(false)
+{
+   m_gameStateStack.push(STARTING_STATE);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+TheGame::~TheGame()
+{
+   // Jobs still reference environments and generators, so the worker has to stop first
+   delete m_mapGenerationService;
+   delete m_agentDecisionWorkers;
+   delete m_utilityScoringBatch;
+
+   for (std::map<std::string, LevelLibrary*>::iterator libraryIter = m_levelLibraries.begin(); libraryIter != m_levelLibraries.end(); ++libraryIter)
+   {
+      delete libraryIter->second;
+   }
+   m_levelLibraries.clear();
+
+   GeneratorRegistration::FreeAllGeneratorRegistrations();
+   EnvironmentBlueprint::CleanUpEnvironmentBlueprints();
+
+   // NPCs share their behaviors' blueprint data, so they go before the blueprints do
+   delete m_gameContext;
+   BehaviorRegistration::FreeAllBehaviorRegistrations();
+   NPCFactory::FreeAllNPCBlueprints();
+   Faction::FreeAllFactions();
+   ItemFactory::FreeAllItemBlueprints();
+   FeatureFactory::FreeAllFeatureBlueprints();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Everything a simulation needs and nothing that draws: no console, fonts, UI or background map
+// generation. The caller supplies the map and agents through the game context
+void TheGame::InitHeadless()
+{
+   m_gameContext = new GameContext;
+   LoadAllBlueprints();
+
+   int numHardwareThreads = (int)std::thread::hardware_concurrency();
+   m_agentDecisionWorkers = new AgentDecisionWorkers((numHardwareThreads > 1) ? numHardwareThreads - 1 : 0);
+   m_utilityScoringBatch = new UtilityScoringBatch;
+
+   m_gameStateStack.push(PLAYING_STATE);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void TheGame::LoadAllBlueprints()
+{
+   EnvironmentBlueprint::LoadEnvironmentBlueprints();
+   Faction::LoadAllFactions();
+   NPCFactory::LoadAllNPCBlueprints();
+   ItemFactory::LoadAllItemBlueprints();
+   FeatureFactory::LoadAllFeatureBlueprints();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Everyone due now takes this turn, up to whoever isn't ready (the player waiting on input).
+// Returns false if someone wasn't ready, so the clock has to wait for them
+bool TheGame::GatherDueAgents()
+{
+   bool advanceTime = true;
+
+   TurnScheduler& turnScheduler = m_gameContext->activeAgents;
+   m_turnBatch.clear();
+   m_decidingAgents.clear();
+   while (!turnScheduler.IsEmpty() && turnScheduler.GetNextTurnTime() <= m_simulationClock)
+   {
+      Agent* agent = turnScheduler.GetNextAgent();
+      if (!agent->IsReadyToUpdate())
+      {
+         advanceTime = false;
+         break;
+      }
+
+      turnScheduler.Remove(agent);
+      if (agent->IsPlayer() || !agent->IsAlive())
+      {
+         m_turnBatch.push_back(agent);
+         continue;
+      }
+
+      // Dormant agents stay where they are and only look again later to see if they should wake
+      AgentDetailLevel detailLevel = GetDetailLevelForAgent(agent);
+      bool isWaking = (agent->GetDetailLevel() == DORMANT_DETAIL && detailLevel != DORMANT_DETAIL);
+      agent->SetDetailLevel(detailLevel);
+      if (detailLevel == DORMANT_DETAIL)
+      {
+         turnScheduler.Schedule(agent, m_simulationClock + DORMANT_WAKE_CHECK_INTERVAL);
+         continue;
+      }
+
+      // Nothing kept the surroundings of a dormant agent resident, so bring them back before it looks around
+      if (isWaking)
+      {
+         m_gameContext->activeMap->MakeChunksResidentAround(agent->GetPosition());
+      }
+
+      m_turnBatch.push_back(agent);
+      m_decidingAgents.push_back(agent);
+   }
+
+   return advanceTime;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Skips the idle ticks between turns when nobody is waiting on input
+void TheGame::AdvanceSimulationClockToNextTurn()
+{
+   const TurnScheduler& turnScheduler = m_gameContext->activeAgents;
+   if (!turnScheduler.IsEmpty() && turnScheduler.GetNextTurnTime() > m_simulationClock)
+   {
+      m_simulationClock = turnScheduler.GetNextTurnTime();
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Everyone is at full detail without a player to measure from
+AgentDetailLevel TheGame::GetDetailLevelForAgent(const Agent* agent) const
+{
+   const Player* player = m_gameContext->activePlayer;
+   if (player == nullptr)
+   {
+      return FULL_DETAIL;
+   }
+
+   float distanceToPlayer = Vector2i::GetDistanceBetween(agent->GetPosition(), player->GetPosition());
+   if (distanceToPlayer <= FULL_DETAIL_DISTANCE)
+   {
+      return FULL_DETAIL;
+   }
+
+   if (distanceToPlayer <= DORMANT_DETAIL_DISTANCE)
+   {
+      return REDUCED_DETAIL;
+   }
+
+   return DORMANT_DETAIL;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Sense and decide against the world as it stands. Perceiving and planning spread across the
+// workers; scoring is cheap per agent and runs here for the whole batch at once
+void TheGame::DecideDueAgents()
+{
+   RunForDecidingAgents(&Agent::Perceive);
+   m_utilityScoringBatch->ChooseBehaviors(m_decidingAgents);
+   RunForDecidingAgents(&Agent::PlanChosenBehavior);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Chunks are generated or paged in on first touch, even through const tile accessors, and that
+// isn't safe to do from several threads. Maps that can fault chunks decide on this thread
+void TheGame::RunForDecidingAgents(AgentDecisionStep step)
+{
+   const Map* activeMap = m_gameContext->activeMap;
+   if (activeMap->IsChunkStreamingEnabled() || activeMap->IsGeneratingRegions())
+   {
+      for (Agent* agent : m_decidingAgents)
+      {
+         (agent->*step)();
+      }
+   }
+   else
+   {
+      m_agentDecisionWorkers->RunForAll(m_decidingAgents, step);
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Act in turn order. Anyone killed by an earlier agent this turn just drops out. Returns how
+// many agents acted
+int TheGame::ActDueAgents()
+{
+   int numAgentsActed = 0;
+
+   TurnScheduler& turnScheduler = m_gameContext->activeAgents;
+   for (Agent* agent : m_turnBatch)
+   {
+      if (!agent->IsAlive())
+      {
+         continue;
+      }
+
+      float duration = agent->IsPlayer() ? agent->Update() : agent->Act();
+      ++numAgentsActed;
+      if (agent->IsAlive())
+      {
+         turnScheduler.Schedule(agent, m_simulationClock + duration);
+      }
+   }
+
+   return numAgentsActed;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Pages out map chunks that are far from every active agent. Dormant agents are still scheduled
+// but don't count, since they touch nothing until they wake. Their own chunk stays pinned by them
+void TheGame::UpdateMapChunkResidency()
+{
+   Map* activeMap = m_gameContext->activeMap;
+   if (activeMap == nullptr || !activeMap->IsChunkStreamingEnabled())
+   {
+      return;
+   }
+
+   std::vector<TileCoords> activePositions;
+   const TurnScheduler& turnScheduler = m_gameContext->activeAgents;
+   activePositions.reserve(turnScheduler.GetNumberOfScheduledAgents());
+   for (int turnSlot = 0; turnSlot < turnScheduler.GetNumberOfScheduledAgents(); ++turnSlot)
+   {
+      const Agent* agent = turnScheduler.GetScheduledAgentAtSlot(turnSlot);
+      if (agent->GetDetailLevel() != DORMANT_DETAIL)
+      {
+         activePositions.push_back(agent->GetPosition());
+      }
+   }
+
+   activeMap->UpdateChunkResidency(activePositions);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void TheGame::CleanUpDeadEntities()
+{
+   std::vector<Entity*>& entities = m_gameContext->activeEntities;
+
+   for (std::vector<Entity*>::iterator entityIter = entities.begin(); entityIter != entities.end();)
+   {
+      Entity* currentEntity = *entityIter;
+      if (!currentEntity->IsAlive())
+      {
+         RemoveReferencesToEntity(currentEntity);
+         delete currentEntity;
+         currentEntity = nullptr;
+         entityIter = entities.erase(entityIter);
+      }
+      else
+      {
+         ++entityIter;
+      }
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void TheGame::RemoveReferencesToEntity(Entity* entityToDereference)
+{
+   m_gameContext->activeMap->GetEntityGrid()->RemoveEntity(entityToDereference);
+
+   if (entityToDereference->IsAgent())
+   {
+      // Clear Tile
+      m_gameContext->activeMap->RemoveAgent(entityToDereference->GetPosition());
+
+
+      // Remove from turn order
+      m_gameContext->activeAgents.Remove((Agent*)entityToDereference);
+   }
+
+   // Everything else holds handles, which stop resolving once the entity is deleted
+
+   // Remove player from context
+   if (entityToDereference->IsPlayer())
+   {
+      m_gameContext->activePlayer = nullptr;
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void TheGame::IncrementPlayerTurnCount()
+{
+   ++m_gameContext->numberOfPlayerStepsTaken;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void TheGame::IncrementPlayerKillCount()
+{
+   ++m_gameContext->numberOfEnemiesSlainByPlayer;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void TheGame::SetStateGameOver()
+{
+   m_isGameOver = true;
+}
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Debug/ErrorWarningAssert.hpp"
+#include "Game/Core/TurnScheduler.hpp"
+#include "Game/Entities/Agents/Agent.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+TurnScheduler::TurnScheduler()
+   : m_nextSequence(0)
+{
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void TurnScheduler::Schedule(Agent* agent, float turnTime)
+{
+   ASSERT_OR_DIE(!IsScheduled(agent), Stringf("ERROR: %s already has a turn scheduled!", agent->GetName().c_str()));
+
+   ScheduledTurn turn;
+   turn.turnTime = turnTime;
+   turn.sequence = m_nextSequence++;
+   turn.agent = agent;
+
+   m_heap.push_back(turn);
+   int slot = (int)m_heap.size() - 1;
+   agent->SetTurnSlot(slot);
+   SiftUp(slot);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Goes behind every turn already scheduled for the same time, as if removed and scheduled again
+void TurnScheduler::Reschedule(Agent* agent, float turnTime)
+{
+   if (!IsScheduled(agent))
+   {
+      Schedule(agent, turnTime);
+      return;
+   }
+
+   int slot = agent->GetTurnSlot();
+   ScheduledTurn& turn = m_heap[slot];
+   float previousTurnTime = turn.turnTime;
+   turn.turnTime = turnTime;
+   turn.sequence = m_nextSequence++;
+
+   if (turnTime < previousTurnTime)
+   {
+      SiftUp(slot);
+   }
+   else
+   {
+      SiftDown(slot);
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool TurnScheduler::Remove(Agent* agent)
+{
+   bool didRemove = true;
+   if (!IsScheduled(agent))
+   {
+      return !didRemove;
+   }
+
+   int slot = agent->GetTurnSlot();
+   agent->SetTurnSlot(-1);
+
+   int lastSlot = (int)m_heap.size() - 1;
+   if (slot != lastSlot)
+   {
+      PlaceAtSlot(m_heap[lastSlot], slot);
+      m_heap.pop_back();
+
+      // The moved turn can belong either above or below its new slot
+      SiftUp(slot);
+      SiftDown(m_heap[slot].agent->GetTurnSlot());
+   }
+   else
+   {
+      m_heap.pop_back();
+   }
+
+   return didRemove;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Keeps the heap's storage for the next map
+void TurnScheduler::Clear()
+{
+   for (ScheduledTurn& turn : m_heap)
+   {
+      turn.agent->SetTurnSlot(-1);
+   }
+
+   m_heap.clear();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool TurnScheduler::IsScheduled(const Agent* agent) const
+{
+   int slot = agent->GetTurnSlot();
+   return (slot >= 0 && slot < (int)m_heap.size() && m_heap[slot].agent == agent);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC bool TurnScheduler::IsEarlier(const ScheduledTurn& first, const ScheduledTurn& second)
+{
+   if (first.turnTime != second.turnTime)
+   {
+      return (first.turnTime < second.turnTime);
+   }
+
+   return (first.sequence < second.sequence);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void TurnScheduler::PlaceAtSlot(const ScheduledTurn& turn, int slot)
+{
+   m_heap[slot] = turn;
+   turn.agent->SetTurnSlot(slot);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void TurnScheduler::SiftUp(int slot)
+{
+   ScheduledTurn turn = m_heap[slot];
+   while (slot > 0)
+   {
+      int parentSlot = (slot - 1) / 2;
+      if (!IsEarlier(turn, m_heap[parentSlot]))
+      {
+         break;
+      }
+
+      PlaceAtSlot(m_heap[parentSlot], slot);
+      slot = parentSlot;
+   }
+
+   PlaceAtSlot(turn, slot);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void TurnScheduler::SiftDown(int slot)
+{
+   const int numSlots = (int)m_heap.size();
+   ScheduledTurn turn = m_heap[slot];
+   while (true)
+   {
+      int earliestChildSlot = (2 * slot) + 1;
+      if (earliestChildSlot >= numSlots)
+      {
+         break;
+      }
+
+      int rightChildSlot = earliestChildSlot + 1;
+      if (rightChildSlot < numSlots && IsEarlier(m_heap[rightChildSlot], m_heap[earliestChildSlot]))
+      {
+         earliestChildSlot = rightChildSlot;
+      }
+
+      if (!IsEarlier(m_heap[earliestChildSlot], turn))
+      {
+         break;
+      }
+
+      PlaceAtSlot(m_heap[earliestChildSlot], slot);
+      slot = earliestChildSlot;
+   }
+
+   PlaceAtSlot(turn, slot);
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+
+
+//-----------------------------------------------------------------------------------------------
+class Agent;
+
+
+//-----------------------------------------------------------------------------------------------
+// Agents ordered by the time of their next turn. Ties go to whoever was scheduled first, the same
+// order a multimap gives equal keys. A binary heap whose agents know their own slot, so
+// rescheduling and removal are O(log n) and a turn never allocates once the heap has grown
+class TurnScheduler
+{
+public:
+   TurnScheduler();
+
+   void Schedule(Agent* agent, float turnTime);
+   void Reschedule(Agent* agent, float turnTime);
+   bool Remove(Agent* agent);
+   void Clear();
+   void Reserve(int numAgents) { m_heap.reserve(numAgents); }
+
+   bool IsEmpty() const { return m_heap.empty(); }
+   bool IsScheduled(const Agent* agent) const;
+   Agent* GetNextAgent() const { return m_heap.front().agent; }
+   float GetNextTurnTime() const { return m_heap.front().turnTime; }
+   int GetNumberOfScheduledAgents() const { return (int)m_heap.size(); }
+
+   // Heap order, not turn order. Only for visiting every scheduled agent
+   Agent* GetScheduledAgentAtSlot(int slot) const { return m_heap[slot].agent; }
+
+private:
+   TurnScheduler(const TurnScheduler&);
+   TurnScheduler& operator=(const TurnScheduler&);
+
+   struct ScheduledTurn
+   {
+      float turnTime;
+      unsigned long long sequence;
+      Agent* agent;
+   };
+
+   static bool IsEarlier(const ScheduledTurn& first, const ScheduledTurn& second);
+   void PlaceAtSlot(const ScheduledTurn& turn, int slot);
+   void SiftUp(int slot);
+   void SiftDown(int slot);
+
+   std::vector<ScheduledTurn> m_heap;
+   unsigned long long m_nextSequence;
+};
\ No newline at end of file
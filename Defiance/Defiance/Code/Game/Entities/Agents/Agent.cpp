@@ -1,3 +1,5 @@
+#include <stdio.h>
+#include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Parsers/XMLUtilities.hpp"
 #include "Engine/Debug/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
@@ -7,6 +9,7 @@
 #include "Game/Map/Map.hpp"
 #include "Game/Entities/Agents/Player.hpp"
 #include "Game/Entities/Agents/Agent.hpp"
+#include "Game/Entities/EntityRegistry.hpp"
 #include "Game/Entities/Items/Item.hpp"
 #include "Game/Entities/Agents/Behaviors/Behavior.hpp"
 #include "Game/Entities/Features/Feature.hpp"
@@ -15,10 +18,18 @@
 #include "Game/UI/GameMessageBox.hpp"
 
 
+//-----------------------------------------------------------------------------------------------
+STATIC const int Agent::REDUCED_DETAIL_TURNS_PER_FOV_UPDATE = 4;
+
+
 //-----------------------------------------------------------------------------------------------
 Agent::Agent()
    : Entity()
    , m_glyph(' ')
+   , m_turnSlot(-1)
+   , m_chosenBehavior(nullptr)
+   , m_detailLevel(FULL_DETAIL)
+   , m_turnsSinceFOVUpdate(REDUCED_DETAIL_TURNS_PER_FOV_UPDATE)
 {
    InitEquipment();
 }
@@ -28,6 +39,10 @@ Agent::Agent()
 Agent::Agent(const XMLNode& blueprintNode)
    : Entity(blueprintNode)
    , m_glyph(' ')
+   , m_turnSlot(-1)
+   , m_chosenBehavior(nullptr)
+   , m_detailLevel(FULL_DETAIL)
+   , m_turnsSinceFOVUpdate(REDUCED_DETAIL_TURNS_PER_FOV_UPDATE)
 {
    InitEquipment();
    PopulateFromXMLNode(blueprintNode);
@@ -37,9 +52,13 @@ Agent::Agent(const XMLNode& blueprintNode)
 //-----------------------------------------------------------------------------------------------
 Agent::Agent(const Agent& copySource)
    : Entity(copySource)
-   , m_faction(copySource.m_faction)
+   , m_relations(copySource.m_relations)
    , m_inventory(copySource.m_inventory)
    , m_glyph(copySource.m_glyph)
+   , m_turnSlot(-1)
+   , m_chosenBehavior(nullptr)
+   , m_detailLevel(FULL_DETAIL)
+   , m_turnsSinceFOVUpdate(REDUCED_DETAIL_TURNS_PER_FOV_UPDATE)
 {
    for (size_t slot = 0; slot < NUM_EQUIPMENT_SLOTS; ++slot)
    {
@@ -59,6 +78,10 @@ Agent::Agent(const Agent& copySource)
 Agent::Agent(int health, EntityType type, const TileCoords& position, char glyph, const Rgba& color, const Rgba& backgroundColor, const std::string& name)
    :Entity(health, type, position, color, backgroundColor, name)
    , m_glyph(glyph)
+   , m_turnSlot(-1)
+   , m_chosenBehavior(nullptr)
+   , m_detailLevel(FULL_DETAIL)
+   , m_turnsSinceFOVUpdate(REDUCED_DETAIL_TURNS_PER_FOV_UPDATE)
 {
    InitEquipment();
 }
@@ -89,7 +112,7 @@ void Agent::PopulateFromXMLNode(const XMLNode& blueprintNode)
    std::string factionName = ReadXMLAttribute(blueprintNode, "faction", std::string(""));
    if (factionName.compare(""))
    {
-      m_faction = *(Faction::CreateOrGetFactionByName(factionName));
+      m_relations.SetFactionID(Faction::CreateOrGetFactionByName(factionName)->GetFactionID());
    }
 
    XMLNode factionNode = blueprintNode.getChildNode("Faction");
@@ -113,8 +136,8 @@ void Agent::PopulateFactionFromXMLNode(const XMLNode& factionNode)
       return;
    }
 
-   m_faction = *(Faction::CreateOrGetFactionByName(factionName));
-   m_faction.PopulateFromXMLNode(factionNode);
+   m_relations.SetFactionID(Faction::CreateOrGetFactionByName(factionName)->GetFactionID());
+   m_relations.PopulateFromXMLNode(factionNode);
 }
 
 
@@ -131,9 +154,42 @@ void Agent::InitEquipment()
 //-----------------------------------------------------------------------------------------------
 float Agent::Update()
 {
-   UpdateFOV();
+   Decide();
+   return Act();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Sees, scores every behavior and plans the winner. Only this agent and its behaviors change, so
+// every agent due this turn can decide at once against the same world. TheGame runs the same
+// steps for a whole turn's agents at a time, scoring them together in a UtilityScoringBatch
+void Agent::Decide()
+{
+   Perceive();
+   ChooseBehavior();
+   PlanChosenBehavior();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Agent::Perceive()
+{
+   ++m_turnsSinceFOVUpdate;
+   if (m_detailLevel == FULL_DETAIL || m_turnsSinceFOVUpdate >= REDUCED_DETAIL_TURNS_PER_FOV_UPDATE)
+   {
+      UpdateFOV();
+      m_turnsSinceFOVUpdate = 0;
+   }
+
+   // Standings can change between FOV updates, so the summary is redone every decision
+   UpdatePerceptionSummary();
+}
 
-   Behavior* behaviorToRun = nullptr;
+
+//-----------------------------------------------------------------------------------------------
+void Agent::ChooseBehavior()
+{
+   m_chosenBehavior = nullptr;
    float currentBehaviorUtility = 0.f;
 
    for (Behavior* behavior : m_behaviors)
@@ -141,14 +197,32 @@ float Agent::Update()
       float thisBehaviorUtility = behavior->CalcUtility();
       if (thisBehaviorUtility > currentBehaviorUtility)
       {
-         behaviorToRun = behavior;
+         m_chosenBehavior = behavior;
          currentBehaviorUtility = thisBehaviorUtility;
       }
    }
+}
+
 
-   if (behaviorToRun != nullptr)
+//-----------------------------------------------------------------------------------------------
+void Agent::PlanChosenBehavior()
+{
+   if (m_chosenBehavior != nullptr)
    {
-      behaviorToRun->Run();
+      m_chosenBehavior->Plan();
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Applies what Decide chose. Agents that acted earlier this turn may have changed things since, so
+// behaviors re-check their targets and refuse moves that are no longer possible
+float Agent::Act()
+{
+   if (m_chosenBehavior != nullptr)
+   {
+      m_chosenBehavior->Run();
+      m_chosenBehavior = nullptr;
    }
 
    //#TODO
@@ -168,51 +242,15 @@ void Agent::UpdateFOV()
 
 
 //-----------------------------------------------------------------------------------------------
-void Agent::DereferenceEntity(Entity* entity)
+// What the agent saw while it had less detail is stale, so it looks again before deciding
+void Agent::SetDetailLevel(AgentDetailLevel detailLevel)
 {
-   if (entity->IsAgent())
+   if (detailLevel < m_detailLevel)
    {
-      m_faction.RemoveAgentRelationship(entity->GetID());
-
-      for (DistanceToAgentIter agentIter = m_visibleAgents.begin(); agentIter != m_visibleAgents.end(); ++agentIter)
-      {
-         if (entity == agentIter->second)
-         {
-            m_visibleAgents.erase(agentIter);
-            break;
-         }
-      }
+      m_turnsSinceFOVUpdate = REDUCED_DETAIL_TURNS_PER_FOV_UPDATE;
    }
-   else if (entity->IsItem())
-   {
-      for (DistanceToItemIter itemIter = m_visibleItems.begin(); itemIter != m_visibleItems.end(); ++itemIter)
-      {
-         if (entity == itemIter->second)
-         {
-            m_visibleItems.erase(itemIter);
-            break;
-         }
-      }
-
-      m_inventory.DereferenceItem(entity);
-   }
-   else  //(entity->IsFeature())
-   {
-      for (DistanceToFeatureIter featureIter = m_visibleFeatures.begin(); featureIter != m_visibleFeatures.end(); ++featureIter)
-      {
-         if (entity == featureIter->second)
-         {
-            m_visibleFeatures.erase(featureIter);
-            break;
-         }
-      }
-   }
-
 
-   for (Behavior* behavior : m_behaviors)
-   {
-      behavior->DereferenceEntity(entity);
-   }
+   m_detailLevel = detailLevel;
 }
 
 
@@ -247,7 +285,10 @@ bool Agent::MoveOneStepInDirection(TileDirection direction)
    if (IsPlayer())
    {
       const Tile* newTile = m_gameMap->GetTileAtTileCoords(newPosition);
-      newTile->PrintItemInfo();
+      for (const Item* item : newTile->GetItems())
+      {
+         g_theGameMessageBox->PrintNeutralMessage(Stringf("You find a %s here.", item->GetName().c_str()));
+      }
    }
 
    return true;
@@ -298,7 +339,7 @@ bool Agent::TryGetItemFromCurrentTile()
          if (player != nullptr
             && player->IsAgentVisible(this))
          {
-            g_theGameMessageBox->PrintNeutralMessage(Stringf("The %s picks up a %s.", m_name.c_str(), firstItemOnTile->GetName().c_str()));
+            g_theGameMessageBox->PrintNeutralMessage(Stringf("The %s picks up a %s.", m_name->c_str(), firstItemOnTile->GetName().c_str()));
          }
       }
    }
@@ -335,7 +376,7 @@ bool Agent::TryEquipNewItem(Item* newItem)
          if (player != nullptr
             && player->IsAgentVisible(this))
          {
-            g_theGameMessageBox->PrintCautionMessage(Stringf("The %s equips a %s!", m_name.c_str(), newItem->GetName().c_str()));
+            g_theGameMessageBox->PrintCautionMessage(Stringf("The %s equips a %s!", m_name->c_str(), newItem->GetName().c_str()));
          }
       }
       return didEquipItem;
@@ -351,8 +392,7 @@ bool Agent::TryEquipNewItem(Item* newItem)
 
       if (m_inventory.IsInventoryFull())
       {
-         Tile* currentTile = m_gameMap->GetTileAtTileCoords(m_position);
-         currentTile->inventory.AddItem(oldItemInSlot);
+         oldItemInSlot->AddToMap(m_gameMap, m_position);
          oldItemInSlot->SetDown();
 
          if (IsPlayer())
@@ -366,7 +406,7 @@ bool Agent::TryEquipNewItem(Item* newItem)
             if (player != nullptr
                && player->IsAgentVisible(this))
             {
-               g_theGameMessageBox->PrintCautionMessage(Stringf("The %s equips a %s, dropping a %s!", m_name.c_str(), newItem->GetName().c_str(), oldItemInSlot->GetName().c_str()));
+               g_theGameMessageBox->PrintCautionMessage(Stringf("The %s equips a %s, dropping a %s!", m_name->c_str(), newItem->GetName().c_str(), oldItemInSlot->GetName().c_str()));
             }
          }
          return didEquipItem;
@@ -385,7 +425,7 @@ bool Agent::TryEquipNewItem(Item* newItem)
          if (player != nullptr
             && player->IsAgentVisible(this))
          {
-            g_theGameMessageBox->PrintCautionMessage(Stringf("The %s equips a %s!", m_name.c_str(), newItem->GetName().c_str()));
+            g_theGameMessageBox->PrintCautionMessage(Stringf("The %s equips a %s!", m_name->c_str(), newItem->GetName().c_str()));
          }
       }
 
@@ -441,47 +481,20 @@ void Agent::MoveToPosition(const TileCoords& position)
 {
    Tile* tileToOccupy = m_gameMap->GetTileAtTileCoords(position);
    ASSERT_OR_DIE(!tileToOccupy->IsOccupiedByAgent(),
-      Stringf("Defiance ERROR: Tried to add entity %s with id %d to position %f,%f; position is occupied!", m_name.c_str(), m_ID, position.x, position.y));
+      Stringf("Defiance ERROR: Tried to add entity %s with id %d to position %f,%f; position is occupied!", m_name->c_str(), m_ID, position.x, position.y));
 
-   Tile* currentTile = m_gameMap->GetTileAtTileCoords(m_position);
-   currentTile->RemoveAgent();
+   m_gameMap->RemoveAgent(m_position);
 
    m_position = position;
-   tileToOccupy->occupyingAgent = this;
+   m_gameMap->AddAgent(this, position);
+   m_gameMap->GetEntityGrid()->MoveEntity(this, position);
 }
 
 
 //-----------------------------------------------------------------------------------------------
 void Agent::AddVisibleAgent(float distanceToTile, Agent* agent)
 {
-   m_visibleAgents.insert(DistanceToAgentPair(distanceToTile, agent));
-
-   if (HasNeverMetAgent(agent->m_ID))
-   {
-      FactionID agentFactionID = agent->m_faction.GetFactionID();
-      if (HasNeverMetFaction(agentFactionID))
-      {
-         std::string factionName = agent->m_faction.GetName();
-         m_faction.AddFactionRelation(agentFactionID, factionName, FACTION_STATUS_NEUTRAL);
-      }
-
-      int factionStanding = m_faction.GetFactionStandingWithFaction(agentFactionID);
-      m_faction.AddAgentRelation(agent->m_ID, agent->m_name, factionStanding);
-   }
-}
-
-
-//-----------------------------------------------------------------------------------------------
-bool Agent::HasNeverMetAgent(EntityID agentID) const
-{
-   return !m_faction.IsAgentRelationPresent(agentID);
-}
-
-
-//-----------------------------------------------------------------------------------------------
-bool Agent::HasNeverMetFaction(FactionID factionID) const
-{
-   return !m_faction.IsFactionRelationPresent(factionID);
+   m_visibleAgents.insert(DistanceToAgentPair(distanceToTile, agent->GetHandle()));
 }
 
 
@@ -497,7 +510,7 @@ bool Agent::IsAgentVisible(Agent* agent) const
 
    for (DistanceToAgentConstIter agentIter = m_visibleAgents.begin(); agentIter != m_visibleAgents.end(); ++agentIter)
    {
-      if (agent == agentIter->second)
+      if (agent->GetHandle() == agentIter->second)
       {
          return agentIsVisible;
       }
@@ -512,7 +525,7 @@ void Agent::AddVisibleItems(float distanceToTile, const Items& items)
 {
    for (Item* item : items)
    {
-      m_visibleItems.insert(DistanceToItemPair(distanceToTile, item));
+      m_visibleItems.insert(DistanceToItemPair(distanceToTile, item->GetHandle()));
    }
 }
 
@@ -520,59 +533,105 @@ void Agent::AddVisibleItems(float distanceToTile, const Items& items)
 //-----------------------------------------------------------------------------------------------
 void Agent::AddVisibleFeature(float distanceToTile, Feature* feature)
 {
-   m_visibleFeatures.insert(DistanceToFeaturePair(distanceToTile, feature));
+   m_visibleFeatures.insert(DistanceToFeaturePair(distanceToTile, feature->GetHandle()));
 }
 
 
 //-----------------------------------------------------------------------------------------------
-Agent* Agent::GetClosestEnemy()
+// One pass over everything seen, with one standing lookup per agent
+void Agent::UpdatePerceptionSummary()
 {
-   for (DistanceToAgentIter agentIter = m_visibleAgents.begin(); agentIter != m_visibleAgents.end(); ++agentIter)
+   m_perception = PerceptionSummary();
+
+   for (DistanceToAgentConstIter agentIter = m_visibleAgents.begin(); agentIter != m_visibleAgents.end(); ++agentIter)
    {
-      Agent* currentAgent = agentIter->second;
-      EntityID agentID = currentAgent->m_ID;
+      // Agents slain since the last FOV update resolve to nullptr
+      Agent* currentAgent = (Agent*)EntityRegistry::Resolve(agentIter->second);
+      if (currentAgent == nullptr)
+      {
+         continue;
+      }
 
-      int factionStandingWithAgent = m_faction.GetFactionStandingWithAgent(agentID);
+      int factionStandingWithAgent = m_relations.GetStandingWithAgent(currentAgent->m_ID, currentAgent->GetFactionID());
       if (factionStandingWithAgent <= FACTION_STATUS_DISLIKES)
       {
-         return currentAgent;
+         if (m_perception.numVisibleEnemies == 0)
+         {
+            m_perception.closestEnemy = agentIter->second;
+            m_perception.distanceToClosestEnemy = agentIter->first;
+         }
+         ++m_perception.numVisibleEnemies;
+      }
+      else if (factionStandingWithAgent >= FACTION_STATUS_LIKES)
+      {
+         if (m_perception.numVisibleAllies == 0)
+         {
+            m_perception.closestAlly = agentIter->second;
+            m_perception.distanceToClosestAlly = agentIter->first;
+         }
+         ++m_perception.numVisibleAllies;
       }
    }
 
-   // No enemies found
-   return nullptr;
+   for (DistanceToItemIter itemIter = m_visibleItems.begin(); itemIter != m_visibleItems.end(); ++itemIter)
+   {
+      if (EntityRegistry::Resolve(itemIter->second) == nullptr)
+      {
+         continue;
+      }
+
+      if (m_perception.numVisibleItems == 0)
+      {
+         m_perception.closestItem = itemIter->second;
+         m_perception.distanceToClosestItem = itemIter->first;
+      }
+      ++m_perception.numVisibleItems;
+   }
 }
 
 
 //-----------------------------------------------------------------------------------------------
-Agent* Agent::GetClosestAlly()
+// Comes from the perception summary. If that enemy has died since, the next closest is looked up
+Agent* Agent::GetClosestEnemy()
 {
-   for (DistanceToAgentIter agentIter = m_visibleAgents.begin(); agentIter != m_visibleAgents.end(); ++agentIter)
+   Agent* closestEnemy = (Agent*)EntityRegistry::Resolve(m_perception.closestEnemy);
+   if (closestEnemy != nullptr || m_perception.numVisibleEnemies <= 1)
    {
-      Agent* currentAgent = agentIter->second;
-      EntityID agentID = currentAgent->m_ID;
+      return closestEnemy;
+   }
 
-      int factionStandingWithAgent = m_faction.GetFactionStandingWithAgent(agentID);
-      if (factionStandingWithAgent >= FACTION_STATUS_LIKES)
-      {
-         return currentAgent;
-      }
+   UpdatePerceptionSummary();
+   return (Agent*)EntityRegistry::Resolve(m_perception.closestEnemy);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Comes from the perception summary. If that ally has died since, the next closest is looked up
+Agent* Agent::GetClosestAlly()
+{
+   Agent* closestAlly = (Agent*)EntityRegistry::Resolve(m_perception.closestAlly);
+   if (closestAlly != nullptr || m_perception.numVisibleAllies <= 1)
+   {
+      return closestAlly;
    }
 
-   // No allies found
-   return nullptr;
+   UpdatePerceptionSummary();
+   return (Agent*)EntityRegistry::Resolve(m_perception.closestAlly);
 }
 
 
 //-----------------------------------------------------------------------------------------------
+// Comes from the perception summary. If that item is gone, the next closest is looked up
 Item* Agent::GetClosestVisibleItem()
 {
-   if (m_visibleItems.size() == 0)
+   Item* closestItem = (Item*)EntityRegistry::Resolve(m_perception.closestItem);
+   if (closestItem != nullptr || m_perception.numVisibleItems <= 1)
    {
-      return nullptr;
+      return closestItem;
    }
 
-   return m_visibleItems.begin()->second;
+   UpdatePerceptionSummary();
+   return (Item*)EntityRegistry::Resolve(m_perception.closestItem);
 }
 
 
@@ -619,7 +678,7 @@ void Agent::ReceiveAttack(const AttackData& attackData)
 //-----------------------------------------------------------------------------------------------
 void Agent::AdjustFactionStatus(Agent* instigator, FactionAction action)
 {
-   m_faction.AdjustFactionStatus(instigator, action);
+   m_relations.AdjustStanding(instigator, action);
 }
 
 
@@ -633,7 +692,7 @@ bool Agent::WriteToXMLNode(XMLNode& entityNode) const
       return !writeSuccessful;
    }
 
-   m_faction.WriteToXMLNode(entityNode);
+   m_relations.WriteToXMLNode(entityNode);
    m_inventory.WriteToXMLNode(entityNode);
    WriteEquipmentToXMLNode(entityNode);
    WriteBehaviorsToXMLNode(entityNode);
@@ -653,7 +712,7 @@ void Agent::WriteEquipmentToXMLNode(XMLNode& entityNode) const
          Item* equippedItem = m_equippedItems[slotIndex];
 
          char spareBuf[255];
-         _itoa_s(equippedItem->GetID(), spareBuf, 10);
+         snprintf(spareBuf, sizeof(spareBuf), "%d", equippedItem->GetID());
 
          XMLNode slotNode = equipmentNode.addChild("EquipmentSlot");
          slotNode.addAttribute("slot", Item::GetStringForSlot((EquipmentSlot)slotIndex).c_str());
@@ -680,7 +739,7 @@ void Agent::LoadFromXMLNode(const XMLNode& saveNode)
 {
    Entity::LoadFromXMLNode(saveNode);
 
-   m_faction.LoadFromXMLNode(saveNode);
+   m_relations.LoadFromXMLNode(saveNode);
 
    // load all behaviors
 
@@ -704,7 +763,7 @@ void Agent::LoadEquippedItemsFromXMLNode(const XMLNode& saveNode)
       EquipmentSlot slot = Item::GetSlotForString(slotAsString);
 
       int tempID = ReadXMLAttribute(slotNode, "id", 0);
-      m_equippedItems[slot] = (Item*)tempID;
+      m_equippedItems[slot] = (Item*)(size_t)tempID;
 
       slotNode = equipmentNode.getChildNode("EquipmentSlot", &slotIndex);
    }
@@ -715,7 +774,7 @@ void Agent::LoadEquippedItemsFromXMLNode(const XMLNode& saveNode)
 void Agent::ResolveEntityPointers(const std::map<int, Entity*>& loadedEntities)
 {
    // behaviors
-   // faction
+   m_relations.ResolveEntityPointers(loadedEntities);
    ResolveEquipmentPointers(loadedEntities);
    m_inventory.ResolveEntityPointers(loadedEntities);
 }
@@ -728,7 +787,7 @@ void Agent::ResolveEquipmentPointers(const std::map<int, Entity*>& loadedEntitie
    {
       if (m_equippedItems[slotIndex] != nullptr)
       {
-         int oldID = (int)m_equippedItems[slotIndex];
+         int oldID = (int)(size_t)m_equippedItems[slotIndex];
          m_equippedItems[slotIndex] = (Item*)loadedEntities.at(oldID);
       }
    }
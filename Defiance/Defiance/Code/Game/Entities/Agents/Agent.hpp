@@ -4,7 +4,7 @@
 #include <map>
 #include "Game/Core/GameCommon.hpp"
 #include "Game/Entities/Entity.hpp"
-#include "Game/Entities/Agents/Factions/Faction.hpp"
+#include "Game/Entities/Agents/Factions/AgentRelations.hpp"
 #include "Game/Entities/Items/Inventory.hpp"
 
 
@@ -14,6 +14,25 @@ struct AttackData;
 class Behavior;
 
 
+//-----------------------------------------------------------------------------------------------
+// What an agent made of its FOV this turn, worked out once so every behavior can share it.
+// Distances are as of the FOV update
+struct PerceptionSummary
+{
+   PerceptionSummary() : distanceToClosestEnemy(0.f), distanceToClosestAlly(0.f), distanceToClosestItem(0.f), numVisibleEnemies(0), numVisibleAllies(0), numVisibleItems(0) {}
+
+   EntityHandle closestEnemy;
+   EntityHandle closestAlly;
+   EntityHandle closestItem;
+   float distanceToClosestEnemy;
+   float distanceToClosestAlly;
+   float distanceToClosestItem;
+   int numVisibleEnemies;
+   int numVisibleAllies;
+   int numVisibleItems;
+};
+
+
 //-----------------------------------------------------------------------------------------------
 class Agent
    : public Entity
@@ -34,7 +53,14 @@ public:
    virtual bool IsAgent() const override { return true; }
    virtual float Update();
    virtual void UpdateFOV();
-   virtual void DereferenceEntity(Entity* entity) override;
+   void Decide();
+   void Perceive();
+   void ChooseBehavior();
+   void PlanChosenBehavior();
+   float Act();
+
+   const std::vector<Behavior*>& GetBehaviors() const { return m_behaviors; }
+   void SetChosenBehavior(Behavior* behavior) { m_chosenBehavior = behavior; }
 
    char GetGlyph() const { return m_glyph; }
 
@@ -50,15 +76,24 @@ public:
    virtual void AddToMap(Map* map, const TileCoords& position) override;
    void MoveToPosition(const TileCoords& position);
    void AddVisibleAgent(float distanceToTile, Agent* agent);
-   bool HasNeverMetAgent(EntityID agentID) const;
-   bool HasNeverMetFaction(FactionID factionID) const;
    bool IsAgentVisible(Agent* agent) const;
 
    void AddVisibleItems(float distanceToTile, const Items& items);
    void AddVisibleFeature(float distanceToTile, Feature* feature);
 
-   FactionID GetFactionID() const { return m_faction.GetFactionID(); }
+   FactionID GetFactionID() const { return m_relations.GetFactionID(); }
+   const AgentRelations& GetRelations() const { return m_relations; }
+
+   // Reduced detail agents only refresh their FOV every few turns. Gaining detail refreshes it on the next decision
+   AgentDetailLevel GetDetailLevel() const { return m_detailLevel; }
+   void SetDetailLevel(AgentDetailLevel detailLevel);
 
+   // Slot in the turn scheduler's heap, -1 when no turn is scheduled. Only the scheduler sets it
+   int GetTurnSlot() const { return m_turnSlot; }
+   void SetTurnSlot(int turnSlot) { m_turnSlot = turnSlot; }
+
+   void UpdatePerceptionSummary();
+   const PerceptionSummary& GetPerceptionSummary() const { return m_perception; }
    Agent* GetClosestEnemy();
    Agent* GetClosestAlly();
    Item* GetClosestVisibleItem();
@@ -77,13 +112,20 @@ public:
    virtual void ResolveEntityPointers(const std::map<int, Entity*>& loadedEntities) override;
    void ResolveEquipmentPointers(const std::map<int, Entity*>& loadedEntities);
 
+   static const int REDUCED_DETAIL_TURNS_PER_FOV_UPDATE;
+
 protected:
-   Faction m_faction;
+   AgentRelations m_relations;
    std::vector<Behavior*> m_behaviors;
    DistanceToAgentMap m_visibleAgents;
    DistanceToItemMap m_visibleItems;
    DistanceToFeatureMap m_visibleFeatures;
+   PerceptionSummary m_perception;
    Inventory m_inventory;
    Item* m_equippedItems[NUM_EQUIPMENT_SLOTS];
    char m_glyph;
+   int m_turnSlot;
+   Behavior* m_chosenBehavior;
+   AgentDetailLevel m_detailLevel;
+   int m_turnsSinceFOVUpdate;
 };
\ No newline at end of file
@@ -10,26 +10,46 @@ STATIC BehaviorRegistrationMap* BehaviorRegistration::s_behaviorRegistrationMap
 
 
 //-----------------------------------------------------------------------------------------------
-Behavior::Behavior(const std::string& name, const XMLNode& blueprintNode)
-   : m_name(name)
-   , m_chanceToRun(1.f)
+BehaviorBlueprint::BehaviorBlueprint(const std::string& behaviorName, const XMLNode& blueprintNode)
+   : name(behaviorName)
+   , chanceToRun(1.f)
+{
+   chanceToRun = ReadXMLAttribute(blueprintNode, "chanceToRun", chanceToRun);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+Behavior::Behavior(BehaviorBlueprint* blueprint)
+   : m_owningAgent(nullptr)
+   , m_blueprint(blueprint)
+   , m_ownsBlueprint(true)
 {
-   m_chanceToRun = ReadXMLAttribute(blueprintNode, "chanceToRun", m_chanceToRun);
 }
 
 
 //-----------------------------------------------------------------------------------------------
 Behavior::Behavior(const Behavior& copySource)
-   : m_name(copySource.m_name)
-   , m_chanceToRun(copySource.m_chanceToRun)
+   : m_owningAgent(nullptr)
+   , m_blueprint(copySource.m_blueprint)
+   , m_ownsBlueprint(false)
 {
 }
 
 
+//-----------------------------------------------------------------------------------------------
+Behavior::~Behavior()
+{
+   if (m_ownsBlueprint)
+   {
+      delete m_blueprint;
+   }
+}
+
+
 //-----------------------------------------------------------------------------------------------
 void Behavior::WriteToXMLNode(XMLNode& topNode) const
 {
-   XMLNode behaviorNode = topNode.addChild(m_name.c_str());
+   XMLNode behaviorNode = topNode.addChild(m_blueprint->name.c_str());
 }
 
 
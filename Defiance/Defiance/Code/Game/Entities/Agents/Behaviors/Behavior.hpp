@@ -2,6 +2,7 @@
 
 #include <string>
 #include <map>
+#include "Game/Entities/Agents/Behaviors/UtilityScoringBatch.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
@@ -10,22 +11,44 @@ class Agent;
 class Entity;
 
 
-//----------------------------------------------------------------------------------------------_
+//-----------------------------------------------------------------------------------------------
+// Tuning shared by every instance of a behavior on one NPC blueprint. Read-only once loaded; each
+// behavior type extends it with its own parameters
+struct BehaviorBlueprint
+{
+   BehaviorBlueprint(const std::string& behaviorName, const XMLNode& blueprintNode);
+   virtual ~BehaviorBlueprint() {}
+
+   std::string name;
+   float chanceToRun;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Behaviors made from XML own their blueprint. Clones point at it and hold only what changes from
+// turn to turn, so the NPC blueprint has to outlive every NPC spawned from it
 class Behavior
 {
 public:
-   Behavior(const std::string& name, const XMLNode& behaviorNode);
+   explicit Behavior(BehaviorBlueprint* blueprint);
    Behavior(const Behavior& copySource);
-   virtual ~Behavior() {}
+   virtual ~Behavior();
 
    virtual float CalcUtility() = 0;
    virtual void Run() = 0;
+
+   // Called on the chosen behavior before Run, possibly on a worker thread alongside other agents'
+   // behaviors. Do the expensive thinking here; change nothing outside this behavior
+   virtual void Plan() {}
    virtual Behavior* Clone() = 0;
-   virtual void PopulateFromXMLNode(const XMLNode& blueprintNode) = 0;
    virtual bool DoesPassChanceToRun() { return false; }
-   virtual void DereferenceEntity(Entity*) {}
 
-   const std::string& GetName() const { return m_name; }
+   // Behaviors with a kernel are scored a whole batch at a time (see UtilityScoringBatch). The
+   // kernel and CalcUtility have to agree for the same inputs
+   virtual UtilityScoringKernel* GetScoringKernel() const { return nullptr; }
+   virtual float GetScoringParameter() const { return 0.f; }
+
+   const std::string& GetName() const { return m_blueprint->name; }
    void SetOwningAgent(Agent* agent) { m_owningAgent = agent; }
 
    // coincidentally, I never included functionality that required this...
@@ -33,8 +56,11 @@ public:
 
 protected:
    Agent* m_owningAgent;
-   std::string m_name;
-   float m_chanceToRun;
+   const BehaviorBlueprint* m_blueprint;
+   bool m_ownsBlueprint;
+
+private:
+   Behavior& operator=(const Behavior&);
 };
 
 
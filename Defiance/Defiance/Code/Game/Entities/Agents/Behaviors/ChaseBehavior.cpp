@@ -3,6 +3,7 @@
 #include "Game/Pathfinding/PathfinderAStar.hpp"
 #include "Game/Entities/Agents/Behaviors/ChaseBehavior.hpp"
 #include "Game/Entities/Agents/Agent.hpp"
+#include "Game/Entities/EntityRegistry.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
@@ -10,37 +11,58 @@ STATIC BehaviorRegistration ChaseBehavior::s_chaseBehaviorRegistration("Chase",
 
 
 //-----------------------------------------------------------------------------------------------
-ChaseBehavior::ChaseBehavior(const std::string& name, const XMLNode& blueprintNode)
-   : Behavior(name, blueprintNode)
-   , m_tilesFromStartToChase(15)
-   , m_turnsToChase(15)
-   , m_chaseTarget(nullptr)
+ChaseBehaviorBlueprint::ChaseBehaviorBlueprint(const std::string& behaviorName, const XMLNode& blueprintNode)
+   : BehaviorBlueprint(behaviorName, blueprintNode)
+   , tilesFromStartToChase(15)
+   , turnsToChase(15)
 {
    PopulateFromXMLNode(blueprintNode);
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void ChaseBehaviorBlueprint::PopulateFromXMLNode(const XMLNode& blueprintNode)
+{
+   tilesFromStartToChase = ReadXMLAttribute(blueprintNode, "tilesFromStartToChase", tilesFromStartToChase);
+   turnsToChase = ReadXMLAttribute(blueprintNode, "turnsToChase", turnsToChase);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+ChaseBehavior::ChaseBehavior(const std::string& name, const XMLNode& blueprintNode)
+   : Behavior(new ChaseBehaviorBlueprint(name, blueprintNode))
+   , m_chaseTarget()
+   , m_plannedDirection(INVALID_DIRECTION)
+{
+}
+
+
 //-----------------------------------------------------------------------------------------------
 ChaseBehavior::ChaseBehavior(const ChaseBehavior& copySource)
    : Behavior(copySource)
-   , m_tilesFromStartToChase(copySource.m_tilesFromStartToChase)
-   , m_turnsToChase(copySource.m_turnsToChase)
    , m_chaseTarget(copySource.m_chaseTarget)
+   , m_plannedDirection(INVALID_DIRECTION)
 {}
 
 
 //-----------------------------------------------------------------------------------------------
 float ChaseBehavior::CalcUtility()
 {
-   m_chaseTarget = m_owningAgent->GetClosestEnemy();
-   if (m_chaseTarget == nullptr)
+   Agent* chaseTarget = m_owningAgent->GetClosestEnemy();
+   if (chaseTarget == nullptr)
    {
-      return 0.f;
+      return ScoreUtility(false, 0);
    }
 
    TileCoords agentPos = m_owningAgent->GetPosition();
-   int tilesFromTarget = agentPos.GetManhattanDistanceToVector(m_chaseTarget->GetPosition());
-   if (tilesFromTarget <= 1)
+   return ScoreUtility(true, agentPos.GetManhattanDistanceToVector(chaseTarget->GetPosition()));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC float ChaseBehavior::ScoreUtility(bool hasEnemy, int tilesToEnemy)
+{
+   if (!hasEnemy || tilesToEnemy <= 1)
    {
       return 0.f;
    }
@@ -50,10 +72,31 @@ float ChaseBehavior::CalcUtility()
 
 
 //-----------------------------------------------------------------------------------------------
-void ChaseBehavior::Run()
+STATIC void ChaseBehavior::ScoreBatch(const UtilityInputs& inputs, UtilityScoringEntries& entries)
 {
+   const int numEntries = entries.GetNumberOfEntries();
+   for (int entryIndex = 0; entryIndex < numEntries; ++entryIndex)
+   {
+      int agentIndex = entries.agentIndices[entryIndex];
+      entries.utilities[entryIndex] = ScoreUtility(inputs.hasEnemy[agentIndex] != 0, inputs.tilesToEnemy[agentIndex]);
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void ChaseBehavior::Plan()
+{
+   m_plannedDirection = INVALID_DIRECTION;
+
+   Agent* chaseTarget = m_owningAgent->GetClosestEnemy();
+   m_chaseTarget = (chaseTarget != nullptr) ? chaseTarget->GetHandle() : EntityHandle();
+   if (chaseTarget == nullptr)
+   {
+      return;
+   }
+
    TileCoords myAgentPos = m_owningAgent->GetPosition();
-   TileCoords targetAgentPos = m_chaseTarget->GetPosition();
+   TileCoords targetAgentPos = chaseTarget->GetPosition();
 
    Map* gameMap = m_owningAgent->GetMap();
    PathfinderAStar pathfinder(myAgentPos, targetAgentPos, MapProxy(gameMap));
@@ -67,24 +110,31 @@ void ChaseBehavior::Run()
    }
 
    const Path& path = pathfinder.GetPath();
-   TileDirection directionToTarget = gameMap->GetDirectionFromSourceToDest(myAgentPos, path.GetStepTowardsPathEnd());
-   m_owningAgent->MoveOneStepInDirection(directionToTarget);
+   m_plannedDirection = gameMap->GetDirectionFromSourceToDest(myAgentPos, path.GetStepTowardsPathEnd());
 }
 
 
 //-----------------------------------------------------------------------------------------------
-Behavior* ChaseBehavior::Clone()
+// The step fails on its own if someone acting earlier this turn took the tile
+void ChaseBehavior::Run()
 {
-   Behavior* clone = new ChaseBehavior(*this);
-   return clone;
+   Agent* chaseTarget = (Agent*)EntityRegistry::Resolve(m_chaseTarget);
+   if (chaseTarget == nullptr
+      || !chaseTarget->IsAlive()
+      || m_plannedDirection == INVALID_DIRECTION)
+   {
+      return;
+   }
+
+   m_owningAgent->MoveOneStepInDirection(m_plannedDirection);
 }
 
 
 //-----------------------------------------------------------------------------------------------
-void ChaseBehavior::PopulateFromXMLNode(const XMLNode& blueprintNode)
+Behavior* ChaseBehavior::Clone()
 {
-   m_tilesFromStartToChase = ReadXMLAttribute(blueprintNode, "tilesFromStartToChase", m_tilesFromStartToChase);
-   m_turnsToChase = ReadXMLAttribute(blueprintNode, "turnsToChase", m_turnsToChase);
+   Behavior* clone = new ChaseBehavior(*this);
+   return clone;
 }
 
 
@@ -93,14 +143,4 @@ bool ChaseBehavior::DoesPassChanceToRun()
 {
    // #TODO
    return true;
-}
-
-
-//-----------------------------------------------------------------------------------------------
-void ChaseBehavior::DereferenceEntity(Entity* entity)
-{
-   if (m_chaseTarget == entity)
-   {
-      m_chaseTarget = nullptr;
-   }
 }
\ No newline at end of file
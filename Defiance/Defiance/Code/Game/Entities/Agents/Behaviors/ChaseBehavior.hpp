@@ -10,6 +10,18 @@ struct XMLNode;
 class Entity;
 
 
+//-----------------------------------------------------------------------------------------------
+struct ChaseBehaviorBlueprint
+   : public BehaviorBlueprint
+{
+   ChaseBehaviorBlueprint(const std::string& behaviorName, const XMLNode& blueprintNode);
+   void PopulateFromXMLNode(const XMLNode& blueprintNode);
+
+   int tilesFromStartToChase;
+   int turnsToChase;
+};
+
+
 //-----------------------------------------------------------------------------------------------
 class ChaseBehavior
    : public Behavior 
@@ -20,10 +32,13 @@ public:
 
    virtual float CalcUtility() override;
    virtual void Run() override;
+   virtual void Plan() override;
    virtual Behavior* Clone() override;
-   virtual void PopulateFromXMLNode(const XMLNode& blueprintNode);
    virtual bool DoesPassChanceToRun() override;
-   virtual void DereferenceEntity(Entity* entity) override;
+   virtual UtilityScoringKernel* GetScoringKernel() const override { return &ScoreBatch; }
+
+   static float ScoreUtility(bool hasEnemy, int tilesToEnemy);
+   static void ScoreBatch(const UtilityInputs& inputs, UtilityScoringEntries& entries);
 
    static Behavior* CreateBehavior(const std::string& name, const XMLNode& blueprintNode) { return new ChaseBehavior(name, blueprintNode); }
    static BehaviorRegistration s_chaseBehaviorRegistration;
@@ -31,7 +46,8 @@ public:
    virtual void WriteToXMLNode(XMLNode&) const override {};
 
 private:
-   int m_tilesFromStartToChase;
-   int m_turnsToChase;
-   Agent* m_chaseTarget;
+   const ChaseBehaviorBlueprint& GetBlueprint() const { return *(const ChaseBehaviorBlueprint*)m_blueprint; }
+
+   EntityHandle m_chaseTarget;
+   TileDirection m_plannedDirection;
 };
\ No newline at end of file
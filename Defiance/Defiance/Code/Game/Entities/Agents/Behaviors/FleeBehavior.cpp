@@ -1,7 +1,10 @@
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Parsers/XMLUtilities.hpp"
 #include "Game/Entities/Agents/Behaviors/FleeBehavior.hpp"
+#include "Game/Core/TheGame.hpp"
+#include "Game/Core/GameContext.hpp"
 #include "Game/Entities/Agents/Agent.hpp"
+#include "Game/Entities/Agents/Player.hpp"
 #include "Game/Map/Map.hpp"
 #include "Game/UI/GameMessageBox.hpp"
 
@@ -10,38 +13,65 @@
 STATIC BehaviorRegistration FleeBehavior::s_fleeBehaviorRegistration("Flee", &FleeBehavior::CreateBehavior);
 
 
+//-----------------------------------------------------------------------------------------------
+FleeBehaviorBlueprint::FleeBehaviorBlueprint(const std::string& behaviorName, const XMLNode& blueprintNode)
+   : BehaviorBlueprint(behaviorName, blueprintNode)
+   , healthThreshold(3)
+{
+   PopulateFromXMLNode(blueprintNode);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void FleeBehaviorBlueprint::PopulateFromXMLNode(const XMLNode& blueprintNode)
+{
+   healthThreshold = ReadXMLAttribute(blueprintNode, "healthThreshold", healthThreshold);
+}
+
+
 //-----------------------------------------------------------------------------------------------
 FleeBehavior::FleeBehavior(const std::string& name, const XMLNode& blueprintNode)
-   : Behavior(name, blueprintNode)
-   , m_healthThreshold(3)
+   : Behavior(new FleeBehaviorBlueprint(name, blueprintNode))
    , m_isFleeing(false)
+   , m_plannedDirection(INVALID_DIRECTION)
 {
-   PopulateFromXMLNode(blueprintNode);
 }
 
 
 //-----------------------------------------------------------------------------------------------
 FleeBehavior::FleeBehavior(const FleeBehavior& copySource)
    : Behavior(copySource)
-   , m_healthThreshold(copySource.m_healthThreshold)
    , m_isFleeing(copySource.m_isFleeing)
+   , m_plannedDirection(INVALID_DIRECTION)
 {}
 
 
 //-----------------------------------------------------------------------------------------------
 float FleeBehavior::CalcUtility()
 {
-   if (m_owningAgent->GetCurrentHealth() > m_healthThreshold)
+   Agent* closestThreat = m_owningAgent->GetClosestEnemy();
+   float distanceToThreat = (closestThreat != nullptr) ? Vector2i::GetDistanceBetween(m_owningAgent->GetPosition(), closestThreat->GetPosition()) : 0.f;
+
+   float utility = ScoreUtility(m_owningAgent->GetCurrentHealth(), GetBlueprint().healthThreshold, closestThreat != nullptr, distanceToThreat);
+   if (utility == 0.f)
    {
       m_isFleeing = false;
+   }
+
+   return utility;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC float FleeBehavior::ScoreUtility(int currentHealth, int healthThreshold, bool hasEnemy, float distanceToEnemy)
+{
+   if (currentHealth > healthThreshold)
+   {
       return 0.f;
    }
 
-   Agent* closestThreat = m_owningAgent->GetClosestEnemy();
-   if (closestThreat == nullptr
-      || Vector2i::GetDistanceBetween(m_owningAgent->GetPosition(), closestThreat->GetPosition()) > 5.f)
+   if (!hasEnemy || distanceToEnemy > 5.f)
    {
-      m_isFleeing = false;
       return 0.f;
    }
 
@@ -50,20 +80,67 @@ float FleeBehavior::CalcUtility()
 
 
 //-----------------------------------------------------------------------------------------------
-void FleeBehavior::Run()
+// Anyone with no reason to flee has stopped fleeing, chosen or not
+STATIC void FleeBehavior::ScoreBatch(const UtilityInputs& inputs, UtilityScoringEntries& entries)
+{
+   const int numEntries = entries.GetNumberOfEntries();
+   for (int entryIndex = 0; entryIndex < numEntries; ++entryIndex)
+   {
+      int agentIndex = entries.agentIndices[entryIndex];
+      entries.utilities[entryIndex] = ScoreUtility(inputs.currentHealth[agentIndex], (int)entries.parameters[entryIndex],
+         inputs.hasEnemy[agentIndex] != 0, inputs.distanceToEnemy[agentIndex]);
+   }
+
+   for (int entryIndex = 0; entryIndex < numEntries; ++entryIndex)
+   {
+      if (entries.utilities[entryIndex] == 0.f)
+      {
+         ((FleeBehavior*)entries.behaviors[entryIndex])->m_isFleeing = false;
+      }
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void FleeBehavior::Plan()
 {
+   m_plannedDirection = INVALID_DIRECTION;
+
+   Agent* closestThreat = m_owningAgent->GetClosestEnemy();
+   if (closestThreat == nullptr)
+   {
+      return;
+   }
+
    TileCoords pos = m_owningAgent->GetPosition();
-   TileCoords threatPos = m_owningAgent->GetClosestEnemy()->GetPosition();
+   TileCoords threatPos = closestThreat->GetPosition();
 
    TileDirection dirToThreat = m_owningAgent->GetMap()->GetDirectionFromSourceToDest(pos, threatPos);
-   TileDirection dirAwayFromThreat = Map::GetOppositeTileDirection(dirToThreat);
+   m_plannedDirection = Map::GetOppositeTileDirection(dirToThreat);
+}
 
-   m_owningAgent->MoveOneStepInDirection(dirAwayFromThreat);
+
+//-----------------------------------------------------------------------------------------------
+void FleeBehavior::Run()
+{
+   if (m_plannedDirection == INVALID_DIRECTION)
+   {
+      return;
+   }
+
+   m_owningAgent->MoveOneStepInDirection(m_plannedDirection);
 
    if (!m_isFleeing)
    {
       m_isFleeing = true;
-      g_theGameMessageBox->PrintNeutralMessage(Stringf("The %s flees!", m_owningAgent->GetName().c_str()));
+
+      // Only worth telling the player about if they can see it
+      const Player* player = g_theGame->GetGameContext()->activePlayer;
+      if (player != nullptr
+         && player->IsAgentVisible(m_owningAgent))
+      {
+         g_theGameMessageBox->PrintNeutralMessage(Stringf("The %s flees!", m_owningAgent->GetName().c_str()));
+      }
    }
 }
 
@@ -76,13 +153,6 @@ Behavior* FleeBehavior::Clone()
 }
 
 
-//-----------------------------------------------------------------------------------------------
-void FleeBehavior::PopulateFromXMLNode(const XMLNode& blueprintNode)
-{
-   m_healthThreshold = ReadXMLAttribute(blueprintNode, "healthThreshold", m_healthThreshold);
-}
-
-
 //-----------------------------------------------------------------------------------------------
 bool FleeBehavior::DoesPassChanceToRun()
 {
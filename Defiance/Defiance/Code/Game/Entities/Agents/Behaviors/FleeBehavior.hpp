@@ -10,6 +10,17 @@ struct XMLNode;
 class Entity;
 
 
+//-----------------------------------------------------------------------------------------------
+struct FleeBehaviorBlueprint
+   : public BehaviorBlueprint
+{
+   FleeBehaviorBlueprint(const std::string& behaviorName, const XMLNode& blueprintNode);
+   void PopulateFromXMLNode(const XMLNode& blueprintNode);
+
+   int healthThreshold; // #TODO make threshold a percentage of max health
+};
+
+
 //-----------------------------------------------------------------------------------------------
 class FleeBehavior
    : public Behavior
@@ -20,16 +31,23 @@ public:
 
    virtual float CalcUtility() override;
    virtual void Run() override;
+   virtual void Plan() override;
    virtual Behavior* Clone() override;
-   virtual void PopulateFromXMLNode(const XMLNode& blueprintNode);
    virtual bool DoesPassChanceToRun() override;
+   virtual UtilityScoringKernel* GetScoringKernel() const override { return &ScoreBatch; }
+   virtual float GetScoringParameter() const override { return (float)GetBlueprint().healthThreshold; }
+
+   static float ScoreUtility(int currentHealth, int healthThreshold, bool hasEnemy, float distanceToEnemy);
+   static void ScoreBatch(const UtilityInputs& inputs, UtilityScoringEntries& entries);
 
    static Behavior* CreateBehavior(const std::string& name, const XMLNode& blueprintNode) { return new FleeBehavior(name, blueprintNode); }
    static BehaviorRegistration s_fleeBehaviorRegistration;
 
    virtual void WriteToXMLNode(XMLNode&) const override {};
 
-private: // #TODO make threshold a percentage of max health
-   int m_healthThreshold;
+private:
+   const FleeBehaviorBlueprint& GetBlueprint() const { return *(const FleeBehaviorBlueprint*)m_blueprint; }
+
    bool m_isFleeing;
+   TileDirection m_plannedDirection;
 };
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "Game/Entities/Agents/Behaviors/HealAllyBehavior.hpp"
 #include "Game/Combat/DefianceCombatSystem.hpp"
 #include "Game/Entities/Agents/Agent.hpp"
+#include "Game/Entities/EntityRegistry.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
@@ -11,23 +12,46 @@ STATIC BehaviorRegistration HealAllyBehavior::s_healAllyBehaviorRegistration("He
 
 
 //-----------------------------------------------------------------------------------------------
-HealAllyBehavior::HealAllyBehavior(const std::string& name, const XMLNode& blueprintNode)
-   : Behavior(name, blueprintNode)
-   , m_minHealthToHeal(1)
-   , m_maxHealthToHeal(3)
-   , m_percentChanceToHit(.8f)
-   , m_healTarget(nullptr)
+HealAllyBehaviorBlueprint::HealAllyBehaviorBlueprint(const std::string& behaviorName, const XMLNode& blueprintNode)
+   : BehaviorBlueprint(behaviorName, blueprintNode)
+   , minHealthToHeal(1)
+   , maxHealthToHeal(3)
+   , percentChanceToHit(.8f)
 {
    PopulateFromXMLNode(blueprintNode);
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void HealAllyBehaviorBlueprint::PopulateFromXMLNode(const XMLNode& blueprintNode)
+{
+   Tokenizer tokenizer(ReadXMLAttribute(blueprintNode, "healingPower", std::string("1~3")), "~");
+   SetTypeFromString(minHealthToHeal, tokenizer.GetNextToken());
+
+   if (tokenizer.IsFinished())
+   {
+      maxHealthToHeal = minHealthToHeal;
+   }
+   else
+   {
+      SetTypeFromString(maxHealthToHeal, tokenizer.GetNextToken());
+   }
+
+   percentChanceToHit = ReadXMLAttribute(blueprintNode, "percentChanceToHit", percentChanceToHit);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+HealAllyBehavior::HealAllyBehavior(const std::string& name, const XMLNode& blueprintNode)
+   : Behavior(new HealAllyBehaviorBlueprint(name, blueprintNode))
+   , m_healTarget()
+{
+}
+
+
 //-----------------------------------------------------------------------------------------------
 HealAllyBehavior::HealAllyBehavior(const HealAllyBehavior& copySource)
    : Behavior(copySource)
-   , m_minHealthToHeal(copySource.m_minHealthToHeal)
-   , m_maxHealthToHeal(copySource.m_maxHealthToHeal)
-   , m_percentChanceToHit(copySource.m_percentChanceToHit)
    , m_healTarget(copySource.m_healTarget)
 {
 }
@@ -36,15 +60,25 @@ HealAllyBehavior::HealAllyBehavior(const HealAllyBehavior& copySource)
 //-----------------------------------------------------------------------------------------------
 float HealAllyBehavior::CalcUtility()
 {
-   m_healTarget = m_owningAgent->GetClosestAlly();
-   if (m_healTarget == nullptr
-      || m_healTarget->IsAtMaxHealth())
+   Agent* healTarget = m_owningAgent->GetClosestAlly();
+   if (healTarget == nullptr)
+   {
+      return ScoreUtility(false, false, 0.f);
+   }
+
+   return ScoreUtility(true, healTarget->IsAtMaxHealth(), Vector2i::GetDistanceBetween(m_owningAgent->GetPosition(), healTarget->GetPosition()));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC float HealAllyBehavior::ScoreUtility(bool hasAlly, bool isAllyAtMaxHealth, float distanceToAlly)
+{
+   if (!hasAlly || isAllyAtMaxHealth)
    {
       return 0.f;
    }
 
-   float distanceToTarget = Vector2i::GetDistanceBetween(m_owningAgent->GetPosition(), m_healTarget->GetPosition());
-   if (distanceToTarget >= 2.f) // 1.4f == diagonal
+   if (distanceToAlly >= 2.f) // 1.4f == diagonal
    {
       return 0.f;
    }
@@ -54,65 +88,59 @@ float HealAllyBehavior::CalcUtility()
 
 
 //-----------------------------------------------------------------------------------------------
-void HealAllyBehavior::Run()
+STATIC void HealAllyBehavior::ScoreBatch(const UtilityInputs& inputs, UtilityScoringEntries& entries)
 {
-   // sanity check
-   if (m_healTarget == nullptr)
+   const int numEntries = entries.GetNumberOfEntries();
+   for (int entryIndex = 0; entryIndex < numEntries; ++entryIndex)
    {
-      return;
+      int agentIndex = entries.agentIndices[entryIndex];
+      entries.utilities[entryIndex] = ScoreUtility(inputs.hasAlly[agentIndex] != 0, inputs.isAllyAtMaxHealth[agentIndex] != 0, inputs.distanceToAlly[agentIndex]);
    }
-
-   AttackData attackData;
-   attackData.minDamage = -m_minHealthToHeal;
-   attackData.maxDamage = -m_maxHealthToHeal;
-   attackData.percentChanceToHit = m_percentChanceToHit;
-   attackData.instigator = m_owningAgent;
-   attackData.target = m_healTarget;
-
-   m_owningAgent->PerformAttack(attackData);
 }
 
 
 //-----------------------------------------------------------------------------------------------
-Behavior* HealAllyBehavior::Clone()
+void HealAllyBehavior::Plan()
 {
-   Behavior* clone = new HealAllyBehavior(*this);
-   return clone;
+   Agent* healTarget = m_owningAgent->GetClosestAlly();
+   m_healTarget = (healTarget != nullptr) ? healTarget->GetHandle() : EntityHandle();
 }
 
 
 //-----------------------------------------------------------------------------------------------
-void HealAllyBehavior::PopulateFromXMLNode(const XMLNode& blueprintNode)
+void HealAllyBehavior::Run()
 {
-   Tokenizer tokenizer(ReadXMLAttribute(blueprintNode, "healingPower", std::string("1~3")), "~");
-   SetTypeFromString(m_minHealthToHeal, tokenizer.GetNextToken());
-
-   if (tokenizer.IsFinished())
+   // Someone acting earlier this turn may have killed the target or moved it out of reach
+   Agent* healTarget = (Agent*)EntityRegistry::Resolve(m_healTarget);
+   if (healTarget == nullptr
+      || !healTarget->IsAlive()
+      || Vector2i::GetDistanceBetween(m_owningAgent->GetPosition(), healTarget->GetPosition()) >= 2.f)
    {
-      m_maxHealthToHeal = m_minHealthToHeal;
-   }
-   else
-   {
-      SetTypeFromString(m_maxHealthToHeal, tokenizer.GetNextToken());
+      return;
    }
 
-   m_percentChanceToHit = ReadXMLAttribute(blueprintNode, "percentChanceToHit", m_percentChanceToHit);
+   AttackData attackData;
+   attackData.minDamage = -GetBlueprint().minHealthToHeal;
+   attackData.maxDamage = -GetBlueprint().maxHealthToHeal;
+   attackData.percentChanceToHit = GetBlueprint().percentChanceToHit;
+   attackData.instigator = m_owningAgent;
+   attackData.target = healTarget;
+
+   m_owningAgent->PerformAttack(attackData);
 }
 
 
 //-----------------------------------------------------------------------------------------------
-bool HealAllyBehavior::DoesPassChanceToRun()
+Behavior* HealAllyBehavior::Clone()
 {
-   //#TODO
-   return true;
+   Behavior* clone = new HealAllyBehavior(*this);
+   return clone;
 }
 
 
 //-----------------------------------------------------------------------------------------------
-void HealAllyBehavior::DereferenceEntity(Entity* entity)
+bool HealAllyBehavior::DoesPassChanceToRun()
 {
-   if (m_healTarget == entity)
-   {
-      m_healTarget = nullptr;
-   }
+   //#TODO
+   return true;
 }
\ No newline at end of file
@@ -10,6 +10,19 @@ struct XMLNode;
 class Entity;
 
 
+//-----------------------------------------------------------------------------------------------
+struct HealAllyBehaviorBlueprint
+   : public BehaviorBlueprint
+{
+   HealAllyBehaviorBlueprint(const std::string& behaviorName, const XMLNode& blueprintNode);
+   void PopulateFromXMLNode(const XMLNode& blueprintNode);
+
+   int minHealthToHeal;
+   int maxHealthToHeal;
+   float percentChanceToHit;
+};
+
+
 //-----------------------------------------------------------------------------------------------
 class HealAllyBehavior
    : public Behavior
@@ -21,9 +34,12 @@ public:
    virtual float CalcUtility() override;
    virtual void Run() override;
    virtual Behavior* Clone() override;
-   virtual void PopulateFromXMLNode(const XMLNode& blueprintNode);
    virtual bool DoesPassChanceToRun() override;
-   virtual void DereferenceEntity(Entity* entity) override;
+   virtual void Plan() override;
+   virtual UtilityScoringKernel* GetScoringKernel() const override { return &ScoreBatch; }
+
+   static float ScoreUtility(bool hasAlly, bool isAllyAtMaxHealth, float distanceToAlly);
+   static void ScoreBatch(const UtilityInputs& inputs, UtilityScoringEntries& entries);
 
    static Behavior* CreateBehavior(const std::string& name, const XMLNode& blueprintNode) { return new HealAllyBehavior(name, blueprintNode); }
    static BehaviorRegistration s_healAllyBehaviorRegistration;
@@ -31,8 +47,7 @@ public:
    virtual void WriteToXMLNode(XMLNode&) const override {};
 
 private:
-   int m_minHealthToHeal;
-   int m_maxHealthToHeal;
-   float m_percentChanceToHit;
-   Agent* m_healTarget;
+   const HealAllyBehaviorBlueprint& GetBlueprint() const { return *(const HealAllyBehaviorBlueprint*)m_blueprint; }
+
+   EntityHandle m_healTarget;
 };
\ No newline at end of file
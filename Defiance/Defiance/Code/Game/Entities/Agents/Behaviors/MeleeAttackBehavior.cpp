@@ -4,6 +4,7 @@
 #include "Game/Entities/Agents/Behaviors/MeleeAttackBehavior.hpp"
 #include "Game/Combat/DefianceCombatSystem.hpp"
 #include "Game/Entities/Agents/Agent.hpp"
+#include "Game/Entities/EntityRegistry.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
@@ -11,23 +12,46 @@ STATIC BehaviorRegistration MeleeAttackBehavior::s_meleeAttackBehaviorRegistrati
 
 
 //-----------------------------------------------------------------------------------------------
-MeleeAttackBehavior::MeleeAttackBehavior(const std::string& name, const XMLNode& blueprintNode)
-   : Behavior(name, blueprintNode)
-   , m_minDamage(1)
-   , m_maxDamage(3)
-   , m_percentChanceToHit(.8f)
-   , m_meleeAttackTarget(nullptr)
+MeleeAttackBehaviorBlueprint::MeleeAttackBehaviorBlueprint(const std::string& behaviorName, const XMLNode& blueprintNode)
+   : BehaviorBlueprint(behaviorName, blueprintNode)
+   , minDamage(1)
+   , maxDamage(3)
+   , percentChanceToHit(.8f)
 {
    PopulateFromXMLNode(blueprintNode);
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void MeleeAttackBehaviorBlueprint::PopulateFromXMLNode(const XMLNode& blueprintNode)
+{
+   Tokenizer tokenizer(ReadXMLAttribute(blueprintNode, "damage", std::string("1~3")), "~");
+   SetTypeFromString(minDamage, tokenizer.GetNextToken());
+
+   if (tokenizer.IsFinished())
+   {
+      maxDamage = minDamage;
+   }
+   else
+   {
+      SetTypeFromString(maxDamage, tokenizer.GetNextToken());
+   }
+
+   percentChanceToHit = ReadXMLAttribute(blueprintNode, "percentChanceToHit", 0.8f);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+MeleeAttackBehavior::MeleeAttackBehavior(const std::string& name, const XMLNode& blueprintNode)
+   : Behavior(new MeleeAttackBehaviorBlueprint(name, blueprintNode))
+   , m_meleeAttackTarget()
+{
+}
+
+
 //-----------------------------------------------------------------------------------------------
 MeleeAttackBehavior::MeleeAttackBehavior(const MeleeAttackBehavior& copySource)
    : Behavior(copySource)
-   , m_minDamage(copySource.m_minDamage)
-   , m_maxDamage(copySource.m_maxDamage)
-   , m_percentChanceToHit(copySource.m_percentChanceToHit)
    , m_meleeAttackTarget(copySource.m_meleeAttackTarget)
 {
 }
@@ -36,14 +60,20 @@ MeleeAttackBehavior::MeleeAttackBehavior(const MeleeAttackBehavior& copySource)
 //-----------------------------------------------------------------------------------------------
 float MeleeAttackBehavior::CalcUtility()
 {
-   m_meleeAttackTarget = m_owningAgent->GetClosestEnemy();
-   if (m_meleeAttackTarget == nullptr)
+   Agent* meleeAttackTarget = m_owningAgent->GetClosestEnemy();
+   if (meleeAttackTarget == nullptr)
    {
-      return 0.f;
+      return ScoreUtility(false, 0.f);
    }
 
-   float distanceToTarget = Vector2i::GetDistanceBetween(m_owningAgent->GetPosition(), m_meleeAttackTarget->GetPosition());
-   if (distanceToTarget >= 2.f) // 1.4f == diagonal
+   return ScoreUtility(true, Vector2i::GetDistanceBetween(m_owningAgent->GetPosition(), meleeAttackTarget->GetPosition()));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC float MeleeAttackBehavior::ScoreUtility(bool hasEnemy, float distanceToEnemy)
+{
+   if (!hasEnemy || distanceToEnemy >= 2.f) // 1.4f == diagonal
    {
       return 0.f;
    }
@@ -53,65 +83,59 @@ float MeleeAttackBehavior::CalcUtility()
 
 
 //-----------------------------------------------------------------------------------------------
-void MeleeAttackBehavior::Run()
+STATIC void MeleeAttackBehavior::ScoreBatch(const UtilityInputs& inputs, UtilityScoringEntries& entries)
 {
-   // sanity check
-   if (m_meleeAttackTarget == nullptr)
+   const int numEntries = entries.GetNumberOfEntries();
+   for (int entryIndex = 0; entryIndex < numEntries; ++entryIndex)
    {
-      return;
+      int agentIndex = entries.agentIndices[entryIndex];
+      entries.utilities[entryIndex] = ScoreUtility(inputs.hasEnemy[agentIndex] != 0, inputs.distanceToEnemy[agentIndex]);
    }
-
-   AttackData attackData;
-   attackData.minDamage = m_minDamage;
-   attackData.maxDamage = m_maxDamage;
-   attackData.percentChanceToHit = m_percentChanceToHit;
-   attackData.instigator = m_owningAgent;
-   attackData.target = m_meleeAttackTarget;
-
-   m_owningAgent->PerformAttack(attackData);
 }
 
 
 //-----------------------------------------------------------------------------------------------
-Behavior* MeleeAttackBehavior::Clone()
+void MeleeAttackBehavior::Plan()
 {
-   Behavior* clone = new MeleeAttackBehavior(*this);
-   return clone;
+   Agent* meleeAttackTarget = m_owningAgent->GetClosestEnemy();
+   m_meleeAttackTarget = (meleeAttackTarget != nullptr) ? meleeAttackTarget->GetHandle() : EntityHandle();
 }
 
 
 //-----------------------------------------------------------------------------------------------
-void MeleeAttackBehavior::PopulateFromXMLNode(const XMLNode& blueprintNode)
+void MeleeAttackBehavior::Run()
 {
-   Tokenizer tokenizer(ReadXMLAttribute(blueprintNode, "damage", std::string("1~3")), "~");
-   SetTypeFromString(m_minDamage, tokenizer.GetNextToken());
-
-   if (tokenizer.IsFinished())
+   // Someone acting earlier this turn may have killed the target or moved it out of reach
+   Agent* meleeAttackTarget = (Agent*)EntityRegistry::Resolve(m_meleeAttackTarget);
+   if (meleeAttackTarget == nullptr
+      || !meleeAttackTarget->IsAlive()
+      || Vector2i::GetDistanceBetween(m_owningAgent->GetPosition(), meleeAttackTarget->GetPosition()) >= 2.f)
    {
-      m_maxDamage = m_minDamage;
-   }
-   else
-   {
-      SetTypeFromString(m_maxDamage, tokenizer.GetNextToken());
+      return;
    }
 
-   m_percentChanceToHit = ReadXMLAttribute(blueprintNode, "percentChanceToHit", 0.8f);
+   AttackData attackData;
+   attackData.minDamage = GetBlueprint().minDamage;
+   attackData.maxDamage = GetBlueprint().maxDamage;
+   attackData.percentChanceToHit = GetBlueprint().percentChanceToHit;
+   attackData.instigator = m_owningAgent;
+   attackData.target = meleeAttackTarget;
+
+   m_owningAgent->PerformAttack(attackData);
 }
 
 
 //-----------------------------------------------------------------------------------------------
-bool MeleeAttackBehavior::DoesPassChanceToRun()
+Behavior* MeleeAttackBehavior::Clone()
 {
-   //#TODO
-   return true;
+   Behavior* clone = new MeleeAttackBehavior(*this);
+   return clone;
 }
 
 
 //-----------------------------------------------------------------------------------------------
-void MeleeAttackBehavior::DereferenceEntity(Entity* entity)
+bool MeleeAttackBehavior::DoesPassChanceToRun()
 {
-   if (m_meleeAttackTarget == entity)
-   {
-      m_meleeAttackTarget = nullptr;
-   }
+   //#TODO
+   return true;
 }
\ No newline at end of file
@@ -10,6 +10,19 @@ struct XMLNode;
 class Entity;
 
 
+//-----------------------------------------------------------------------------------------------
+struct MeleeAttackBehaviorBlueprint
+   : public BehaviorBlueprint
+{
+   MeleeAttackBehaviorBlueprint(const std::string& behaviorName, const XMLNode& blueprintNode);
+   void PopulateFromXMLNode(const XMLNode& blueprintNode);
+
+   int minDamage;
+   int maxDamage;
+   float percentChanceToHit;
+};
+
+
 //-----------------------------------------------------------------------------------------------
 class MeleeAttackBehavior
    : public Behavior
@@ -21,9 +34,12 @@ public:
    virtual float CalcUtility() override;
    virtual void Run() override;
    virtual Behavior* Clone() override;
-   virtual void PopulateFromXMLNode(const XMLNode& blueprintNode);
    virtual bool DoesPassChanceToRun() override;
-   virtual void DereferenceEntity(Entity* entity) override;
+   virtual void Plan() override;
+   virtual UtilityScoringKernel* GetScoringKernel() const override { return &ScoreBatch; }
+
+   static float ScoreUtility(bool hasEnemy, float distanceToEnemy);
+   static void ScoreBatch(const UtilityInputs& inputs, UtilityScoringEntries& entries);
 
    static Behavior* CreateBehavior(const std::string& name, const XMLNode& blueprintNode) { return new MeleeAttackBehavior(name, blueprintNode); }
    static BehaviorRegistration s_meleeAttackBehaviorRegistration;
@@ -31,8 +47,7 @@ public:
    virtual void WriteToXMLNode(XMLNode&) const override {};
 
 private:
-   int m_minDamage;
-   int m_maxDamage;
-   float m_percentChanceToHit;
-   Agent* m_meleeAttackTarget;
+   const MeleeAttackBehaviorBlueprint& GetBlueprint() const { return *(const MeleeAttackBehaviorBlueprint*)m_blueprint; }
+
+   EntityHandle m_meleeAttackTarget;
 };
\ No newline at end of file
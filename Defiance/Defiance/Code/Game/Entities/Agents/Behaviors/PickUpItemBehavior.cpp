@@ -3,6 +3,7 @@
 #include "Game/Pathfinding/PathfinderAStar.hpp"
 #include "Game/Entities/Agents/Behaviors/PickUpItemBehavior.hpp"
 #include "Game/Entities/Agents/Agent.hpp"
+#include "Game/Entities/EntityRegistry.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
@@ -10,20 +11,35 @@ STATIC BehaviorRegistration PickUpItemBehavior::s_pickUpItemBehaviorRegistration
 
 
 //-----------------------------------------------------------------------------------------------
-PickUpItemBehavior::PickUpItemBehavior(const std::string& name, const XMLNode& blueprintNode)
-   : Behavior(name, blueprintNode)
-   , m_tilesToTravelForItem(15)
-   , m_targetItem(nullptr)
+PickUpItemBehaviorBlueprint::PickUpItemBehaviorBlueprint(const std::string& behaviorName, const XMLNode& blueprintNode)
+   : BehaviorBlueprint(behaviorName, blueprintNode)
+   , tilesToTravelForItem(15)
 {
    PopulateFromXMLNode(blueprintNode);
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void PickUpItemBehaviorBlueprint::PopulateFromXMLNode(const XMLNode& blueprintNode)
+{
+   tilesToTravelForItem = ReadXMLAttribute(blueprintNode, "tilesToTravelForItem", tilesToTravelForItem);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+PickUpItemBehavior::PickUpItemBehavior(const std::string& name, const XMLNode& blueprintNode)
+   : Behavior(new PickUpItemBehaviorBlueprint(name, blueprintNode))
+   , m_targetItem()
+   , m_plannedDirection(INVALID_DIRECTION)
+{
+}
+
+
 //-----------------------------------------------------------------------------------------------
 PickUpItemBehavior::PickUpItemBehavior(const PickUpItemBehavior& copySource)
    : Behavior(copySource)
-   , m_tilesToTravelForItem(copySource.m_tilesToTravelForItem)
    , m_targetItem(copySource.m_targetItem)
+   , m_plannedDirection(INVALID_DIRECTION)
 {
 }
 
@@ -31,20 +47,26 @@ PickUpItemBehavior::PickUpItemBehavior(const PickUpItemBehavior& copySource)
 //-----------------------------------------------------------------------------------------------
 float PickUpItemBehavior::CalcUtility()
 {
-   if (m_owningAgent->IsInventoryFull())
+   Item* targetItem = m_owningAgent->GetClosestVisibleItem();
+   if (targetItem == nullptr)
    {
-      return 0.f;
+      return ScoreUtility(m_owningAgent->IsInventoryFull(), false, 0, GetBlueprint().tilesToTravelForItem);
    }
 
-   m_targetItem = m_owningAgent->GetClosestVisibleItem();
-   if (m_targetItem == nullptr)
+   TileCoords agentPos = m_owningAgent->GetPosition();
+   return ScoreUtility(m_owningAgent->IsInventoryFull(), true, agentPos.GetManhattanDistanceToVector(targetItem->GetPosition()), GetBlueprint().tilesToTravelForItem);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC float PickUpItemBehavior::ScoreUtility(bool isInventoryFull, bool hasItem, int tilesToItem, int tilesToTravelForItem)
+{
+   if (isInventoryFull || !hasItem)
    {
       return 0.f;
    }
 
-   TileCoords agentPos = m_owningAgent->GetPosition();
-   int tilesFromTarget = agentPos.GetManhattanDistanceToVector(m_targetItem->GetPosition());
-   if (tilesFromTarget > m_tilesToTravelForItem)
+   if (tilesToItem > tilesToTravelForItem)
    {
       return 0.f;
    }
@@ -54,27 +76,37 @@ float PickUpItemBehavior::CalcUtility()
 
 
 //-----------------------------------------------------------------------------------------------
-void PickUpItemBehavior::Run()
+STATIC void PickUpItemBehavior::ScoreBatch(const UtilityInputs& inputs, UtilityScoringEntries& entries)
 {
-   // sanity check
-   if (m_targetItem == nullptr)
+   const int numEntries = entries.GetNumberOfEntries();
+   for (int entryIndex = 0; entryIndex < numEntries; ++entryIndex)
+   {
+      int agentIndex = entries.agentIndices[entryIndex];
+      entries.utilities[entryIndex] = ScoreUtility(inputs.isInventoryFull[agentIndex] != 0, inputs.hasItem[agentIndex] != 0,
+         inputs.tilesToItem[agentIndex], (int)entries.parameters[entryIndex]);
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void PickUpItemBehavior::Plan()
+{
+   m_plannedDirection = INVALID_DIRECTION;
+
+   Item* targetItem = m_owningAgent->GetClosestVisibleItem();
+   m_targetItem = (targetItem != nullptr) ? targetItem->GetHandle() : EntityHandle();
+   if (targetItem == nullptr)
    {
       return;
    }
 
    TileCoords agentPos = m_owningAgent->GetPosition();
-   TileCoords itemPos = m_targetItem->GetPosition();
-   int tilesFromTarget = agentPos.GetManhattanDistanceToVector(itemPos);
-   
-   // We're standing on it; pick it up!
-   if (tilesFromTarget == 0)
+   TileCoords itemPos = targetItem->GetPosition();
+   if (agentPos == itemPos)
    {
-      m_owningAgent->TryGetItemFromCurrentTile();
-      m_targetItem = nullptr;
       return;
    }
 
-
    Map* gameMap = m_owningAgent->GetMap();
    PathfinderAStar pathfinder(agentPos, itemPos, MapProxy(gameMap));
    pathfinder.FindPath();
@@ -86,23 +118,40 @@ void PickUpItemBehavior::Run()
    }
 
    const Path& path = pathfinder.GetPath();
-   TileDirection directionToTarget = gameMap->GetDirectionFromSourceToDest(agentPos, path.GetStepTowardsPathEnd());
-   m_owningAgent->MoveOneStepInDirection(directionToTarget);
+   m_plannedDirection = gameMap->GetDirectionFromSourceToDest(agentPos, path.GetStepTowardsPathEnd());
 }
 
 
 //-----------------------------------------------------------------------------------------------
-Behavior* PickUpItemBehavior::Clone()
+// Someone acting earlier this turn may have picked the item up already
+void PickUpItemBehavior::Run()
 {
-   Behavior* clone = new PickUpItemBehavior(*this);
-   return clone;
+   Item* targetItem = (Item*)EntityRegistry::Resolve(m_targetItem);
+   if (targetItem == nullptr || targetItem->IsPickedUp())
+   {
+      return;
+   }
+
+   // We're standing on it; pick it up!
+   if (m_owningAgent->GetPosition() == targetItem->GetPosition())
+   {
+      m_owningAgent->TryGetItemFromCurrentTile();
+      m_targetItem = EntityHandle();
+      return;
+   }
+
+   if (m_plannedDirection != INVALID_DIRECTION)
+   {
+      m_owningAgent->MoveOneStepInDirection(m_plannedDirection);
+   }
 }
 
 
 //-----------------------------------------------------------------------------------------------
-void PickUpItemBehavior::PopulateFromXMLNode(const XMLNode& blueprintNode)
+Behavior* PickUpItemBehavior::Clone()
 {
-   m_tilesToTravelForItem = ReadXMLAttribute(blueprintNode, "tilesToTravelForItem", m_tilesToTravelForItem);
+   Behavior* clone = new PickUpItemBehavior(*this);
+   return clone;
 }
 
 
@@ -111,16 +160,4 @@ bool PickUpItemBehavior::DoesPassChanceToRun()
 {
    // #TODO
    return true;
-}
-
-
-//-----------------------------------------------------------------------------------------------
-void PickUpItemBehavior::DereferenceEntity(Entity* entity)
-{
-   if (m_targetItem == entity)
-   {
-      m_targetItem = nullptr;
-   }
-}
-
-
+}
\ No newline at end of file
@@ -10,6 +10,17 @@ struct XMLNode;
 class Entity;
 
 
+//-----------------------------------------------------------------------------------------------
+struct PickUpItemBehaviorBlueprint
+   : public BehaviorBlueprint
+{
+   PickUpItemBehaviorBlueprint(const std::string& behaviorName, const XMLNode& blueprintNode);
+   void PopulateFromXMLNode(const XMLNode& blueprintNode);
+
+   int tilesToTravelForItem;
+};
+
+
 //-----------------------------------------------------------------------------------------------
 class PickUpItemBehavior
    : public Behavior
@@ -20,15 +31,21 @@ public:
 
    virtual float CalcUtility() override;
    virtual void Run() override;
+   virtual void Plan() override;
    virtual Behavior* Clone() override;
-   virtual void PopulateFromXMLNode(const XMLNode& blueprintNode);
    virtual bool DoesPassChanceToRun() override;
-   virtual void DereferenceEntity(Entity* entity) override;
+   virtual UtilityScoringKernel* GetScoringKernel() const override { return &ScoreBatch; }
+   virtual float GetScoringParameter() const override { return (float)GetBlueprint().tilesToTravelForItem; }
+
+   static float ScoreUtility(bool isInventoryFull, bool hasItem, int tilesToItem, int tilesToTravelForItem);
+   static void ScoreBatch(const UtilityInputs& inputs, UtilityScoringEntries& entries);
 
    static Behavior* CreateBehavior(const std::string& name, const XMLNode& blueprintNode) { return new PickUpItemBehavior(name, blueprintNode); }
    static BehaviorRegistration s_pickUpItemBehaviorRegistration;
 
 private:
-   int m_tilesToTravelForItem;
-   Item* m_targetItem;
+   const PickUpItemBehaviorBlueprint& GetBlueprint() const { return *(const PickUpItemBehaviorBlueprint*)m_blueprint; }
+
+   EntityHandle m_targetItem;
+   TileDirection m_plannedDirection;
 };
\ No newline at end of file
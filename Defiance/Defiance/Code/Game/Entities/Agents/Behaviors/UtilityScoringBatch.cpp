@@ -0,0 +1,170 @@
+#include <limits.h>
+#include "Engine/Math/Vector2i.hpp"
+#include "Game/Entities/Agents/Behaviors/UtilityScoringBatch.hpp"
+#include "Game/Entities/Agents/Behaviors/Behavior.hpp"
+#include "Game/Entities/Agents/Agent.hpp"
+#include "Game/Entities/Items/Item.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+void UtilityInputs::Clear()
+{
+   currentHealth.clear();
+   isInventoryFull.clear();
+   hasEnemy.clear();
+   tilesToEnemy.clear();
+   distanceToEnemy.clear();
+   hasAlly.clear();
+   isAllyAtMaxHealth.clear();
+   distanceToAlly.clear();
+   hasItem.clear();
+   tilesToItem.clear();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Distances are measured now, the same way the behaviors' CalcUtility measures them
+void UtilityInputs::AddAgent(Agent* agent)
+{
+   const TileCoords& agentPos = agent->GetPosition();
+
+   currentHealth.push_back(agent->GetCurrentHealth());
+   isInventoryFull.push_back(agent->IsInventoryFull() ? 1 : 0);
+
+   Agent* closestEnemy = agent->GetClosestEnemy();
+   hasEnemy.push_back((closestEnemy != nullptr) ? 1 : 0);
+   tilesToEnemy.push_back((closestEnemy != nullptr) ? agentPos.GetManhattanDistanceToVector(closestEnemy->GetPosition()) : 0);
+   distanceToEnemy.push_back((closestEnemy != nullptr) ? Vector2i::GetDistanceBetween(agentPos, closestEnemy->GetPosition()) : 0.f);
+
+   Agent* closestAlly = agent->GetClosestAlly();
+   hasAlly.push_back((closestAlly != nullptr) ? 1 : 0);
+   isAllyAtMaxHealth.push_back((closestAlly != nullptr && closestAlly->IsAtMaxHealth()) ? 1 : 0);
+   distanceToAlly.push_back((closestAlly != nullptr) ? Vector2i::GetDistanceBetween(agentPos, closestAlly->GetPosition()) : 0.f);
+
+   Item* closestItem = agent->GetClosestVisibleItem();
+   hasItem.push_back((closestItem != nullptr) ? 1 : 0);
+   tilesToItem.push_back((closestItem != nullptr) ? agentPos.GetManhattanDistanceToVector(closestItem->GetPosition()) : 0);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void UtilityScoringEntries::Clear()
+{
+   agentIndices.clear();
+   behaviorOrders.clear();
+   parameters.clear();
+   behaviors.clear();
+   utilities.clear();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void UtilityScoringEntries::AddBehavior(int agentIndex, int behaviorOrder, Behavior* behavior)
+{
+   agentIndices.push_back(agentIndex);
+   behaviorOrders.push_back(behaviorOrder);
+   parameters.push_back(behavior->GetScoringParameter());
+   behaviors.push_back(behavior);
+   utilities.push_back(0.f);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void UtilityScoringBatch::ChooseBehaviors(const std::vector<Agent*>& agents)
+{
+   const int numAgents = (int)agents.size();
+
+   m_inputs.Clear();
+   for (Agent* agent : agents)
+   {
+      m_inputs.AddAgent(agent);
+   }
+
+   GatherEntries(agents);
+
+   m_bestUtilities.assign(numAgents, 0.f);
+   m_bestBehaviorOrders.assign(numAgents, INT_MAX);
+   m_bestBehaviors.assign(numAgents, nullptr);
+
+   for (KernelGroup& kernelGroup : m_kernelGroups)
+   {
+      kernelGroup.kernel(m_inputs, kernelGroup.entries);
+      KeepBestUtilities(kernelGroup.entries);
+   }
+
+   for (int entryIndex = 0; entryIndex < m_unbatchedEntries.GetNumberOfEntries(); ++entryIndex)
+   {
+      m_unbatchedEntries.utilities[entryIndex] = m_unbatchedEntries.behaviors[entryIndex]->CalcUtility();
+   }
+   KeepBestUtilities(m_unbatchedEntries);
+
+   for (int agentIndex = 0; agentIndex < numAgents; ++agentIndex)
+   {
+      agents[agentIndex]->SetChosenBehavior(m_bestBehaviors[agentIndex]);
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Groups stay around between turns so their arrays keep their capacity
+void UtilityScoringBatch::GatherEntries(const std::vector<Agent*>& agents)
+{
+   for (KernelGroup& kernelGroup : m_kernelGroups)
+   {
+      kernelGroup.entries.Clear();
+   }
+   m_unbatchedEntries.Clear();
+
+   for (int agentIndex = 0; agentIndex < (int)agents.size(); ++agentIndex)
+   {
+      const std::vector<Behavior*>& behaviors = agents[agentIndex]->GetBehaviors();
+      for (int behaviorOrder = 0; behaviorOrder < (int)behaviors.size(); ++behaviorOrder)
+      {
+         Behavior* behavior = behaviors[behaviorOrder];
+         UtilityScoringKernel* kernel = behavior->GetScoringKernel();
+         UtilityScoringEntries* entries = (kernel != nullptr) ? GetEntriesForKernel(kernel) : &m_unbatchedEntries;
+         entries->AddBehavior(agentIndex, behaviorOrder, behavior);
+      }
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+UtilityScoringEntries* UtilityScoringBatch::GetEntriesForKernel(UtilityScoringKernel* kernel)
+{
+   for (KernelGroup& kernelGroup : m_kernelGroups)
+   {
+      if (kernelGroup.kernel == kernel)
+      {
+         return &kernelGroup.entries;
+      }
+   }
+
+   KernelGroup newKernelGroup;
+   newKernelGroup.kernel = kernel;
+   m_kernelGroups.push_back(newKernelGroup);
+   return &m_kernelGroups.back().entries;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Higher utility wins; on a tie the behavior listed earlier wins, and 0 never wins at all
+void UtilityScoringBatch::KeepBestUtilities(const UtilityScoringEntries& entries)
+{
+   const int numEntries = entries.GetNumberOfEntries();
+   for (int entryIndex = 0; entryIndex < numEntries; ++entryIndex)
+   {
+      int agentIndex = entries.agentIndices[entryIndex];
+      float utility = entries.utilities[entryIndex];
+      int behaviorOrder = entries.behaviorOrders[entryIndex];
+
+      float bestUtility = m_bestUtilities[agentIndex];
+      if (utility > bestUtility
+         || (utility == bestUtility && utility > 0.f && behaviorOrder < m_bestBehaviorOrders[agentIndex]))
+      {
+         m_bestUtilities[agentIndex] = utility;
+         m_bestBehaviorOrders[agentIndex] = behaviorOrder;
+         m_bestBehaviors[agentIndex] = entries.behaviors[entryIndex];
+      }
+   }
+}
\ No newline at end of file
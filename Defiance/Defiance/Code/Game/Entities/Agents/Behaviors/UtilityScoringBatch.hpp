@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+
+
+//-----------------------------------------------------------------------------------------------
+class Agent;
+class Behavior;
+
+
+//-----------------------------------------------------------------------------------------------
+// What behaviors score on, one array per input with one slot per agent in the batch. Flags are
+// bytes rather than bools so each array is plain contiguous memory
+struct UtilityInputs
+{
+   void Clear();
+   void AddAgent(Agent* agent);
+   int GetNumberOfAgents() const { return (int)currentHealth.size(); }
+
+   std::vector<int> currentHealth;
+   std::vector<unsigned char> isInventoryFull;
+   std::vector<unsigned char> hasEnemy;
+   std::vector<int> tilesToEnemy;
+   std::vector<float> distanceToEnemy;
+   std::vector<unsigned char> hasAlly;
+   std::vector<unsigned char> isAllyAtMaxHealth;
+   std::vector<float> distanceToAlly;
+   std::vector<unsigned char> hasItem;
+   std::vector<int> tilesToItem;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Every behavior of one type in the batch. A kernel fills in utilities from the agent's inputs
+// and the behavior's own parameter
+struct UtilityScoringEntries
+{
+   void Clear();
+   void AddBehavior(int agentIndex, int behaviorOrder, Behavior* behavior);
+   int GetNumberOfEntries() const { return (int)agentIndices.size(); }
+
+   std::vector<int> agentIndices;
+   std::vector<int> behaviorOrders;
+   std::vector<float> parameters;
+   std::vector<Behavior*> behaviors;
+   std::vector<float> utilities;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+typedef void (UtilityScoringKernel)(const UtilityInputs& inputs, UtilityScoringEntries& entries);
+
+
+//-----------------------------------------------------------------------------------------------
+// Picks every agent's behavior at once. Inputs are gathered into arrays, each behavior type scores
+// all of its instances in one loop, and the best per agent is kept in another. Ties go to the
+// behavior listed first and nothing scoring 0 is chosen, exactly as Agent::ChooseBehavior does.
+// Behaviors without a kernel fall back to CalcUtility. Main thread only; agents must have perceived
+class UtilityScoringBatch
+{
+public:
+   UtilityScoringBatch() {}
+
+   void ChooseBehaviors(const std::vector<Agent*>& agents);
+
+private:
+   UtilityScoringBatch(const UtilityScoringBatch&);
+   UtilityScoringBatch& operator=(const UtilityScoringBatch&);
+
+   struct KernelGroup
+   {
+      UtilityScoringKernel* kernel;
+      UtilityScoringEntries entries;
+   };
+
+   void GatherEntries(const std::vector<Agent*>& agents);
+   UtilityScoringEntries* GetEntriesForKernel(UtilityScoringKernel* kernel);
+   void KeepBestUtilities(const UtilityScoringEntries& entries);
+
+   UtilityInputs m_inputs;
+   std::vector<KernelGroup> m_kernelGroups;
+   UtilityScoringEntries m_unbatchedEntries;
+   std::vector<float> m_bestUtilities;
+   std::vector<int> m_bestBehaviorOrders;
+   std::vector<Behavior*> m_bestBehaviors;
+};
\ No newline at end of file
@@ -1,30 +1,45 @@
 #include "Engine/Parsers/XMLUtilities.hpp"
 #include "Engine/Core/EngineCommon.hpp"
-#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Game/Entities/Agents/Behaviors/WanderBehavior.hpp"
 #include "Game/Entities/Agents/NPCs/NPC.hpp"
+#include "Game/Core/TheGame.hpp"
+#include "Game/Core/GameContext.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
 STATIC BehaviorRegistration WanderBehavior::s_wanderBehaviorRegistrastion("Wander", &WanderBehavior::CreateBehavior);
 
 
+//-----------------------------------------------------------------------------------------------
+WanderBehaviorBlueprint::WanderBehaviorBlueprint(const std::string& behaviorName, const XMLNode& blueprintNode)
+   : BehaviorBlueprint(behaviorName, blueprintNode)
+   , chanceToRest(0.5f)
+   , chanceToGoStraight(0.3f)
+{
+   PopulateFromXMLNode(blueprintNode);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void WanderBehaviorBlueprint::PopulateFromXMLNode(const XMLNode& blueprintNode)
+{
+   chanceToRest = ReadXMLAttribute(blueprintNode, "chanceToRest", chanceToRest);
+   chanceToGoStraight = ReadXMLAttribute(blueprintNode, "chanceToGoStraight", chanceToGoStraight);
+}
+
+
 //-----------------------------------------------------------------------------------------------
 WanderBehavior::WanderBehavior(const std::string& name, const XMLNode& blueprintNode)
-   : Behavior(name, blueprintNode)
-   , m_chanceToRest(0.5f)
-   , m_chanceToGoStraight(0.3f)
+   : Behavior(new WanderBehaviorBlueprint(name, blueprintNode))
    , m_lastDirection(INVALID_DIRECTION)
 {
-   PopulateFromXMLNode(blueprintNode);
 }
 
 
 //-----------------------------------------------------------------------------------------------
 WanderBehavior::WanderBehavior(const WanderBehavior& copySource)
    : Behavior(copySource)
-   , m_chanceToRest(copySource.m_chanceToRest)
-   , m_chanceToGoStraight(copySource.m_chanceToGoStraight)
    , m_lastDirection(copySource.m_lastDirection)
 {}
 
@@ -37,10 +52,24 @@ float WanderBehavior::CalcUtility()
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Matches CalcUtility
+STATIC void WanderBehavior::ScoreBatch(const UtilityInputs&, UtilityScoringEntries& entries)
+{
+   const int numEntries = entries.GetNumberOfEntries();
+   for (int entryIndex = 0; entryIndex < numEntries; ++entryIndex)
+   {
+      entries.utilities[entryIndex] = 1.f;
+   }
+}
+
+
 //-----------------------------------------------------------------------------------------------
 void WanderBehavior::Run()
 {
-   bool isResting = GetRandomTrueOrFalseWithProbability(m_chanceToRest);
+   RandomNumberGenerator* aiRandom = &g_theGame->GetGameContext()->aiRandom;
+
+   bool isResting = aiRandom->GetTrueOrFalseWithProbability(GetBlueprint().chanceToRest);
    if (isResting)
    {
       m_lastDirection = INVALID_DIRECTION;
@@ -49,7 +78,7 @@ void WanderBehavior::Run()
 
    if (m_lastDirection != INVALID_DIRECTION)
    {
-      bool isGoingStraight = GetRandomTrueOrFalseWithProbability(m_chanceToGoStraight);
+      bool isGoingStraight = aiRandom->GetTrueOrFalseWithProbability(GetBlueprint().chanceToGoStraight);
       if (isGoingStraight)
       {
          bool didMove = m_owningAgent->MoveOneStepInDirection(m_lastDirection);
@@ -60,10 +89,10 @@ void WanderBehavior::Run()
       }
    }
 
-   TileDirection newDirection = GetRandomTileDirection();
+   TileDirection newDirection = GetRandomTileDirection(aiRandom);
    while (newDirection == m_lastDirection)
    {
-      newDirection = GetRandomTileDirection();
+      newDirection = GetRandomTileDirection(aiRandom);
    }
 
    // If stuck, we'll just rest I guess
@@ -87,14 +116,6 @@ Behavior* WanderBehavior::Clone()
 }
 
 
-//-----------------------------------------------------------------------------------------------
-void WanderBehavior::PopulateFromXMLNode(const XMLNode& blueprintNode)
-{
-   m_chanceToRest = ReadXMLAttribute(blueprintNode, "chanceToRest", m_chanceToRest);
-   m_chanceToGoStraight = ReadXMLAttribute(blueprintNode, "chanceToGoStraight", m_chanceToGoStraight);
-}
-
-
 //-----------------------------------------------------------------------------------------------
 bool WanderBehavior::DoesPassChanceToRun()
 {
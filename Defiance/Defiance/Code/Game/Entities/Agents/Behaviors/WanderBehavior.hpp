@@ -9,6 +9,18 @@
 struct XMLNode;
 
 
+//-----------------------------------------------------------------------------------------------
+struct WanderBehaviorBlueprint
+   : public BehaviorBlueprint
+{
+   WanderBehaviorBlueprint(const std::string& behaviorName, const XMLNode& blueprintNode);
+   void PopulateFromXMLNode(const XMLNode& blueprintNode);
+
+   float chanceToRest;
+   float chanceToGoStraight;
+};
+
+
 //-----------------------------------------------------------------------------------------------
 class WanderBehavior
    : public Behavior
@@ -20,8 +32,10 @@ public:
    virtual float CalcUtility() override;
    virtual void Run() override;
    virtual Behavior* Clone() override;
-   virtual void PopulateFromXMLNode(const XMLNode& blueprintNode) override;
    virtual bool DoesPassChanceToRun() override;
+   virtual UtilityScoringKernel* GetScoringKernel() const override { return &ScoreBatch; }
+
+   static void ScoreBatch(const UtilityInputs& inputs, UtilityScoringEntries& entries);
 
    static Behavior* CreateBehavior(const std::string& name, const XMLNode& blueprintNode) { return new WanderBehavior(name, blueprintNode); }
    static BehaviorRegistration s_wanderBehaviorRegistrastion;
@@ -29,7 +43,7 @@ public:
    virtual void WriteToXMLNode(XMLNode&) const override {};
 
 private:
-   float m_chanceToRest;
-   float m_chanceToGoStraight;
+   const WanderBehaviorBlueprint& GetBlueprint() const { return *(const WanderBehaviorBlueprint*)m_blueprint; }
+
    TileDirection m_lastDirection;
 };
\ No newline at end of file
@@ -0,0 +1,253 @@
+#include <stdio.h>
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Parsers/XMLUtilities.hpp"
+#include "Game/Entities/Agents/Factions/AgentRelations.hpp"
+#include "Game/Entities/Agents/Agent.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+AgentRelations::AgentRelations()
+   : m_factionID(Faction::INVALID_FACTION_ID)
+{
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Blueprints can give an agent its own take on other factions
+void AgentRelations::PopulateFromXMLNode(const XMLNode& factionNode)
+{
+   const FactionStatus statuses[] = { FACTION_STATUS_DISLIKES, FACTION_STATUS_HATES, FACTION_STATUS_NEUTRAL, FACTION_STATUS_LIKES, FACTION_STATUS_LOVES };
+   for (FactionStatus status : statuses)
+   {
+      std::vector<FactionID> factionIDs;
+      Faction::ReadFactionIDsWithStatus(factionNode, status, &factionIDs);
+      for (FactionID otherFactionID : factionIDs)
+      {
+         SetStandingOffset(&m_factionExceptions, otherFactionID, status - Faction::GetDefaultStanding(m_factionID, otherFactionID));
+      }
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int AgentRelations::GetStandingWithFaction(FactionID otherFactionID) const
+{
+   return Faction::GetDefaultStanding(m_factionID, otherFactionID) + GetStandingOffset(m_factionExceptions, otherFactionID);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// An agent is seen as its faction is, plus whatever it has done to this agent personally
+int AgentRelations::GetStandingWithAgent(EntityID agentID, FactionID agentFactionID) const
+{
+   return GetStandingWithFaction(agentFactionID) + GetStandingOffset(m_agentExceptions, agentID);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void AgentRelations::AdjustStanding(Agent* instigator, FactionAction action)
+{
+   int agentAdjustment = 0;
+   int factionAdjustment = 0;
+
+   switch (action)
+   {
+   case FA_TRIED_TO_ATTACK_ME:
+   {
+      agentAdjustment = -3;
+      factionAdjustment = -1;
+      break;
+   }
+
+   case FA_HIT_ME:
+   {
+      agentAdjustment = -15;
+      factionAdjustment = -5;
+      break;
+   }
+
+   case FA_TRIED_TO_HEAL_ME:
+   {
+      agentAdjustment = 5;
+      factionAdjustment = 2;
+      break;
+   }
+
+   case FA_HEALED_ME:
+   {
+      agentAdjustment = 10;
+      factionAdjustment = 3;
+      break;
+   }
+   }
+
+   EntityID agentID = instigator->GetID();
+   FactionID factionID = instigator->GetFactionID();
+   SetStandingOffset(&m_agentExceptions, agentID, GetStandingOffset(m_agentExceptions, agentID) + agentAdjustment);
+   SetStandingOffset(&m_factionExceptions, factionID, GetStandingOffset(m_factionExceptions, factionID) + factionAdjustment);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Faction standings are written whole, as they always were. Agent standings are written as offsets,
+// since the agent's faction isn't known here
+void AgentRelations::WriteToXMLNode(XMLNode& agentNode) const
+{
+   XMLNode factionNode = agentNode.addChild("Factions");
+
+   for (const StandingException& factionException : m_factionExceptions)
+   {
+      XMLNode factionRelationNode = factionNode.addChild("FactionRelationship");
+
+      char spareBuf[255];
+      snprintf(spareBuf, sizeof(spareBuf), "%d", factionException.id);
+      factionRelationNode.addAttribute("id", spareBuf);
+
+      snprintf(spareBuf, sizeof(spareBuf), "%d", GetStandingWithFaction(factionException.id));
+      factionRelationNode.addAttribute("standing", spareBuf);
+   }
+
+   for (const StandingException& agentException : m_agentExceptions)
+   {
+      XMLNode agentRelationNode = factionNode.addChild("AgentRelationship");
+
+      char spareBuf[255];
+      snprintf(spareBuf, sizeof(spareBuf), "%d", agentException.id);
+      agentRelationNode.addAttribute("id", spareBuf);
+
+      snprintf(spareBuf, sizeof(spareBuf), "%d", agentException.standingOffset);
+      agentRelationNode.addAttribute("offset", spareBuf);
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Older saves have a whole standing for every agent ever met. Those are kept until the agents are
+// loaded and only the ones that differ from the faction's standing survive
+void AgentRelations::LoadFromXMLNode(const XMLNode& saveNode)
+{
+   XMLNode factions = saveNode.getChildNode("Factions");
+
+   int factionRelationIndex = 0;
+   XMLNode factionRelationNode = factions.getChildNode("FactionRelationship", &factionRelationIndex);
+   while (!factionRelationNode.isEmpty())
+   {
+      FactionID otherFactionID = ReadXMLAttribute(factionRelationNode, "id", 0);
+      int standing = ReadXMLAttribute(factionRelationNode, "standing", 0);
+      SetStandingOffset(&m_factionExceptions, otherFactionID, standing - Faction::GetDefaultStanding(m_factionID, otherFactionID));
+
+      factionRelationNode = factions.getChildNode("FactionRelationship", &factionRelationIndex);
+   }
+
+   int agentRelationIndex = 0;
+   XMLNode agentRelationNode = factions.getChildNode("AgentRelationship", &agentRelationIndex);
+   while (!agentRelationNode.isEmpty())
+   {
+      EntityID savedAgentID = ReadXMLAttribute(agentRelationNode, "id", 0);
+      if (agentRelationNode.getAttribute("offset") != nullptr)
+      {
+         SetStandingOffset(&m_agentExceptions, savedAgentID, ReadXMLAttribute(agentRelationNode, "offset", 0));
+      }
+      else
+      {
+         StandingException savedStanding = { savedAgentID, ReadXMLAttribute(agentRelationNode, "standing", 0) };
+         m_loadedAgentStandings.push_back(savedStanding);
+      }
+
+      agentRelationNode = factions.getChildNode("AgentRelationship", &agentRelationIndex);
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Moves saved agent IDs over to the loaded agents' IDs. Agents that weren't saved are dropped
+void AgentRelations::ResolveEntityPointers(const std::map<int, Entity*>& loadedEntities)
+{
+   StandingExceptions savedOffsets;
+   savedOffsets.swap(m_agentExceptions);
+   for (const StandingException& savedOffset : savedOffsets)
+   {
+      std::map<int, Entity*>::const_iterator entityIter = loadedEntities.find(savedOffset.id);
+      if (entityIter != loadedEntities.end())
+      {
+         SetStandingOffset(&m_agentExceptions, entityIter->second->GetID(), savedOffset.standingOffset);
+      }
+   }
+
+   for (const StandingException& savedStanding : m_loadedAgentStandings)
+   {
+      std::map<int, Entity*>::const_iterator entityIter = loadedEntities.find(savedStanding.id);
+      if (entityIter == loadedEntities.end() || !entityIter->second->IsAgent())
+      {
+         continue;
+      }
+
+      Agent* agent = (Agent*)entityIter->second;
+      SetStandingOffset(&m_agentExceptions, agent->GetID(), savedStanding.standingOffset - GetStandingWithFaction(agent->GetFactionID()));
+   }
+   m_loadedAgentStandings.clear();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Index of the first exception with an ID at or past the one given
+STATIC int AgentRelations::FindExceptionIndex(const StandingExceptions& exceptions, int id)
+{
+   int lowIndex = 0;
+   int highIndex = (int)exceptions.size();
+   while (lowIndex < highIndex)
+   {
+      int middleIndex = (lowIndex + highIndex) / 2;
+      if (exceptions[middleIndex].id < id)
+      {
+         lowIndex = middleIndex + 1;
+      }
+      else
+      {
+         highIndex = middleIndex;
+      }
+   }
+
+   return lowIndex;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC int AgentRelations::GetStandingOffset(const StandingExceptions& exceptions, int id)
+{
+   int exceptionIndex = FindExceptionIndex(exceptions, id);
+   if (exceptionIndex < (int)exceptions.size() && exceptions[exceptionIndex].id == id)
+   {
+      return exceptions[exceptionIndex].standingOffset;
+   }
+
+   return 0;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// An offset of zero is no exception at all, so it isn't stored
+STATIC void AgentRelations::SetStandingOffset(StandingExceptions* exceptions, int id, int standingOffset)
+{
+   int exceptionIndex = FindExceptionIndex(*exceptions, id);
+   bool isPresent = (exceptionIndex < (int)exceptions->size() && (*exceptions)[exceptionIndex].id == id);
+
+   if (standingOffset == 0)
+   {
+      if (isPresent)
+      {
+         exceptions->erase(exceptions->begin() + exceptionIndex);
+      }
+      return;
+   }
+
+   if (isPresent)
+   {
+      (*exceptions)[exceptionIndex].standingOffset = standingOffset;
+   }
+   else
+   {
+      StandingException newException = { id, standingOffset };
+      exceptions->insert(exceptions->begin() + exceptionIndex, newException);
+   }
+}
\ No newline at end of file
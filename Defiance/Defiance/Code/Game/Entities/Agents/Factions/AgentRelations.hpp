@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+#include <map>
+#include "Game/Core/GameCommon.hpp"
+#include "Game/Entities/Agents/Factions/Faction.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+struct XMLNode;
+
+
+//-----------------------------------------------------------------------------------------------
+// How one agent stands with other factions and agents. Standings start from the faction matrix;
+// only where this agent's view has drifted from it (grudges, favors, blueprint overrides) is
+// stored, as offsets in small sorted arrays. An agent with no history costs nothing per agent met
+class AgentRelations
+{
+public:
+   AgentRelations();
+
+   void SetFactionID(FactionID factionID) { m_factionID = factionID; }
+   FactionID GetFactionID() const { return m_factionID; }
+   void PopulateFromXMLNode(const XMLNode& factionNode);
+
+   int GetStandingWithFaction(FactionID otherFactionID) const;
+   int GetStandingWithAgent(EntityID agentID, FactionID agentFactionID) const;
+   void AdjustStanding(Agent* instigator, FactionAction action);
+   int GetNumberOfExceptions() const { return (int)(m_factionExceptions.size() + m_agentExceptions.size()); }
+
+   void WriteToXMLNode(XMLNode& agentNode) const;
+   void LoadFromXMLNode(const XMLNode& saveNode);
+   void ResolveEntityPointers(const std::map<int, Entity*>& loadedEntities);
+
+private:
+   struct StandingException
+   {
+      int id;
+      int standingOffset;
+   };
+   typedef std::vector<StandingException> StandingExceptions;
+
+   static int FindExceptionIndex(const StandingExceptions& exceptions, int id);
+   static int GetStandingOffset(const StandingExceptions& exceptions, int id);
+   static void SetStandingOffset(StandingExceptions* exceptions, int id, int standingOffset);
+
+   FactionID m_factionID;
+   StandingExceptions m_factionExceptions;
+   StandingExceptions m_agentExceptions;
+
+   // Saves hold whole standings under the IDs agents had then. They become offsets once the agents
+   // they refer to are loaded
+   StandingExceptions m_loadedAgentStandings;
+};
\ No newline at end of file
@@ -1,48 +1,49 @@
 #include <vector>
 #include <string>
-#include <sstream>
 #include "Engine/IO/FileUtils.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/Tokenizer.hpp"
+#include "Engine/Debug/ErrorWarningAssert.hpp"
 #include "Engine/Parsers/XMLUtilities.hpp"
 #include "Game/Entities/Agents/Factions/Faction.hpp"
-#include "Game/Entities/Agents/Agent.hpp"
-#include "Game/Entities/Entity.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
 STATIC int Faction::s_nextID = 1;
 STATIC const int Faction::INVALID_FACTION_ID = 0;
 STATIC FactionMap* Faction::s_globalFactionMap = nullptr;
-
-
-//-----------------------------------------------------------------------------------------------
-Faction::Faction()
-   : m_name("Uninitialized Faction")
-   , m_factionID(INVALID_FACTION_ID)
-{}
+STATIC std::vector<int> Faction::s_standingMatrix;
+STATIC int Faction::s_standingMatrixSize = 0;
 
 
 //-----------------------------------------------------------------------------------------------
 Faction::Faction(const std::string& name)
    : m_name(name)
    , m_factionID(s_nextID++)
-{}
+{
+   ResizeStandingMatrix(s_nextID);
+}
 
 
 //-----------------------------------------------------------------------------------------------
 void Faction::PopulateFromXMLNode(const XMLNode& factionNode)
 {
-   PopulateGivenStatusFromNode(factionNode, FACTION_STATUS_DISLIKES);
-   PopulateGivenStatusFromNode(factionNode, FACTION_STATUS_HATES);
-   PopulateGivenStatusFromNode(factionNode, FACTION_STATUS_NEUTRAL);
-   PopulateGivenStatusFromNode(factionNode, FACTION_STATUS_LIKES);
-   PopulateGivenStatusFromNode(factionNode, FACTION_STATUS_LOVES);
+   const FactionStatus statuses[] = { FACTION_STATUS_DISLIKES, FACTION_STATUS_HATES, FACTION_STATUS_NEUTRAL, FACTION_STATUS_LIKES, FACTION_STATUS_LOVES };
+   for (FactionStatus status : statuses)
+   {
+      std::vector<FactionID> factionIDs;
+      ReadFactionIDsWithStatus(factionNode, status, &factionIDs);
+      for (FactionID otherFactionID : factionIDs)
+      {
+         SetDefaultStanding(m_factionID, otherFactionID, status);
+      }
+   }
 }
 
 
 //-----------------------------------------------------------------------------------------------
-void Faction::PopulateGivenStatusFromNode(const XMLNode& factionNode, FactionStatus status)
+// The status attribute is a comma separated list of faction names, created if they don't exist yet
+STATIC void Faction::ReadFactionIDsWithStatus(const XMLNode& factionNode, FactionStatus status, std::vector<FactionID>* outFactionIDs)
 {
    std::string statusAsString = GetFactionStatusAsString(status);
    std::string listOfStatus = ReadXMLAttribute(factionNode, statusAsString, std::string(""));
@@ -51,192 +52,53 @@ void Faction::PopulateGivenStatusFromNode(const XMLNode& factionNode, FactionSta
 
    while (statusFactionName.compare(""))
    {
-      Faction* dislikedFaction = CreateOrGetFactionByName(statusFactionName);
-      FactionRelationship newDislikeRelationship = { status, statusFactionName };
-      FactionRelationshipPair dislikedFactionPair(dislikedFaction->GetFactionID(), newDislikeRelationship);
-      m_factionRelations.insert(dislikedFactionPair);
-
+      outFactionIDs->push_back(CreateOrGetFactionByName(statusFactionName)->GetFactionID());
       statusFactionName = statusTokens.GetNextToken();
    }
 }
 
 
 //-----------------------------------------------------------------------------------------------
-bool Faction::IsAgentRelationPresent(EntityID agentID) const
-{
-   bool isAgentPresent = (m_agentRelations.find(agentID) != m_agentRelations.end());
-   return isAgentPresent;
-}
-
-
-//-----------------------------------------------------------------------------------------------
-bool Faction::IsFactionRelationPresent(FactionID factionID) const
-{
-   bool isFactionPresent = (m_factionRelations.find(factionID) != m_factionRelations.end());
-   return isFactionPresent;
-}
-
-
-//-----------------------------------------------------------------------------------------------
-void Faction::AddAgentRelation(EntityID agentID, const std::string& name, int standing)
+// Factions nobody wrote a status for are neutral
+STATIC int Faction::GetDefaultStanding(FactionID factionID, FactionID otherFactionID)
 {
-   FactionRelationship newRelationship = { standing, name };
-   FactionRelationshipPair newAgent(agentID, newRelationship);
-   m_agentRelations.insert(newAgent);
-}
-
-
-//-----------------------------------------------------------------------------------------------
-void Faction::AddFactionRelation(FactionID factionID, const std::string& name, int standing)
-{
-   FactionRelationship newRelationship = { standing, name };
-   FactionRelationshipPair newFaction(factionID, newRelationship);
-   m_factionRelations.insert(newFaction);
-}
-
-
-//-----------------------------------------------------------------------------------------------
-int Faction::GetFactionStandingWithAgent(EntityID agentID) const
-{
-   return m_agentRelations.find(agentID)->second.relationshipStanding;
-}
-
-
-//-----------------------------------------------------------------------------------------------
-void Faction::SetFactionStandingWithAgent(EntityID agentID, int standing)
-{
-   m_agentRelations[agentID].relationshipStanding = standing;
-}
-
-
-//-----------------------------------------------------------------------------------------------
-int Faction::GetFactionStandingWithFaction(FactionID factionID) const
-{
-   return m_factionRelations.find(factionID)->second.relationshipStanding;
-}
-
-
-//-----------------------------------------------------------------------------------------------
-void Faction::SetFactionStandingWithFaction(FactionID factionID, int standing)
-{
-   m_factionRelations[factionID].relationshipStanding = standing;
-}
-
-
-//-----------------------------------------------------------------------------------------------
-void Faction::RemoveAgentRelationship(EntityID agentID)
-{
-   m_agentRelations.erase(agentID);
-}
-
-
-//-----------------------------------------------------------------------------------------------
-void Faction::AdjustFactionStatus(Agent* instigator, FactionAction action)
-{
-   EntityID entityID = instigator->GetID();
-   FactionID factionID = instigator->GetFactionID();
-
-   switch (action)
+   if (factionID < 0 || factionID >= s_standingMatrixSize || otherFactionID < 0 || otherFactionID >= s_standingMatrixSize)
    {
-   case FA_TRIED_TO_ATTACK_ME:
-   {
-      m_agentRelations[entityID].relationshipStanding -= 3;
-      m_factionRelations[factionID].relationshipStanding -= 1;
-      break;
+      return FACTION_STATUS_NEUTRAL;
    }
 
-   case FA_HIT_ME:
-   {
-      m_agentRelations[entityID].relationshipStanding -= 15;
-      m_factionRelations[factionID].relationshipStanding -= 5;
-      break;
-   }
-
-   case FA_TRIED_TO_HEAL_ME:
-   {
-      m_agentRelations[entityID].relationshipStanding += 5;
-      m_factionRelations[factionID].relationshipStanding += 2;
-      break;
-   }
-
-   case FA_HEALED_ME:
-   {
-      m_agentRelations[entityID].relationshipStanding += 10;
-      m_factionRelations[factionID].relationshipStanding += 3;
-      break;
-   }
-   }
+   return s_standingMatrix[(factionID * s_standingMatrixSize) + otherFactionID];
 }
 
 
 //-----------------------------------------------------------------------------------------------
-void Faction::WriteToXMLNode(XMLNode& agentNode) const
+STATIC void Faction::SetDefaultStanding(FactionID factionID, FactionID otherFactionID, int standing)
 {
-   XMLNode factionNode = agentNode.addChild("Factions");
-
-   FactionRelationshipMap::const_iterator factionIter = m_factionRelations.begin();
-   while (factionIter != m_factionRelations.end())
-   {
-      XMLNode factionRelationNode = factionNode.addChild("FactionRelationship");
-      int id = factionIter->first;
-      int standing = factionIter->second.relationshipStanding;
-
-      char spareBuf[255];
-      _itoa_s(id, spareBuf, 10);
-      factionRelationNode.addAttribute("id", spareBuf);
-
-      _itoa_s(standing, spareBuf, 10);
-      factionRelationNode.addAttribute("standing", spareBuf);
-
-      ++factionIter;
-   }
-
-   FactionRelationshipMap::const_iterator agentIter = m_agentRelations.begin();
-   while (agentIter != m_agentRelations.end())
-   {
-      XMLNode agentRelationNode = factionNode.addChild("AgentRelationship");
-      int id = agentIter->first;
-      int standing = agentIter
-         ->second.relationshipStanding;
-
-      char spareBuf[255];
-      _itoa_s(id, spareBuf, 10);
-      agentRelationNode.addAttribute("id", spareBuf);
-
-      _itoa_s(standing, spareBuf, 10);
-      agentRelationNode.addAttribute("standing", spareBuf);
-
-      ++agentIter;
-   }
+   ASSERT_OR_DIE(factionID >= 0 && factionID < s_standingMatrixSize && otherFactionID >= 0 && otherFactionID < s_standingMatrixSize, "Faction ID outside the standing matrix");
+   s_standingMatrix[(factionID * s_standingMatrixSize) + otherFactionID] = standing;
 }
 
 
 //-----------------------------------------------------------------------------------------------
-void Faction::LoadFromXMLNode(const XMLNode& saveNode)
+// Factions are only created while blueprints load, so this never runs while agents are reading it
+STATIC void Faction::ResizeStandingMatrix(int numFactionIDs)
 {
-   XMLNode factions = saveNode.getChildNode("Factions");
-
-   int factionRelationIndex = 0;
-   XMLNode factionRelationNode = factions.getChildNode("FactionRelationship", &factionRelationIndex);
-   while (!factionRelationNode.isEmpty())
+   if (numFactionIDs <= s_standingMatrixSize)
    {
-      FactionID idToAdjust = ReadXMLAttribute(factionRelationNode, "id", 0);
-      int standing = ReadXMLAttribute(factionRelationNode, "standing", 0);
-      SetFactionStandingWithFaction(idToAdjust, standing);
-
-      factionRelationNode = factions.getChildNode("FactionRelationship", &factionRelationIndex);
+      return;
    }
 
-   int agentRelationIndex = 0;
-   XMLNode agentRelationNode = factions.getChildNode("AgentRelationship", &agentRelationIndex);
-   while (!agentRelationNode.isEmpty())
+   std::vector<int> resizedMatrix(numFactionIDs * numFactionIDs, FACTION_STATUS_NEUTRAL);
+   for (int row = 0; row < s_standingMatrixSize; ++row)
    {
-      EntityID tempAgentID = ReadXMLAttribute(agentRelationNode, "id", 0);
-      int standing = ReadXMLAttribute(agentRelationNode, "standing", 0);
-      AddAgentRelation(tempAgentID, "", standing);
-
-      agentRelationNode = factions.getChildNode("AgentRelationship", &agentRelationIndex);
+      for (int column = 0; column < s_standingMatrixSize; ++column)
+      {
+         resizedMatrix[(row * numFactionIDs) + column] = s_standingMatrix[(row * s_standingMatrixSize) + column];
+      }
    }
+
+   s_standingMatrix.swap(resizedMatrix);
+   s_standingMatrixSize = numFactionIDs;
 }
 
 
@@ -309,6 +171,10 @@ STATIC void Faction::FreeAllFactions()
    }
 
    delete s_globalFactionMap;
+   s_globalFactionMap = nullptr;
+
+   s_standingMatrix.clear();
+   s_standingMatrixSize = 0;
 }
 
 
@@ -328,21 +194,3 @@ STATIC Faction* Faction::CreateOrGetFactionByName(const std::string& name)
    s_globalFactionMap->insert(newFactionPair);
    return newFaction;
 }
-
-
-//-----------------------------------------------------------------------------------------------
-void Faction::ResolveEntityPointers(const std::map<int, Entity*>& loadedEntities)
-{
-   FactionRelationshipMap updatedMap;
-   for (FactionRelationshipMap::iterator agentIter = m_agentRelations.begin(); agentIter != m_agentRelations.end(); ++agentIter)
-   {
-      int oldID = agentIter->first;
-      int relationshipStanding = agentIter->second.relationshipStanding;
-      std::string name = agentIter->second.name;
-      Entity* replacementEntity = loadedEntities.at(oldID);
-      FactionRelationship replacementRelationship = { relationshipStanding, replacementEntity->GetName() };
-      updatedMap.insert(FactionRelationshipPair(replacementEntity->GetID(), replacementRelationship));
-   }
-
-   m_agentRelations = updatedMap;
-}
\ No newline at end of file
@@ -2,12 +2,12 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include "Game/Core/GameCommon.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
 struct XMLNode;
-class Entity;
 
 
 //-----------------------------------------------------------------------------------------------
@@ -32,16 +32,6 @@ enum FactionAction
 };
 
 
-//-----------------------------------------------------------------------------------------------
-struct FactionRelationship
-{
-   int relationshipStanding;
-   std::string name;
-};
-typedef std::map<int, FactionRelationship> FactionRelationshipMap;
-typedef std::pair<int, FactionRelationship> FactionRelationshipPair;
-
-
 //-----------------------------------------------------------------------------------------------
 class Faction;
 typedef std::map<std::string, Faction*> FactionMap;
@@ -50,31 +40,20 @@ typedef FactionMap::iterator FactionMapIter;
 
 
 //-----------------------------------------------------------------------------------------------
+// A faction's name and ID. How every faction stands with every other by default lives in one
+// dense matrix indexed by FactionID, filled from the faction files. Agents only store where
+// they differ from it (see AgentRelations)
 class Faction
 {
 public:
-   Faction();
-
    void PopulateFromXMLNode(const XMLNode& factionNode);
-   void PopulateGivenStatusFromNode(const XMLNode& factionNode, FactionStatus status);
 
    const std::string& GetName() const { return m_name; }
    FactionID GetFactionID() const { return m_factionID; }
 
-   bool IsAgentRelationPresent(EntityID agentID) const;
-   bool IsFactionRelationPresent(FactionID factionID) const;
-   void AddAgentRelation(EntityID agentID, const std::string& name, int standing);
-   void AddFactionRelation(FactionID, const std::string& name, int standing);
-   int GetFactionStandingWithAgent(EntityID agentID) const;
-   void SetFactionStandingWithAgent(EntityID agentID, int standing);
-   int GetFactionStandingWithFaction(FactionID factionID) const;
-   void SetFactionStandingWithFaction(FactionID factionID, int standing);
-   void RemoveAgentRelationship(EntityID agentID);
-   void AdjustFactionStatus(Agent* instigator, FactionAction action);
-
-   void WriteToXMLNode(XMLNode& agentNode) const;
-   void LoadFromXMLNode(const XMLNode& saveNode);
-   void ResolveEntityPointers(const std::map<int, Entity*>& loadedEntities);
+   static void ReadFactionIDsWithStatus(const XMLNode& factionNode, FactionStatus status, std::vector<FactionID>* outFactionIDs);
+   static int GetDefaultStanding(FactionID factionID, FactionID otherFactionID);
+   static void SetDefaultStanding(FactionID factionID, FactionID otherFactionID, int standing);
 
    static std::string GetFactionStatusAsString(FactionStatus status);
    static void LoadAllFactions();
@@ -87,9 +66,15 @@ public:
 
 private:
    Faction(const std::string& name);
+   Faction(const Faction&);
+   Faction& operator=(const Faction&);
+
+   static void ResizeStandingMatrix(int numFactionIDs);
 
    std::string m_name;
    FactionID m_factionID;
-   FactionRelationshipMap m_factionRelations;
-   FactionRelationshipMap m_agentRelations;   
+
+   // Row is the faction doing the judging, column the faction being judged
+   static std::vector<int> s_standingMatrix;
+   static int s_standingMatrixSize;
 };
\ No newline at end of file
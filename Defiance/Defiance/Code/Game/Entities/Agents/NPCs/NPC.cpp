@@ -1,8 +1,40 @@
+#include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Parsers/XMLUtilities.hpp"
 #include "Game/Entities/Agents/NPCs/NPC.hpp"
 #include "Game/Entities/Agents/Behaviors/Behavior.hpp"
 
 
+//-----------------------------------------------------------------------------------------------
+STATIC const int NPC::NUM_NPCS_PER_SLAB = 64;
+STATIC ObjectPool<NPC> NPC::s_objectPool(NPC::NUM_NPCS_PER_SLAB);
+
+
+//-----------------------------------------------------------------------------------------------
+// Anything derived from NPC won't fit the pool's cells, so it goes to the global heap
+STATIC void* NPC::operator new(size_t numBytes)
+{
+   if (numBytes != sizeof(NPC))
+   {
+      return ::operator new(numBytes);
+   }
+
+   return s_objectPool.Allocate();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC void NPC::operator delete(void* object, size_t numBytes)
+{
+   if (numBytes != sizeof(NPC))
+   {
+      ::operator delete(object);
+      return;
+   }
+
+   s_objectPool.Free(object);
+}
+
+
 //-----------------------------------------------------------------------------------------------
 NPC::NPC(const XMLNode& blueprintNode)
    : Agent(blueprintNode)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Engine/Core/ObjectPool.hpp"
 #include "Game/Entities/Agents/Agent.hpp"
 
 
@@ -16,6 +17,13 @@ public:
    NPC(const NPC& copySource);
    NPC(const NPC& copySource, const XMLNode& node);
 
+   // Instances live in s_objectPool, so the factories and every delete go through it
+   static void* operator new(size_t numBytes);
+   static void operator delete(void* object, size_t numBytes);
+
+   static ObjectPool<NPC> s_objectPool;
+   static const int NUM_NPCS_PER_SLAB;
+
    void PopulateFromXMLNode(const XMLNode& blueprintNode);
    void PopulateBehaviorsFromXMLNode(const XMLNode& behaviorRootNode);
 
@@ -7,6 +7,7 @@
 #include "Engine/Parsers/XMLUtilities.hpp"
 #include "Engine/Debug/ErrorWarningAssert.hpp"
 #include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Game/Entities/Agents/NPCs/NPCFactory.hpp"
 #include "Game/Entities/Agents/NPCs/NPC.hpp"
 
@@ -37,11 +38,11 @@ NPCFactory::~NPCFactory()
 
 
 //-----------------------------------------------------------------------------------------------
-NPC* NPCFactory::CreateNPC() const
+NPC* NPCFactory::CreateNPC(RandomNumberGenerator* random) const
 {
    NPC* newNPC = new NPC(*m_blueprint);
    
-   int npcHealth = GetRandomIntBetweenInclusive(m_minHealth, m_maxHealth);
+   int npcHealth = random->GetIntBetweenInclusive(m_minHealth, m_maxHealth);
    
    newNPC->SetMaxHealth(npcHealth);
    newNPC->SetCurrentHealth(npcHealth);
@@ -116,13 +117,13 @@ STATIC NPC* NPCFactory::CreateNPCFromXMLNode(const XMLNode& node)
 
 
 //-----------------------------------------------------------------------------------------------
-STATIC NPC* NPCFactory::CreateByName(const std::string& name)
+STATIC NPC* NPCFactory::CreateByName(const std::string& name, RandomNumberGenerator* random)
 {
    NPCFactoryMap::iterator factoryIter = s_factoryMap->find(name);
    ASSERT_OR_DIE(factoryIter != s_factoryMap->end(), Stringf("ERROR: No factory found for NPC %s", name.c_str()));
    
    NPCFactory* targetFactory = factoryIter->second;
-   return targetFactory->CreateNPC();
+   return targetFactory->CreateNPC(random);
 }
 
 
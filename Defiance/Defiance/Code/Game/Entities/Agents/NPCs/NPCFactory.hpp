@@ -7,6 +7,7 @@
 //-----------------------------------------------------------------------------------------------
 class NPC;
 struct XMLNode;
+class RandomNumberGenerator;
 class NPCFactory;
 typedef std::map<std::string, NPCFactory*> NPCFactoryMap;
 
@@ -18,13 +19,13 @@ public:
    NPCFactory(const XMLNode& npcBlueprintNode);
    ~NPCFactory();
 
-   NPC* CreateNPC() const;
+   NPC* CreateNPC(RandomNumberGenerator* random) const;
    NPC* CreateFromNode(const XMLNode& node) const;
 
    static void LoadAllNPCBlueprints();
    static void FreeAllNPCBlueprints();
    static NPC* CreateNPCFromXMLNode(const XMLNode& node);
-   static NPC* CreateByName(const std::string& name);
+   static NPC* CreateByName(const std::string& name, RandomNumberGenerator* random);
    static NPCFactoryMap* s_factoryMap;
 
 private:
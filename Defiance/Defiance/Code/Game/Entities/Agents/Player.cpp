@@ -1,14 +1,20 @@
+#include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Parsers/XMLUtilities.hpp"
 #include "Game/Entities/Agents/Player.hpp"
 #include "Game/Core/TheGame.hpp"
+#include "Game/Core/GameContext.hpp"
 #include "Game/FieldOfView/FieldOfViewAdvanced.hpp"
 #include "Game/Combat/DefianceCombatSystem.hpp"
 #include "Game/UI/GameMessageBox.hpp"
 
 
+//-----------------------------------------------------------------------------------------------
+STATIC const int Player::VIEW_DISTANCE = 20;
+
+
 //-----------------------------------------------------------------------------------------------
 Player::Player(int health, EntityType type, const TileCoords& position, char glyph, const Rgba& color, const Rgba& backgroundColor, const std::string& name)
    : Agent(health, type, position, glyph, color, backgroundColor, name)
@@ -17,8 +23,10 @@ Player::Player(int health, EntityType type, const TileCoords& position, char gly
    , m_isReadyToUpdate(false)
    , m_speedMultiplier(1.f)
    , m_turnsUntilSpeedBuffFinished(0)
+   , m_viewMins(0, 0)
+   , m_viewMaxs(-1, -1)
 {
-   m_faction = *Faction::CreateOrGetFactionByName("Player");
+   m_relations.SetFactionID(Faction::CreateOrGetFactionByName("Player")->GetFactionID());
 }
 
 
@@ -30,8 +38,10 @@ Player::Player(const XMLNode& playerNode)
    , m_isReadyToUpdate(false)
    , m_speedMultiplier(1.f)
    , m_turnsUntilSpeedBuffFinished(0)
+   , m_viewMins(0, 0)
+   , m_viewMaxs(-1, -1)
 {
-   m_faction = *Faction::CreateOrGetFactionByName("Player"); 
+   m_relations.SetFactionID(Faction::CreateOrGetFactionByName("Player")->GetFactionID()); 
    PopulateFromXMLNode(playerNode);
 }
 
@@ -132,11 +142,25 @@ float Player::Update()
 
 
 //-----------------------------------------------------------------------------------------------
+// The FOV only visits tiles around the player, so whatever it showed last time is hidden first
 void Player::UpdateFOV()
 {
    m_visibleAgents.clear();
+
+   const Vector2i& mapDimensions = m_gameMap->GetDimensions();
+   int maxY = (m_viewMaxs.y < mapDimensions.y) ? m_viewMaxs.y : mapDimensions.y - 1;
+   int maxX = (m_viewMaxs.x < mapDimensions.x) ? m_viewMaxs.x : mapDimensions.x - 1;
+   for (int yIndex = m_viewMins.y; yIndex <= maxY; ++yIndex)
+   {
+      for (int xIndex = m_viewMins.x; xIndex <= maxX; ++xIndex)
+      {
+         m_gameMap->GetTileAtTileCoords(TileCoords(xIndex, yIndex))->isVisible = false;
+      }
+   }
+
    FieldOfViewAdvanced fov;
-   fov.CalculateFieldOfViewForAgent(this, 20, m_gameMap, true);
+   fov.CalculateFieldOfViewForAgent(this, VIEW_DISTANCE, m_gameMap, true);
+   FieldOfView::GetViewBounds(m_position, VIEW_DISTANCE, m_gameMap, &m_viewMins, &m_viewMaxs);
 }
 
 
@@ -263,7 +287,7 @@ void Player::UseRandomItem()
 
    // Is medkit
    const IntRange& healingPower = itemToUse->GetHealingPower();
-   int healAmount = GetRandomIntBetweenInclusive(healingPower);
+   int healAmount = g_theGame->GetGameContext()->combatRandom.GetIntBetweenInclusive(healingPower);
 
    m_currentHealth += healAmount;
    if (m_currentHealth > m_maxHealth)
@@ -41,6 +41,8 @@ public:
    bool IsPlayer() const { return true; }
    virtual bool IsReadyToUpdate() const override;
 
+   static const int VIEW_DISTANCE;
+
 private:
    void PopulateFromXMLNode(const XMLNode& playerNode);
 
@@ -49,4 +51,6 @@ private:
    bool m_isReadyToUpdate;
    float m_speedMultiplier;
    int m_turnsUntilSpeedBuffFinished;
+   TileCoords m_viewMins;
+   TileCoords m_viewMaxs;
 };
\ No newline at end of file
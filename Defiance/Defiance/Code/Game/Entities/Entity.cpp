@@ -1,16 +1,20 @@
+#include <stdio.h>
+#include <string.h>
 #include <string>
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/EngineCommon.hpp"
-#include "Engine/Renderer/TheRenderer.hpp"
-#include "Engine/Renderer/BitmapFont.hpp"
 #include "Engine/Parsers/XMLUtilities.hpp"
 #include "Game/Entities/Entity.hpp"
+#include "Game/Entities/EntityRegistry.hpp"
 #include "Game/Map/Map.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
-STATIC int Entity::s_nextID = 1;
+// Features are created on the map generation worker too
+STATIC std::atomic<int> Entity::s_nextID(1);
 STATIC const int Entity::INVALID_ENTITY_ID = -1;
+STATIC std::set<std::string> Entity::s_sharedNames;
+STATIC std::mutex Entity::s_sharedNamesMutex;
 
 
 //-----------------------------------------------------------------------------------------------
@@ -22,8 +26,11 @@ Entity::Entity()
    , m_position(TileCoords::ZERO)
    , m_color(Rgba::YELLOW)
    , m_backgroundColor(Rgba::BLACK)
-   , m_name("Invalid Entity")
+   , m_name(GetSharedName("Invalid Entity"))
+   , m_gridCellIndex(-1)
+   , m_gridSlot(-1)
 {
+   m_handle = EntityRegistry::Register(this);
 }
 
 
@@ -49,7 +56,7 @@ Entity::Entity(const XMLNode& blueprintNode)
 
    m_color = ReadXMLAttribute(blueprintNode, "color", m_color);
    m_backgroundColor = ReadXMLAttribute(blueprintNode, "backgroundColor", m_backgroundColor);
-   m_name = ReadXMLAttribute(blueprintNode, "name", std::string(""));
+   m_name = GetSharedName(ReadXMLAttribute(blueprintNode, "name", std::string("")));
 }
 
 
@@ -62,8 +69,11 @@ Entity::Entity(int health, EntityType type, const TileCoords& position, const Rg
    , m_position(position)
    , m_color(color)
    , m_backgroundColor(backgroundColor)
-   , m_name(name)
+   , m_name(GetSharedName(name))
+   , m_gridCellIndex(-1)
+   , m_gridSlot(-1)
 {
+   m_handle = EntityRegistry::Register(this);
 }
 
 
@@ -77,7 +87,19 @@ Entity::Entity(const Entity& copySource)
    , m_color(copySource.m_color)
    , m_backgroundColor(copySource.m_backgroundColor)
    , m_name(copySource.m_name)
+   , m_gridCellIndex(-1)
+   , m_gridSlot(-1)
 {
+   // A copy is a new entity, so it gets its own handle
+   m_handle = EntityRegistry::Register(this);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Every handle still pointing here resolves to nullptr from now on
+Entity::~Entity()
+{
+   EntityRegistry::Unregister(m_handle);
 }
 
 
@@ -98,17 +120,17 @@ bool Entity::WriteToXMLNode(XMLNode& entityNode) const
    // Used for itoa and the like
    char spareBuf[255];
 
-   entityNode.addAttribute("name", m_name.c_str());
+   entityNode.addAttribute("name", m_name->c_str());
 
-   _itoa_s(m_ID, spareBuf, 10);
+   snprintf(spareBuf, sizeof(spareBuf), "%d", m_ID);
    entityNode.addAttribute("EntityID", spareBuf);
 
-   _itoa_s(m_maxHealth, spareBuf, 10);
+   snprintf(spareBuf, sizeof(spareBuf), "%d", m_maxHealth);
    entityNode.addAttribute("maxHealth", spareBuf);
 
    if (m_currentHealth != m_maxHealth)
    {
-      _itoa_s(m_currentHealth, spareBuf, 10);
+      snprintf(spareBuf, sizeof(spareBuf), "%d", m_currentHealth);
       entityNode.addAttribute("currentHealth", spareBuf);
    }
 
@@ -128,6 +150,15 @@ void Entity::LoadFromXMLNode(const XMLNode& saveNode)
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Set nodes never move, so the pointer stays good for the rest of the program
+STATIC const std::string* Entity::GetSharedName(const std::string& name)
+{
+   std::lock_guard<std::mutex> lock(s_sharedNamesMutex);
+   return &(*s_sharedNames.insert(name).first);
+}
+
+
 //-----------------------------------------------------------------------------------------------
 bool Entity::operator==(const Entity& rhs) const
 {
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <string>
+#include <atomic>
+#include <set>
+#include <mutex>
 #include "Engine/Renderer/Rgba.hpp"
 #include "Engine/Math/Vector2i.hpp"
 #include "Game/Core/GameCommon.hpp"
@@ -30,7 +33,7 @@ public:
    Entity(const XMLNode& blueprintNode);
    Entity(int health, EntityType type, const TileCoords& position, const Rgba& color, const Rgba& backgroundColor, const std::string& name);
    Entity(const Entity& copySource);
-   virtual ~Entity() {}
+   virtual ~Entity();
 
    virtual bool IsReadyToUpdate() const { return true; }
    virtual float Update() { return 1.f; };
@@ -40,16 +43,16 @@ public:
    virtual bool IsFeature() const { return false; }
 
    virtual void AddToMap(Map* map, const TileCoords& position);
-   virtual void DereferenceEntity(Entity*) {}
 
    EntityType GetEntityType() const { return m_entityType; }
    EntityID GetID() const { return m_ID; }
+   const EntityHandle& GetHandle() const { return m_handle; }
    Map* GetMap() const { return m_gameMap; }
    int GetCurrentHealth() const { return m_currentHealth; }
    int GetMaxHealth() const { return m_maxHealth; }
    const Rgba& GetColor() const { return m_color; }
    const TileCoords& GetPosition() const { return m_position; }
-   const std::string& GetName() const { return m_name; }
+   const std::string& GetName() const { return *m_name; }
    bool IsAlive() const { return m_currentHealth > 0; }
    bool IsAtMaxHealth() const { return m_currentHealth == m_maxHealth; }
 
@@ -57,6 +60,11 @@ public:
    void SetCurrentHealth(int newCurrentHealth) { m_currentHealth = newCurrentHealth; }
    void SetPosition(const TileCoords& position) { m_position = position; }
 
+   // Cell and slot in a map's EntitySpatialGrid, -1 when the entity isn't in one. Only the grid sets them
+   int GetGridCellIndex() const { return m_gridCellIndex; }
+   int GetGridSlot() const { return m_gridSlot; }
+   void SetGridLocation(int cellIndex, int slot) { m_gridCellIndex = cellIndex; m_gridSlot = slot; }
+
    virtual bool WriteToXMLNode(XMLNode& entityNode) const;
    virtual void LoadFromXMLNode(const XMLNode& saveNode);
 
@@ -65,17 +73,27 @@ public:
 
    bool virtual operator==(const Entity& rhs) const;
 
-   static int s_nextID;
+   // Every entity with the same name points at one copy of it, so spawning from a blueprint copies a pointer
+   static const std::string* GetSharedName(const std::string& name);
+
+   static std::atomic<int> s_nextID;
    static const int INVALID_ENTITY_ID;
 
 protected:
    int m_currentHealth;
    int m_maxHealth;
    EntityID m_ID;
+   EntityHandle m_handle;
    EntityType m_entityType;
    TileCoords m_position;
    Rgba m_color;
    Rgba m_backgroundColor;
-   std::string m_name;
+   const std::string* m_name;
    Map* m_gameMap;
+   int m_gridCellIndex;
+   int m_gridSlot;
+
+private:
+   static std::set<std::string> s_sharedNames;
+   static std::mutex s_sharedNamesMutex;
 };
\ No newline at end of file
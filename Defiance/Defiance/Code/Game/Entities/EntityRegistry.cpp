@@ -0,0 +1,106 @@
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Debug/ErrorWarningAssert.hpp"
+#include "Game/Entities/EntityRegistry.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC const int EntityRegistry::SLOTS_PER_PAGE = 1024;
+STATIC const int EntityRegistry::MAX_PAGES = 4096;
+STATIC std::mutex EntityRegistry::s_registryMutex;
+STATIC std::vector<EntityRegistry::EntitySlot*> EntityRegistry::s_pages(EntityRegistry::MAX_PAGES, nullptr);
+STATIC std::vector<unsigned int> EntityRegistry::s_freeSlots;
+STATIC std::atomic<unsigned int> EntityRegistry::s_numSlots(0);
+STATIC std::atomic<int> EntityRegistry::s_numRegisteredEntities(0);
+
+
+//-----------------------------------------------------------------------------------------------
+// Reuses the most recently freed slot. Generation 0 is never handed out, so a default handle is null
+STATIC EntityHandle EntityRegistry::Register(Entity* entity)
+{
+   std::lock_guard<std::mutex> lock(s_registryMutex);
+
+   unsigned int slotIndex = 0;
+   if (!s_freeSlots.empty())
+   {
+      slotIndex = s_freeSlots.back();
+      s_freeSlots.pop_back();
+   }
+   else
+   {
+      slotIndex = s_numSlots;
+      unsigned int pageIndex = slotIndex / SLOTS_PER_PAGE;
+      ASSERT_OR_DIE(pageIndex < (unsigned int)MAX_PAGES, "ERROR: Entity registry is full!");
+
+      if (s_pages[pageIndex] == nullptr)
+      {
+         EntitySlot* page = new EntitySlot[SLOTS_PER_PAGE];
+         for (int pageSlotIndex = 0; pageSlotIndex < SLOTS_PER_PAGE; ++pageSlotIndex)
+         {
+            page[pageSlotIndex].entity = nullptr;
+            page[pageSlotIndex].generation = 1;
+         }
+         s_pages[pageIndex] = page;
+      }
+
+      // Publish the slot only once its page exists
+      s_numSlots = slotIndex + 1;
+   }
+
+   EntitySlot* slot = GetSlot(slotIndex);
+   slot->entity = entity;
+   ++s_numRegisteredEntities;
+   return EntityHandle(slotIndex, slot->generation);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC void EntityRegistry::Unregister(const EntityHandle& handle)
+{
+   std::lock_guard<std::mutex> lock(s_registryMutex);
+
+   EntitySlot* slot = GetSlot(handle.index);
+   if (slot == nullptr || slot->generation != handle.generation)
+   {
+      return;
+   }
+
+   slot->entity = nullptr;
+
+   // Skip 0 on wrap around so stale handles can never look null-and-valid
+   unsigned int nextGeneration = handle.generation + 1;
+   slot->generation = (nextGeneration != 0) ? nextGeneration : 1;
+
+   s_freeSlots.push_back(handle.index);
+   --s_numRegisteredEntities;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC Entity* EntityRegistry::Resolve(const EntityHandle& handle)
+{
+   if (handle.IsNull())
+   {
+      return nullptr;
+   }
+
+   EntitySlot* slot = GetSlot(handle.index);
+   if (slot == nullptr || slot->generation != handle.generation)
+   {
+      return nullptr;
+   }
+
+   return slot->entity;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC EntityRegistry::EntitySlot* EntityRegistry::GetSlot(unsigned int index)
+{
+   if (index >= s_numSlots)
+   {
+      return nullptr;
+   }
+
+   return &s_pages[index / SLOTS_PER_PAGE][index % SLOTS_PER_PAGE];
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "Game/Core/GameCommon.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+class Entity;
+
+
+//-----------------------------------------------------------------------------------------------
+// Every live entity has a slot here, taken in its constructor and given back in its destructor.
+// Giving a slot back bumps its generation, so every handle to the old entity resolves to nullptr
+// without anyone having to be told. Slots live in fixed pages that never move, so the main thread
+// can resolve handles while a generation worker registers features
+class EntityRegistry
+{
+public:
+   static EntityHandle Register(Entity* entity);
+   static void Unregister(const EntityHandle& handle);
+   static Entity* Resolve(const EntityHandle& handle);
+   static int GetNumberOfRegisteredEntities() { return s_numRegisteredEntities; }
+
+   static const int SLOTS_PER_PAGE;
+   static const int MAX_PAGES;
+
+private:
+   struct EntitySlot
+   {
+      std::atomic<Entity*> entity;
+      std::atomic<unsigned int> generation;
+   };
+
+   static EntitySlot* GetSlot(unsigned int index);
+
+   static std::mutex s_registryMutex;
+   static std::vector<EntitySlot*> s_pages;
+   static std::vector<unsigned int> s_freeSlots;
+   static std::atomic<unsigned int> s_numSlots;
+   static std::atomic<int> s_numRegisteredEntities;
+};
\ No newline at end of file
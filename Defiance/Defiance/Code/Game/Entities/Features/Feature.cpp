@@ -1,3 +1,5 @@
+#include <string.h>
+#include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Parsers/XMLUtilities.hpp"
 #include "Engine/Core/Tokenizer.hpp"
 #include "Engine/Core/StringUtils.hpp"
@@ -5,6 +7,38 @@
 #include "Game/Map/Map.hpp"
 
 
+//-----------------------------------------------------------------------------------------------
+STATIC const int Feature::NUM_FEATURES_PER_SLAB = 256;
+// Generators create and prune features on their own threads while the game frees them on the main one
+STATIC ObjectPool<Feature> Feature::s_objectPool(Feature::NUM_FEATURES_PER_SLAB, true);
+
+
+//-----------------------------------------------------------------------------------------------
+// Anything derived from Feature won't fit the pool's cells, so it goes to the global heap
+STATIC void* Feature::operator new(size_t numBytes)
+{
+   if (numBytes != sizeof(Feature))
+   {
+      return ::operator new(numBytes);
+   }
+
+   return s_objectPool.Allocate();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC void Feature::operator delete(void* object, size_t numBytes)
+{
+   if (numBytes != sizeof(Feature))
+   {
+      ::operator delete(object);
+      return;
+   }
+
+   s_objectPool.Free(object);
+}
+
+
 //-----------------------------------------------------------------------------------------------
 Feature::Feature(const XMLNode& blueprintNode)
    : Entity(blueprintNode)
@@ -46,6 +80,7 @@ void Feature::AddToMap(Map* map, const TileCoords& position)
 {
    Entity::AddToMap(map, position);
    map->AddFeature(this, position);
+   map->GetEntityGrid()->AddEntity(this, position);
 }
 
 
@@ -1,6 +1,7 @@
 #pragma once;
 
 #include <vector>
+#include "Engine/Core/ObjectPool.hpp"
 #include "Game/Entities/Entity.hpp"
 
 
@@ -41,9 +42,15 @@ public:
    Feature(const Feature& copySource);
    Feature(const Feature& copySource, const XMLNode& featureLoadNode);
 
+   // Instances live in s_objectPool, so the factories and every delete go through it
+   static void* operator new(size_t numBytes);
+   static void operator delete(void* object, size_t numBytes);
+
+   static ObjectPool<Feature> s_objectPool;
+   static const int NUM_FEATURES_PER_SLAB;
+
    virtual bool IsFeature() const override { return true; }
    bool IsState(FeatureState state) { return m_state == state; }
-   const std::string& GetName() const { return m_name; }
    FeatureState GetCurrentState() const { return m_state; }
    FeatureType GetFeatureType() const { return m_featureType; }
    char GetGlyphForCurrentState() const { return m_glyphs[m_state]; }
@@ -5,6 +5,7 @@
 #include "Engine/Parsers/XMLUtilities.hpp"
 #include "Engine/Debug/ErrorWarningAssert.hpp"
 #include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Game/Entities/Features/FeatureFactory.hpp"
 
 
@@ -155,22 +156,41 @@ STATIC Feature* FeatureFactory::CreateByNameOfType(const std::string& name, Feat
 
 
 //-----------------------------------------------------------------------------------------------
-STATIC Feature* FeatureFactory::CreateRandomFeature()
+// For data that names a feature and has to be checked before CreateByNameOfType is trusted with it
+STATIC bool FeatureFactory::HasFeatureOfType(const std::string& name, FeatureType type)
+{
+   bool hasFeature = true;
+   if (type <= INVALID_FEATURE || type >= NUM_FEATURE_TYPES || s_factoryMaps[type] == nullptr)
+   {
+      return !hasFeature;
+   }
+
+   if (s_factoryMaps[type]->find(name) == s_factoryMaps[type]->end())
+   {
+      return !hasFeature;
+   }
+
+   return hasFeature;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC Feature* FeatureFactory::CreateRandomFeature(RandomNumberGenerator* random)
 {
    IntRange range(0, NUM_FEATURE_TYPES - 1);
-   FeatureType type = (FeatureType)GetRandomIntBetweenInclusive(range);
-   return CreateRandomFeatureOfType(type);
+   FeatureType type = (FeatureType)random->GetIntBetweenInclusive(range);
+   return CreateRandomFeatureOfType(type, random);
 }
 
 
 //-----------------------------------------------------------------------------------------------
-STATIC Feature* FeatureFactory::CreateRandomFeatureOfType(FeatureType type)
+STATIC Feature* FeatureFactory::CreateRandomFeatureOfType(FeatureType type, RandomNumberGenerator* random)
 {
    FeatureFactoryMap* factoryMap = s_factoryMaps[type];
 
    IntRange range(0, factoryMap->size() - 1);
    FeatureFactoryIter factoryIter = factoryMap->begin();
-   std::advance(factoryIter, GetRandomIntBetweenInclusive(range));
+   std::advance(factoryIter, random->GetIntBetweenInclusive(range));
 
    return factoryIter->second->CreateFeature();
 }
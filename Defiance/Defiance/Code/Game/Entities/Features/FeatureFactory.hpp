@@ -7,6 +7,7 @@
 
 //-----------------------------------------------------------------------------------------------
 struct XMLNode;
+class RandomNumberGenerator;
 class FeatureFactory;
 typedef std::map<std::string, FeatureFactory*> FeatureFactoryMap;
 
@@ -26,8 +27,9 @@ public:
    static Feature* CreateFeatureFromXMLNode(const XMLNode& node);
    static Feature* CreateByName(const std::string& name);
    static Feature* CreateByNameOfType(const std::string& name, FeatureType type);
-   static Feature* CreateRandomFeature();
-   static Feature* CreateRandomFeatureOfType(FeatureType type);
+   static bool HasFeatureOfType(const std::string& name, FeatureType type);
+   static Feature* CreateRandomFeature(RandomNumberGenerator* random);
+   static Feature* CreateRandomFeatureOfType(FeatureType type, RandomNumberGenerator* random);
    static FeatureFactoryMap* s_factoryMaps[NUM_FEATURE_TYPES];
 
 private:
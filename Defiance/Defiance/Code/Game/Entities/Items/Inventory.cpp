@@ -1,8 +1,9 @@
+#include <stdio.h>
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Parsers/XMLUtilities.hpp"
 #include "Game/Entities/Items/Inventory.hpp"
-#include "Game/UI/GameMessageBox.hpp"
+#include "Game/Entities/EntityRegistry.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
@@ -20,7 +21,7 @@ bool Inventory::AddItem(Item* itemToAdd)
    }
 
    ItemType typeToAdd = itemToAdd->GetItemType();
-   m_items[typeToAdd].push_back(itemToAdd);
+   m_items[typeToAdd].push_back(itemToAdd->GetHandle());
    return itemAddedSuccessfully;
 }
 
@@ -49,32 +50,22 @@ bool Inventory::GetItemOfType(ItemType type, Item** outItem)
 {
    bool itemRetrievedSuccessfully = true;
 
-   if (m_items[type].size() == 0)
-   {
-      return !itemRetrievedSuccessfully;
-   }
-
    // #TODO - allow agent to "pick" an item instead of using the first one
-   *outItem = m_items[type].front();
-   m_items[type].erase(m_items[type].begin());
-   return itemRetrievedSuccessfully;
-}
-
-
-//-----------------------------------------------------------------------------------------------
-void Inventory::DereferenceItem(Entity* itemToRemove)
-{
-   for (size_t typeIndex = 0; typeIndex < NUM_ITEM_TYPES; ++typeIndex)
+   std::vector<EntityHandle>& itemHandles = m_items[type];
+   while (!itemHandles.empty())
    {
-      for (Items::iterator itemIter = m_items[typeIndex].begin(); itemIter != m_items[typeIndex].end(); ++itemIter)
+      Item* item = (Item*)EntityRegistry::Resolve(itemHandles.front());
+      itemHandles.erase(itemHandles.begin());
+
+      // Items destroyed since they were added are dropped here
+      if (item != nullptr)
       {
-         if (*itemIter == itemToRemove)
-         {
-            m_items[typeIndex].erase(itemIter);
-            return;
-         }
+         *outItem = item;
+         return itemRetrievedSuccessfully;
       }
    }
+
+   return !itemRetrievedSuccessfully;
 }
 
 
@@ -86,9 +77,13 @@ Items Inventory::GetAllItems() const
 
    for (size_t typeIndex = 0; typeIndex < NUM_ITEM_TYPES; ++typeIndex)
    {
-      for (Item* item : m_items[typeIndex])
+      for (const EntityHandle& itemHandle : m_items[typeIndex])
       {
-         itemReferences.push_back(item);
+         Item* item = (Item*)EntityRegistry::Resolve(itemHandle);
+         if (item != nullptr)
+         {
+            itemReferences.push_back(item);
+         }
       }
    }
 
@@ -117,7 +112,7 @@ int Inventory::GetNumItemsInInventory() const
 
    for (size_t typeIndex = 0; typeIndex < NUM_ITEM_TYPES; ++typeIndex)
    {
-      itemCount += m_items[typeIndex].size();
+      itemCount += GetNumItemsOfTypeInInventory((ItemType)typeIndex);
    }
 
    return itemCount;
@@ -125,34 +120,40 @@ int Inventory::GetNumItemsInInventory() const
 
 
 //-----------------------------------------------------------------------------------------------
-char Inventory::GetItemGlyph() const
+int Inventory::GetNumItemsOfTypeInInventory(ItemType type) const
 {
-   for (size_t typeIndex = 0; typeIndex < NUM_ITEM_TYPES; ++typeIndex)
-   {
-      Items items = m_items[typeIndex];
+   int itemCount = 0;
 
-      for (Item* item : items)
+   for (const EntityHandle& itemHandle : m_items[type])
+   {
+      if (EntityRegistry::Resolve(itemHandle) != nullptr)
       {
-         return item->GetGlyph();
+         ++itemCount;
       }
    }
 
-   return ' ';
+   return itemCount;
 }
 
 
 //-----------------------------------------------------------------------------------------------
-void Inventory::PrintItemInfo() const
+char Inventory::GetItemGlyph() const
 {
    for (size_t typeIndex = 0; typeIndex < NUM_ITEM_TYPES; ++typeIndex)
    {
-      Items items = m_items[typeIndex];
-
-      for (Item* item : items)
+      for (const EntityHandle& itemHandle : m_items[typeIndex])
       {
-         g_theGameMessageBox->PrintNeutralMessage(Stringf("You find a %s here.", item->GetName().c_str()));
+         Item* item = (Item*)EntityRegistry::Resolve(itemHandle);
+         if (item == nullptr)
+         {
+            continue;
+         }
+
+         return item->GetGlyph();
       }
    }
+
+   return ' ';
 }
 
 
@@ -163,14 +164,18 @@ void Inventory::WriteToXMLNode(XMLNode& agentNode) const
 
    for (size_t typeIndex = 0; typeIndex < NUM_ITEM_TYPES; ++typeIndex)
    {
-      Items items = m_items[typeIndex];
-
-      for (Item* item : items)
+      for (const EntityHandle& itemHandle : m_items[typeIndex])
       {
+         Item* item = (Item*)EntityRegistry::Resolve(itemHandle);
+         if (item == nullptr)
+         {
+            continue;
+         }
+
          XMLNode itemNode = inventoryNode.addChild("Item");
 
          char spareBuf[255];
-         _itoa_s(item->GetID(), spareBuf, 10);
+         snprintf(spareBuf, sizeof(spareBuf), "%d", item->GetID());
 
          itemNode.addAttribute("id", spareBuf);
          itemNode.addAttribute("type", item->GetStringForType(item->GetItemType()).c_str());
@@ -191,7 +196,8 @@ void Inventory::LoadFromXMLNode(const XMLNode& saveNode)
       EntityID tempID = ReadXMLAttribute(itemNode, "id", 0);
       ItemType type = Item::GetTypeForString(ReadXMLAttribute(itemNode, "type", std::string("invalid")));
 
-      m_items[type].push_back((Item*)tempID);
+      // Holds the saved ID with a null generation until ResolveEntityPointers swaps in the real handle
+      m_items[type].push_back(EntityHandle((unsigned int)tempID, 0));
 
 
       itemNode = inventoryNode.getChildNode("Item", &itemIndex);
@@ -204,12 +210,10 @@ void Inventory::ResolveEntityPointers(const std::map<int, Entity*>& loadedEntiti
 {
    for (size_t typeIndex = 0; typeIndex < NUM_ITEM_TYPES; ++typeIndex)
    {
-      Items items = m_items[typeIndex];
-
-      for (Items::iterator itemIter = m_items[typeIndex].begin(); itemIter != m_items[typeIndex].end(); ++itemIter)
+      for (std::vector<EntityHandle>::iterator itemIter = m_items[typeIndex].begin(); itemIter != m_items[typeIndex].end(); ++itemIter)
       {
-         int oldID = (int)(*itemIter);
-         *itemIter = (Item*)loadedEntities.at(oldID);
+         int oldID = (int)itemIter->index;
+         *itemIter = loadedEntities.at(oldID)->GetHandle();
       }
    }
 }
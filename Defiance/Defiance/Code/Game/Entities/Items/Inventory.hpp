@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+#include "Game/Core/GameCommon.hpp"
 #include "Game/Entities/Items/Item.hpp"
 
 
@@ -8,21 +10,21 @@ struct XMLNode;
 
 
 //-----------------------------------------------------------------------------------------------
+// Holds handles rather than pointers, so an item destroyed elsewhere simply drops out of every
+// inventory that referenced it
 class Inventory
 {
 public:
    bool AddItem(Item* itemToAdd);
    bool GetItem(Item** outItem);
    bool GetItemOfType(ItemType type, Item** outItem);
-   void DereferenceItem(Entity* itemToRemove);
 
    Items GetAllItems() const;
    bool IsInventoryFull() const;
    int GetNumInventorySlotsRemaining() const;
    int GetNumItemsInInventory() const;
-   int GetNumItemsOfTypeInInventory(ItemType type) const { return m_items[type].size(); }
+   int GetNumItemsOfTypeInInventory(ItemType type) const;
    char GetItemGlyph() const;
-   void PrintItemInfo() const;
 
    void WriteToXMLNode(XMLNode& agentNode) const;
    void LoadFromXMLNode(const XMLNode& saveNode);
@@ -32,5 +34,5 @@ public:
    static int INVENTORY_SIZE_LIMIT;
 
 private:
-   Items m_items[NUM_ITEM_TYPES];
+   std::vector<EntityHandle> m_items[NUM_ITEM_TYPES];
 };
\ No newline at end of file
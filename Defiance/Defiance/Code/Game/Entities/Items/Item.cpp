@@ -1,8 +1,41 @@
+#include <string.h>
+#include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Parsers/XMLUtilities.hpp"
 #include "Game/Entities/Items/Item.hpp"
 #include "Game/Map/Map.hpp"
 
 
+//-----------------------------------------------------------------------------------------------
+STATIC const int Item::NUM_ITEMS_PER_SLAB = 128;
+STATIC ObjectPool<Item> Item::s_objectPool(Item::NUM_ITEMS_PER_SLAB);
+
+
+//-----------------------------------------------------------------------------------------------
+// Anything derived from Item won't fit the pool's cells, so it goes to the global heap
+STATIC void* Item::operator new(size_t numBytes)
+{
+   if (numBytes != sizeof(Item))
+   {
+      return ::operator new(numBytes);
+   }
+
+   return s_objectPool.Allocate();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC void Item::operator delete(void* object, size_t numBytes)
+{
+   if (numBytes != sizeof(Item))
+   {
+      ::operator delete(object);
+      return;
+   }
+
+   s_objectPool.Free(object);
+}
+
+
 //-----------------------------------------------------------------------------------------------
 Item::Item(const XMLNode& blueprintNode)
    : Entity(blueprintNode)
@@ -42,6 +75,19 @@ void Item::AddToMap(Map* map, const TileCoords& position)
    m_gameMap = map;
    m_position = position;
    map->GetTileAtTileCoords(position)->inventory.AddItem(this);
+   map->GetEntityGrid()->AddEntity(this, position);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Item::PickUp()
+{
+   m_isPickedUp = true;
+
+   if (m_gameMap != nullptr)
+   {
+      m_gameMap->GetEntityGrid()->RemoveEntity(this);
+   }
 }
 
 
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ObjectPool.hpp"
 #include "Engine/Math/IntRange.hpp"
 #include "Game/Core/GameCommon.hpp"
 #include "Game/Entities/Entity.hpp"
@@ -45,8 +46,15 @@ public:
    Item(const Item& copySource);
    Item(const Item& copySource, const XMLNode& node);
 
+   // Instances live in s_objectPool, so the factories and every delete go through it
+   static void* operator new(size_t numBytes);
+   static void operator delete(void* object, size_t numBytes);
+
+   static ObjectPool<Item> s_objectPool;
+   static const int NUM_ITEMS_PER_SLAB;
+
    virtual void AddToMap(Map* map, const TileCoords& position) override;
-   void PickUp() { m_isPickedUp = true; }
+   void PickUp();
    void SetDown() { m_isPickedUp = false; }
 
    virtual bool IsItem() const override { return true; }
@@ -5,6 +5,7 @@
 #include "Engine/Parsers/XMLUtilities.hpp"
 #include "Engine/Debug/ErrorWarningAssert.hpp"
 #include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Game/Entities/Items/ItemFactory.hpp"
 
 
@@ -137,22 +138,22 @@ STATIC Item* ItemFactory::CreateByNameOfType(const std::string& name, ItemType t
 
 
 //-----------------------------------------------------------------------------------------------
-STATIC Item* ItemFactory::CreateRandomItem()
+STATIC Item* ItemFactory::CreateRandomItem(RandomNumberGenerator* random)
 {
    IntRange range(0, NUM_ITEM_TYPES - 1);
-   ItemType type = (ItemType)GetRandomIntBetweenInclusive(range);
-   return CreateRandomItemOfType(type);
+   ItemType type = (ItemType)random->GetIntBetweenInclusive(range);
+   return CreateRandomItemOfType(type, random);
 }
 
 
 //-----------------------------------------------------------------------------------------------
-STATIC Item* ItemFactory::CreateRandomItemOfType(ItemType type)
+STATIC Item* ItemFactory::CreateRandomItemOfType(ItemType type, RandomNumberGenerator* random)
 {
    ItemFactoryMap* factoryMap = s_factoryMaps[type];
 
    IntRange range(0, factoryMap->size() - 1);
    ItemFactoryIter factoryIter = factoryMap->begin();
-   std::advance(factoryIter, GetRandomIntBetweenInclusive(range));
+   std::advance(factoryIter, random->GetIntBetweenInclusive(range));
 
    return factoryIter->second->CreateItem();
 }
@@ -7,6 +7,7 @@
 
 //-----------------------------------------------------------------------------------------------
 struct XMLNode;
+class RandomNumberGenerator;
 class ItemFactory;
 typedef std::map<std::string, ItemFactory*> ItemFactoryMap;
 
@@ -25,8 +26,8 @@ public:
    static void FreeAllItemBlueprints();
    static Item* CreateItemFromXMLNode(const XMLNode& node);
    static Item* CreateByNameOfType(const std::string& name, ItemType type);
-   static Item* CreateRandomItem();
-   static Item* CreateRandomItemOfType(ItemType type);
+   static Item* CreateRandomItem(RandomNumberGenerator* random);
+   static Item* CreateRandomItemOfType(ItemType type, RandomNumberGenerator* random);
    static ItemFactoryMap* s_factoryMaps[NUM_ITEM_TYPES];
 
 private:
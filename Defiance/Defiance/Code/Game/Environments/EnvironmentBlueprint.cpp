@@ -1,12 +1,15 @@
+#include <string.h>
 #include <sstream>
 #include "ThirdParty/Parsers/XmlParser.h"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/IO/FileUtils.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Debug/ErrorWarningAssert.hpp"
+#include "Engine/Parsers/XMLUtilities.hpp"
 #include "Game/Generators/Generator.hpp"
 #include "Game/Environments/EnvironmentBlueprint.hpp"
 #include "Game/Environments/EnvironmentGenerationProcess.hpp"
+#include "Game/Map/Map.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
@@ -37,6 +40,12 @@ EnvironmentBlueprint::EnvironmentBlueprint(const XMLNode& blueprintNode, const s
 
    ASSERT_OR_DIE(m_size.x != 0 && m_size.y != 0, Stringf("ERROR: Map with a dimension of size 0 for environment %s!", m_name.c_str()));
 
+   const char* layoutString = blueprintNode.getAttribute("indexLayout");
+   m_tileIndexLayout = (layoutString != nullptr) ? Map::GetTileIndexLayoutForString(layoutString) : ROW_MAJOR_LAYOUT;
+
+   m_isGeneratedByRegion = ReadXMLAttribute(blueprintNode, "regionGeneration", false);
+   m_worldSeed = ReadXMLAttribute(blueprintNode, "worldSeed", 0);
+
    // Build generation processes
    int generationIndex = 0;
    XMLNode generationNode = blueprintNode.getChildNode("GenerationProcessData", &generationIndex);
@@ -67,6 +76,17 @@ void EnvironmentBlueprint::PopulateGenerationProcessFromXMLNode(const XMLNode& g
 
    EnvironmentGenerationProcess* generationProcess = GeneratorRegistration::CreateEnvironmentGenerationProcessByName(generatorName, generationNode);
    ASSERT_OR_DIE(generationProcess != nullptr, Stringf("ERROR: Failed to create generation process for %s process number %d!", m_name.c_str(), m_generationProcesses.size() + 1));
+
+   // Areas are stamped over what earlier processes built, so the first process always covers the whole map
+   if (generationProcess->HasArea())
+   {
+      ASSERT_OR_DIE(!m_generationProcesses.empty(), Stringf("ERROR: The first generation process for %s can't have an area!", m_name.c_str()));
+
+      const Vector2i& areaMins = generationProcess->areaMins;
+      const Vector2i& areaSize = generationProcess->areaSize;
+      bool isAreaInMap = (areaMins.x >= 0 && areaMins.y >= 0 && areaMins.x + areaSize.x <= m_size.x && areaMins.y + areaSize.y <= m_size.y);
+      ASSERT_OR_DIE(isAreaInMap, Stringf("ERROR: %s process number %d has an area outside the map!", m_name.c_str(), m_generationProcesses.size() + 1));
+   }
    m_generationProcesses.push_back(generationProcess);
 }
 
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include "Engine/Math/Vector2i.hpp"
+#include "Game/Core/GameCommon.hpp"
 #include "Game/Environments/EnvironmentGenerationProcess.hpp"
 
 
@@ -27,6 +28,9 @@ public:
    const std::vector<EnvironmentGenerationProcess*>& GetGenerationProcesses() const { return m_generationProcesses; }
    const std::string& GetName() const { return m_name; }
    const Vector2i& GetSize() const { return m_size; }
+   TileIndexLayout GetTileIndexLayout() const { return m_tileIndexLayout; }
+   bool IsGeneratedByRegion() const { return m_isGeneratedByRegion; }
+   int GetWorldSeed() const { return m_worldSeed; }
 
    static void LoadEnvironmentBlueprints(); // optional - add a path in case an environment is in a different folder
    static void CleanUpEnvironmentBlueprints();
@@ -35,5 +39,8 @@ public:
 protected:
    std::string m_name;
    Vector2i m_size;
+   TileIndexLayout m_tileIndexLayout;
+   bool m_isGeneratedByRegion;
+   int m_worldSeed; // 0 picks a new seed every game
    std::vector<EnvironmentGenerationProcess*> m_generationProcesses;
 };
\ No newline at end of file
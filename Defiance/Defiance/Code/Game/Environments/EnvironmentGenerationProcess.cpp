@@ -1,14 +1,16 @@
 #include <sstream>
 #include "ThirdParty/Parsers/XmlParser.h"
 #include "Engine/Debug/ErrorWarningAssert.hpp"
-#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Parsers/XMLUtilities.hpp"
 #include "Game/Environments/EnvironmentGenerationProcess.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
 EnvironmentGenerationProcess::EnvironmentGenerationProcess(const XMLNode& node)
    : generatorName("")
-   , numSteps(0)
+   , stepRange(0, 0)
+   , areaMins(0, 0)
+   , areaSize(0, 0)
 {
    // This is checked earlier in EnvironmentBlueprint, but for my sanity:
    ASSERT_OR_DIE(node.getAttribute("generator"), "ERROR: No generator associated with generation process!");
@@ -21,7 +23,7 @@ EnvironmentGenerationProcess::EnvironmentGenerationProcess(const XMLNode& node)
       if (stepsString.find('~') == -1)
       {
          int steps = std::stoi(stepsString);
-         numSteps = steps;
+         stepRange = IntRange(steps, steps);
       }
       else // presence of '~' means a range
       {
@@ -32,7 +34,10 @@ EnvironmentGenerationProcess::EnvironmentGenerationProcess(const XMLNode& node)
          stepsStream.ignore(1);
          stepsStream >> maxSteps;
 
-         numSteps = GetRandomIntBetweenInclusive(minSteps, maxSteps);
+         stepRange = IntRange(minSteps, maxSteps);
       }
    }
+
+   areaMins = ReadXMLAttribute(node, "areaMins", Vector2i(0, 0));
+   areaSize = ReadXMLAttribute(node, "areaSize", Vector2i(0, 0));
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <string>
+#include "Engine/Math/IntRange.hpp"
+#include "Engine/Math/Vector2i.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
@@ -13,6 +15,11 @@ struct EnvironmentGenerationProcess
    EnvironmentGenerationProcess(const XMLNode& node);
    virtual ~EnvironmentGenerationProcess() {}
 
+   // Processes with an area are generated on their own map and stamped into that part of the environment
+   bool HasArea() const { return (areaSize.x > 0 && areaSize.y > 0); }
+
    std::string generatorName;
-   int numSteps;
+   IntRange stepRange; // rolled for every map, inclusive
+   Vector2i areaMins;
+   Vector2i areaSize;
 };
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Math/MathUtils.hpp"
 #include "Game/FieldOfView/FieldOfView.hpp"
+#include "Game/Map/Map.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
@@ -96,4 +98,22 @@ STATIC bool FieldOfView::Raycast(const Vector2f& startPos, const Vector2f& endPo
       }
    }
    return outResult->didImpact;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC void FieldOfView::GetViewBounds(const TileCoords& viewerPos, int viewDistance, const Map* map, TileCoords* outMins, TileCoords* outMaxs)
+{
+   const Vector2i& mapDimensions = map->GetDimensions();
+   if (map->AreTileCoordsOffMap(viewerPos))
+   {
+      *outMins = TileCoords(0, 0);
+      *outMaxs = TileCoords(-1, -1);
+      return;
+   }
+
+   outMins->x = Clampi(viewerPos.x - viewDistance, 0, mapDimensions.x - 1);
+   outMins->y = Clampi(viewerPos.y - viewDistance, 0, mapDimensions.y - 1);
+   outMaxs->x = Clampi(viewerPos.x + viewDistance, 0, mapDimensions.x - 1);
+   outMaxs->y = Clampi(viewerPos.y + viewDistance, 0, mapDimensions.y - 1);
 }
\ No newline at end of file
@@ -27,4 +27,8 @@ class FieldOfView
 public:
    virtual void CalculateFieldOfViewForAgent(Agent* agent, int viewDistance, Map* map, bool isPlayer) = 0;
    static bool Raycast(const Vector2f& startPos, const Vector2f& endPos, RaycastResult* outResult, Map* map);
+
+   // The square of tiles within viewDistance of the viewer, clipped to the map. Empty (mins past maxs)
+   // for a viewer off the map
+   static void GetViewBounds(const TileCoords& viewerPos, int viewDistance, const Map* map, TileCoords* outMins, TileCoords* outMaxs);
 };
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "Game/FieldOfView/FieldOfViewAdvanced.hpp"
 #include "Game/Entities/Agents/Agent.hpp"
 
@@ -5,10 +6,20 @@
 //-----------------------------------------------------------------------------------------------
 void FieldOfViewAdvanced::CalculateFieldOfViewForAgent(Agent* agent, int viewDistance, Map* map, bool isPlayer)
 {
+   // Only the player cares about tile visibility, everyone else just needs what is on the tiles
+   if (!isPlayer)
+   {
+      CalculateVisibleEntitiesForAgent(agent, map);
+      return;
+   }
+
    TileCoords agentPos = agent->GetPosition();
 
-   TileCoords topLeftTile(0, 0);
-   TileCoords botRightTile(map->GetDimensions() - TileCoords(1,1));
+   // Nothing outside the view square is touched, so regions far from the player are never generated
+   // or paged in just to be looked at. Inside the square, tiles are checked just as in a full scan
+   TileCoords topLeftTile;
+   TileCoords botRightTile;
+   GetViewBounds(agentPos, viewDistance, map, &topLeftTile, &botRightTile);
 
    for (int yIndex = topLeftTile.y; yIndex <= botRightTile.y; ++yIndex)
    {
@@ -42,21 +53,7 @@ void FieldOfViewAdvanced::CalculateFieldOfViewForAgent(Agent* agent, int viewDis
             continue;
          }
 
-         float distanceToTile = Vector2i::GetDistanceBetween(agentPos, coordsToCheck);
-         if (tileToCheck->IsOccupiedByAgent())
-         {
-            agent->AddVisibleAgent(distanceToTile, tileToCheck->occupyingAgent);
-         }
-
-         if (tileToCheck->HasItems())
-         {
-            agent->AddVisibleItems(distanceToTile, tileToCheck->GetItems());
-         }
-
-         if (tileToCheck->HasAFeature())
-         {
-            agent->AddVisibleFeature(distanceToTile, tileToCheck->occupyingFeature);
-         }
+         AddVisibleEntitiesOnTile(agent, agentPos, coordsToCheck, tileToCheck);
 
          if (isPlayer)
          {
@@ -69,6 +66,62 @@ void FieldOfViewAdvanced::CalculateFieldOfViewForAgent(Agent* agent, int viewDis
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// NPCs are not limited by view distance, only by line of sight, so this looks at every entity on the map
+void FieldOfViewAdvanced::CalculateVisibleEntitiesForAgent(Agent* agent, Map* map)
+{
+   TileCoords agentPos = agent->GetPosition();
+   const Vector2i& mapDimensions = map->GetDimensions();
+
+   std::vector<Entity*> entitiesOnMap;
+   map->GetEntityGrid()->FindEntitiesInArea(TileCoords(0, 0), mapDimensions - TileCoords(1, 1), &entitiesOnMap);
+
+   // Visit occupied tiles in the same row-major order as a full scan so ties in distance resolve the same way
+   std::vector<int> tilesToCheck;
+   tilesToCheck.reserve(entitiesOnMap.size());
+   for (const Entity* entity : entitiesOnMap)
+   {
+      const TileCoords& entityPos = entity->GetPosition();
+      tilesToCheck.push_back((entityPos.y * mapDimensions.x) + entityPos.x);
+   }
+
+   std::sort(tilesToCheck.begin(), tilesToCheck.end());
+   tilesToCheck.erase(std::unique(tilesToCheck.begin(), tilesToCheck.end()), tilesToCheck.end());
+
+   for (int rowMajorIndex : tilesToCheck)
+   {
+      TileCoords coordsToCheck(rowMajorIndex % mapDimensions.x, rowMajorIndex / mapDimensions.x);
+      if (!RaycastFromTileCornersToTileCorners(agentPos, coordsToCheck, map))
+      {
+         continue;
+      }
+
+      AddVisibleEntitiesOnTile(agent, agentPos, coordsToCheck, map->GetTileAtTileCoords(coordsToCheck));
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void FieldOfViewAdvanced::AddVisibleEntitiesOnTile(Agent* agent, const TileCoords& agentPos, const TileCoords& coordsToCheck, Tile* tileToCheck)
+{
+   float distanceToTile = Vector2i::GetDistanceBetween(agentPos, coordsToCheck);
+   if (tileToCheck->IsOccupiedByAgent())
+   {
+      agent->AddVisibleAgent(distanceToTile, tileToCheck->occupyingAgent);
+   }
+
+   if (tileToCheck->HasItems())
+   {
+      agent->AddVisibleItems(distanceToTile, tileToCheck->GetItems());
+   }
+
+   if (tileToCheck->HasAFeature())
+   {
+      agent->AddVisibleFeature(distanceToTile, tileToCheck->occupyingFeature);
+   }
+}
+
+
 //-----------------------------------------------------------------------------------------------
 bool FieldOfViewAdvanced::RaycastFromTileCornersToTileCorners(const TileCoords& startTile, const TileCoords& endTile, Map* map) const
 {
@@ -11,4 +11,8 @@ public:
    virtual void CalculateFieldOfViewForAgent(Agent* agent, int viewDistance, Map* map, bool isPlayer) override;
    bool RaycastFromTileCornersToTileCorners(const TileCoords& startTile, const TileCoords& endTile, Map* map) const;
    bool IsCornerVisible(const TileCoords& startTile, const TileCoords& endTile, const Vector2f& cornerPos, Map* map) const;
+
+private:
+   void CalculateVisibleEntitiesForAgent(Agent* agent, Map* map);
+   void AddVisibleEntitiesOnTile(Agent* agent, const TileCoords& agentPos, const TileCoords& coordsToCheck, Tile* tileToCheck);
 };
\ No newline at end of file
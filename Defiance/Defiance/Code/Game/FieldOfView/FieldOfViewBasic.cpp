@@ -10,7 +10,6 @@ void FieldOfViewBasic::CalculateFieldOfViewForAgent(Agent* agent, int viewDistan
    TileCoords topLeftTile(agentPos.x - viewDistance, agentPos.y - viewDistance);
    TileCoords botRightTile(agentPos.x + viewDistance, agentPos.y + viewDistance);
 
-   std::vector<Tile>* tiles = map->GetAllTiles();
    for (int yIndex = topLeftTile.y; yIndex <= botRightTile.y; ++yIndex)
    {
       for (int xIndex = topLeftTile.x; xIndex <= botRightTile.x; ++xIndex)
@@ -22,14 +21,14 @@ void FieldOfViewBasic::CalculateFieldOfViewForAgent(Agent* agent, int viewDistan
             continue;
          }
 
-         TileIndex indexToCheck = map->GetIndexForTileCoords(tileToCheck);
+         Tile* tile = map->GetTileAtTileCoords(tileToCheck);
          
          if (tileToCheck == agentPos)
          {
             if (isPlayer)
             {
-               (*tiles)[indexToCheck].isVisible = true;
-               (*tiles)[indexToCheck].isKnown = true;
+               tile->isVisible = true;
+               tile->isKnown = true;
             }
 
             continue;
@@ -42,15 +41,15 @@ void FieldOfViewBasic::CalculateFieldOfViewForAgent(Agent* agent, int viewDistan
          {
             if (isPlayer)
             {
-               (*tiles)[indexToCheck].isVisible = true;
-               (*tiles)[indexToCheck].isKnown = true;
+               tile->isVisible = true;
+               tile->isKnown = true;
             }
          }
          else
          {
             if (isPlayer)
             {
-               (*tiles)[indexToCheck].isVisible = false;
+               tile->isVisible = false;
             }
          }
       }
@@ -1,6 +1,8 @@
 #include <vector>
 #include "ThirdParty/Parsers/XmlParser.h"
 #include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Noise.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Game/Generators/CellularAutomataGenerator.hpp"
 #include "Game/Map/Map.hpp"
@@ -11,6 +13,36 @@
 //-----------------------------------------------------------------------------------------------
 STATIC GeneratorRegistration CellularAutomataGenerator::s_cellularAutomataGeneratorRegistration(
    "CellularAutomata", &CellularAutomataGenerator::CreateGenerator, &CellularAutomataGenerator::CreateEnvironmentGenerationProcess);
+STATIC const int CellularAutomataGenerator::NUM_SMOOTHING_STEPS = 4;
+STATIC const int CellularAutomataGenerator::NUM_CLEANUP_STEPS = 5;
+
+
+//-----------------------------------------------------------------------------------------------
+// Tiles outside the buffer count as stone, same as tiles off the map
+static int GetNumberOfStoneTilesAroundBufferCoords(const std::vector<TileType>& types, const Vector2i& bufferSize, int bufferX, int bufferY, int radius)
+{
+   int numStoneTiles = 0;
+   for (int yOffset = -radius; yOffset <= radius; ++yOffset)
+   {
+      for (int xOffset = -radius; xOffset <= radius; ++xOffset)
+      {
+         if (xOffset == 0 && yOffset == 0)
+         {
+            continue;
+         }
+
+         int neighborX = bufferX + xOffset;
+         int neighborY = bufferY + yOffset;
+         if (neighborX < 0 || neighborX >= bufferSize.x || neighborY < 0 || neighborY >= bufferSize.y
+            || types[(neighborY * bufferSize.x) + neighborX] == STONE_TYPE)
+         {
+            ++numStoneTiles;
+         }
+      }
+   }
+
+   return numStoneTiles;
+}
 
 
 //-----------------------------------------------------------------------------------------------
@@ -28,36 +60,39 @@ STATIC EnvironmentGenerationProcess* CellularAutomataGenerator::CreateEnvironmen
 
 
 //-----------------------------------------------------------------------------------------------
-void CellularAutomataGenerator::InitializeMap(Map* outMap) const
+void CellularAutomataGenerator::InitializeMap(Map* outMap, RandomNumberGenerator* random) const
 {
-   std::vector<Tile>* mapTiles = outMap->GetAllTiles();
+   const TileIndex numTilesInMap = outMap->GetNumberOfTilesInMap();
 
-   for (Tile& tile : (*mapTiles))
+   for (TileIndex tileIndex = 0; tileIndex < numTilesInMap; ++tileIndex)
    {
-      bool isAir = GetRandomTrueOrFalseWithProbability(.6f);
+      Tile* tile = outMap->GetTileAtIndex(tileIndex);
+      bool isAir = random->GetTrueOrFalseWithProbability(.6f);
 
       if (isAir)
       {
-         tile.type = AIR_TYPE;
-         tile.typeToBecome = AIR_TYPE;
+         tile->type = AIR_TYPE;
+         tile->typeToBecome = AIR_TYPE;
       }
 
-      tile.isHidden = false;
+      tile->isHidden = false;
    }
+
+   outMap->MarkTileTypesChanged();
 }
 
 
 //-----------------------------------------------------------------------------------------------
-bool CellularAutomataGenerator::GenerateStep(Map* outMap, int* outCurrentStepNumber, EnvironmentGenerationProcess*) const
+bool CellularAutomataGenerator::GenerateStep(Map* outMap, int* outCurrentStepNumber, RandomNumberGenerator*, EnvironmentGenerationProcess*) const
 {
-   std::vector<Tile>* mapTiles = outMap->GetAllTiles();
+   const TileIndex numTilesInMap = outMap->GetNumberOfTilesInMap();
 
    // #TODO - make parameters
-   if (*outCurrentStepNumber < 4)
+   if (*outCurrentStepNumber < NUM_SMOOTHING_STEPS)
    {
-      for (TileIndex tileIndex = 0; tileIndex < mapTiles->size(); ++tileIndex)
+      for (TileIndex tileIndex = 0; tileIndex < numTilesInMap; ++tileIndex)
       {
-         Tile* currentTile = &(mapTiles->at(tileIndex));
+         Tile* currentTile = outMap->GetTileAtIndex(tileIndex);
          int localStoneTiles = outMap->GetNumberOfTilesOfTypeAroundIndex(tileIndex, STONE_TYPE);
          
          if (localStoneTiles >= 5)
@@ -72,11 +107,11 @@ bool CellularAutomataGenerator::GenerateStep(Map* outMap, int* outCurrentStepNum
          }
       }
    }
-   else if (*outCurrentStepNumber < 9)
+   else if (*outCurrentStepNumber < NUM_SMOOTHING_STEPS + NUM_CLEANUP_STEPS)
    {
-      for (TileIndex tileIndex = 0; tileIndex < mapTiles->size(); ++tileIndex)
+      for (TileIndex tileIndex = 0; tileIndex < numTilesInMap; ++tileIndex)
       {
-         Tile* currentTile = &(mapTiles->at(tileIndex));
+         Tile* currentTile = outMap->GetTileAtIndex(tileIndex);
          int localStoneTiles = outMap->GetNumberOfTilesOfTypeAroundIndex(tileIndex, STONE_TYPE);
 
          if (localStoneTiles >= 5)
@@ -94,10 +129,91 @@ bool CellularAutomataGenerator::GenerateStep(Map* outMap, int* outCurrentStepNum
 
    *outCurrentStepNumber = *outCurrentStepNumber + 1;
 
-   if (*outCurrentStepNumber > 8)
+   if (*outCurrentStepNumber >= NUM_SMOOTHING_STEPS + NUM_CLEANUP_STEPS)
    {
       return false;
    }
 
    return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Runs the GenerateStep rules over an apron as wide as all the steps can reach, so the requested
+// area matches a whole-map run that started from the same per-tile noise
+void CellularAutomataGenerator::GenerateRegionTypes(const TileCoords& mins, const Vector2i& size, unsigned int worldSeed, const Vector2i& worldDimensions, std::vector<TileType>* outTypes) const
+{
+   const int apronSize = (NUM_SMOOTHING_STEPS * 2) + NUM_CLEANUP_STEPS;
+   const TileCoords bufferMins(mins.x - apronSize, mins.y - apronSize);
+   const Vector2i bufferSize(size.x + (2 * apronSize), size.y + (2 * apronSize));
+
+   std::vector<TileType> currentTypes(bufferSize.x * bufferSize.y, STONE_TYPE);
+   std::vector<bool> isOnMap(bufferSize.x * bufferSize.y, false);
+   for (int bufferY = 0; bufferY < bufferSize.y; ++bufferY)
+   {
+      for (int bufferX = 0; bufferX < bufferSize.x; ++bufferX)
+      {
+         TileCoords worldCoords(bufferMins.x + bufferX, bufferMins.y + bufferY);
+         if (worldCoords.x < 0 || worldCoords.x >= worldDimensions.x || worldCoords.y < 0 || worldCoords.y >= worldDimensions.y)
+         {
+            continue;
+         }
+
+         int bufferIndex = (bufferY * bufferSize.x) + bufferX;
+         isOnMap[bufferIndex] = true;
+         if (GetSeededNoiseZeroToOne2D(worldCoords.x, worldCoords.y, worldSeed) < .6f)
+         {
+            currentTypes[bufferIndex] = AIR_TYPE;
+         }
+      }
+   }
+
+   std::vector<TileType> nextTypes(currentTypes);
+   for (int stepNumber = 0; stepNumber < NUM_SMOOTHING_STEPS + NUM_CLEANUP_STEPS; ++stepNumber)
+   {
+      for (int bufferY = 0; bufferY < bufferSize.y; ++bufferY)
+      {
+         for (int bufferX = 0; bufferX < bufferSize.x; ++bufferX)
+         {
+            int bufferIndex = (bufferY * bufferSize.x) + bufferX;
+            if (!isOnMap[bufferIndex])
+            {
+               continue;
+            }
+
+            TileType newType = currentTypes[bufferIndex];
+            int localStoneTiles = GetNumberOfStoneTilesAroundBufferCoords(currentTypes, bufferSize, bufferX, bufferY, 1);
+            if (stepNumber < NUM_SMOOTHING_STEPS)
+            {
+               if (localStoneTiles >= 5)
+               {
+                  newType = STONE_TYPE;
+               }
+
+               localStoneTiles = GetNumberOfStoneTilesAroundBufferCoords(currentTypes, bufferSize, bufferX, bufferY, 2);
+               if (localStoneTiles < 2)
+               {
+                  newType = AIR_TYPE;
+               }
+            }
+            else
+            {
+               newType = (localStoneTiles >= 5) ? STONE_TYPE : AIR_TYPE;
+            }
+
+            nextTypes[bufferIndex] = newType;
+         }
+      }
+
+      currentTypes.swap(nextTypes);
+   }
+
+   outTypes->resize(size.x * size.y);
+   for (int yIndex = 0; yIndex < size.y; ++yIndex)
+   {
+      for (int xIndex = 0; xIndex < size.x; ++xIndex)
+      {
+         (*outTypes)[(yIndex * size.x) + xIndex] = currentTypes[((yIndex + apronSize) * bufferSize.x) + (xIndex + apronSize)];
+      }
+   }
 }
\ No newline at end of file
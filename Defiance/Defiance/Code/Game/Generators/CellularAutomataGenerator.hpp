@@ -20,6 +20,11 @@ public:
 
    static GeneratorRegistration s_cellularAutomataGeneratorRegistration;
 
-   void InitializeMap(Map* outMap) const;
-   bool GenerateStep(Map* outMap, int* outCurrentStepNumber, EnvironmentGenerationProcess* process = nullptr) const;
+   void InitializeMap(Map* outMap, RandomNumberGenerator* random) const;
+   bool GenerateStep(Map* outMap, int* outCurrentStepNumber, RandomNumberGenerator* random, EnvironmentGenerationProcess* process = nullptr) const;
+   bool CanGenerateRegions() const { return true; }
+   void GenerateRegionTypes(const TileCoords& mins, const Vector2i& size, unsigned int worldSeed, const Vector2i& worldDimensions, std::vector<TileType>* outTypes) const;
+
+   static const int NUM_SMOOTHING_STEPS;
+   static const int NUM_CLEANUP_STEPS;
 };
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Math/Vector2i.hpp"
 #include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Noise.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Game/Core/GameCommon.hpp"
 #include "Game/Generators/DungeonGenerator.hpp"
 #include "Game/Map/Map.hpp"
@@ -12,11 +14,51 @@
 //-----------------------------------------------------------------------------------------------
 STATIC GeneratorRegistration DungeonGenerator::s_dungeonGeneratorRegistration(
    "Dungeon", &DungeonGenerator::CreateGenerator, &DungeonGenerator::CreateEnvironmentGenerationProcess);
+STATIC const int DungeonGenerator::REGION_CELL_SIZE = 16;
+
+
+//-----------------------------------------------------------------------------------------------
+// Each channel is an independent stream of noise for the same cell
+static unsigned int GetRegionCellNoise(const TileCoords& cellCoords, unsigned int worldSeed, unsigned int channel)
+{
+   const unsigned int CHANNEL_STRIDE = 0x9E3779B9;
+   return GetSeededNoiseUint2D(cellCoords.x, cellCoords.y, worldSeed + (channel * CHANNEL_STRIDE));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Where the corridor crosses the edge between two cells. Edges are keyed by the west or south cell
+static int GetRegionDoorwayOffset(const TileCoords& cellCoords, bool isEastEdge, unsigned int worldSeed)
+{
+   const unsigned int EAST_EDGE_CHANNEL = 4;
+   const unsigned int NORTH_EDGE_CHANNEL = 5;
+   unsigned int edgeNoise = GetRegionCellNoise(cellCoords, worldSeed, isEastEdge ? EAST_EDGE_CHANNEL : NORTH_EDGE_CHANNEL);
+   return 2 + (int)(edgeNoise % (DungeonGenerator::REGION_CELL_SIZE - 4));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// start and end must share a row or a column
+static void CarveRegionCellLine(std::vector<TileType>* cellTypes, const TileCoords& start, const TileCoords& end)
+{
+   const int cellSize = DungeonGenerator::REGION_CELL_SIZE;
+   TileCoords step((end.x > start.x) ? 1 : ((end.x < start.x) ? -1 : 0), (end.y > start.y) ? 1 : ((end.y < start.y) ? -1 : 0));
+
+   TileCoords currentCoords = start;
+   (*cellTypes)[(currentCoords.y * cellSize) + currentCoords.x] = AIR_TYPE;
+   while (currentCoords != end)
+   {
+      currentCoords += step;
+      (*cellTypes)[(currentCoords.y * cellSize) + currentCoords.x] = AIR_TYPE;
+   }
+}
 
 
 //-----------------------------------------------------------------------------------------------
 DungeonGenerator::DungeonGenerator(const std::string& name)
    : Generator(name)
+   , m_currentRoomCount(0)
+   , m_wallFrontierMap(nullptr)
 {
 }
 
@@ -29,15 +71,16 @@ STATIC EnvironmentGenerationProcess* DungeonGenerator::CreateEnvironmentGenerati
 
 
 //-----------------------------------------------------------------------------------------------
-void DungeonGenerator::InitializeMap(Map* outMap) const
+void DungeonGenerator::InitializeMap(Map* outMap, RandomNumberGenerator*) const
 {
    // Init to stone
-   std::vector<Tile>* tiles = outMap->GetAllTiles();
-   for (Tile& tile : *tiles)
+   const TileIndex numTilesInMap = outMap->GetNumberOfTilesInMap();
+   for (TileIndex tileIndex = 0; tileIndex < numTilesInMap; ++tileIndex)
    {
-      tile.type = STONE_TYPE;
-      tile.typeToBecome = STONE_TYPE;
-      tile.isHidden = false;
+      Tile* tile = outMap->GetTileAtIndex(tileIndex);
+      tile->type = STONE_TYPE;
+      tile->typeToBecome = STONE_TYPE;
+      tile->isHidden = false;
    }
    
    // Find center of map
@@ -51,32 +94,40 @@ void DungeonGenerator::InitializeMap(Map* outMap) const
       for (int heightIndex = -3; heightIndex <= 3; ++heightIndex)
       {
          TileCoords locationToChange(center.x + widthIndex, center.y + heightIndex);
-         TileIndex index = outMap->GetIndexForTileCoords(locationToChange);
-         tiles->at(index).typeToBecome = AIR_TYPE;
+         outMap->GetTileAtTileCoords(locationToChange)->typeToBecome = AIR_TYPE;
       }
    }
 
    outMap->UpdateAllTilesToNewType();
+   RebuildWallFrontier(outMap);
 }
 
 
 //-----------------------------------------------------------------------------------------------
-bool DungeonGenerator::GenerateStep(Map* outMap, int* outCurrentStepNumber, EnvironmentGenerationProcess* process) const
+bool DungeonGenerator::GenerateStep(Map* outMap, int* outCurrentStepNumber, RandomNumberGenerator* random, EnvironmentGenerationProcess* process) const
 {
-   // Pick random tileNextToWall
-   std::vector<TileCoords> tilesNextToWalls = GetEmptyTilesNextToWalls(outMap);
-   while (tilesNextToWalls.size() != 0)
+   // Another generator may have shaped this map first
+   if (m_wallFrontierMap != outMap)
+   {
+      RebuildWallFrontier(outMap);
+   }
+
+   // Pick random tileNextToWall. Untried tiles stay at the front and failures are swapped behind them
+   int numUntriedTiles = (int)m_wallFrontier.size();
+   while (numUntriedTiles > 0)
    {
-      int indexToTry = GetRandomIndexFromCollection(tilesNextToWalls);
-      TileCoords hallwayStartCoords = tilesNextToWalls[indexToTry];
-      tilesNextToWalls.erase(tilesNextToWalls.begin() + indexToTry);
+      int slotToTry = random->GetIntBetweenInclusive(0, numUntriedTiles - 1);
+      TileCoords hallwayStartCoords = m_wallFrontier[slotToTry];
 
-      if (TryToMakeRoom(outMap, hallwayStartCoords, process))
+      if (TryToMakeRoom(outMap, hallwayStartCoords, random, process))
       {
          *outCurrentStepNumber = *outCurrentStepNumber + 1;
-         outMap->UpdateAllTilesToNewType();
+         outMap->MarkTileTypesChanged();
          return true;
       }
+
+      SwapWallFrontierSlots(slotToTry, numUntriedTiles - 1);
+      --numUntriedTiles;
    }
 
    return false;
@@ -84,7 +135,7 @@ bool DungeonGenerator::GenerateStep(Map* outMap, int* outCurrentStepNumber, Envi
 
 
 //-----------------------------------------------------------------------------------------------
-bool DungeonGenerator::TryToMakeRoom(Map* outMap, const TileCoords& hallwayStartCoords, EnvironmentGenerationProcess*) const
+bool DungeonGenerator::TryToMakeRoom(Map* outMap, const TileCoords& hallwayStartCoords, RandomNumberGenerator* random, EnvironmentGenerationProcess*) const
 {
    bool isRoomSuccessful = true;
 
@@ -100,13 +151,13 @@ bool DungeonGenerator::TryToMakeRoom(Map* outMap, const TileCoords& hallwayStart
       }
    }
 
-   TileCoords wallToDig = GetRandomFromCollection(wallTiles);
+   TileCoords wallToDig = random->GetFromCollection(wallTiles);
    TileDirection hallwayDirection = Map::GetDirectionFromSourceToDest(hallwayStartCoords, wallToDig);
    
    // #TODO - make parameter
    const int minLength = 3;
    const int maxLength = 7;
-   int hallwayLength = GetRandomIntBetweenInclusive(minLength, maxLength);
+   int hallwayLength = random->GetIntBetweenInclusive(minLength, maxLength);
 
    TileCoords hallwayEndCoords = outMap->GetTileCoordsInDirection(hallwayStartCoords, hallwayDirection, hallwayLength);
    while (outMap->AreTileCoordsOffMap(hallwayEndCoords) && hallwayLength > minLength)
@@ -127,15 +178,15 @@ bool DungeonGenerator::TryToMakeRoom(Map* outMap, const TileCoords& hallwayStart
    const int minDepth = 4;
    const int maxDepth = 7;
 
-   int targetRoomWidth = GetRandomIntBetweenInclusive(minWidth, maxWidth);
-   int targetRoomDepth = GetRandomIntBetweenInclusive(minDepth, maxDepth);
+   int targetRoomWidth = random->GetIntBetweenInclusive(minWidth, maxWidth);
+   int targetRoomDepth = random->GetIntBetweenInclusive(minDepth, maxDepth);
 
    int currentRoomWidth = 1; // 1 because hallway
    int currentRoomDepth = 0;
 
    // See how far we can go to the right
    TileDirection roomRightDirection = Map::GetTileDirection90DegreesClockwise(hallwayDirection);
-   int distanceToRight = GetRandomIntBetweenInclusive(0, targetRoomWidth - currentRoomWidth);
+   int distanceToRight = random->GetIntBetweenInclusive(0, targetRoomWidth - currentRoomWidth);
    while (outMap->AreTileCoordsOffMap(outMap->GetTileCoordsInDirection(hallwayEndCoords, roomRightDirection, distanceToRight)))
    {
       distanceToRight -= 1;
@@ -171,19 +222,27 @@ bool DungeonGenerator::TryToMakeRoom(Map* outMap, const TileCoords& hallwayStart
 
    // We can build the hallway and room!
    // Hallway
-   if (outMap->GetNumberOfTilesOfTypeAroundLocationCross(wallToDig, AIR_TYPE) < 2)
+   int airTilesAroundDoorway = 0;
+   for (int directionIndex = 0; directionIndex < NUM_CARDINAL_DIRECTIONS; ++directionIndex)
    {
-      Feature* newDoor = FeatureFactory::CreateRandomFeatureOfType(DOOR_FEATURE);
+      TileCoords neighborCoords = outMap->GetTileCoordsInDirection(wallToDig, (TileDirection)directionIndex);
+      if (!outMap->AreTileCoordsOffMap(neighborCoords) && outMap->GetTileAtTileCoords(neighborCoords)->type == AIR_TYPE)
+      {
+         ++airTilesAroundDoorway;
+      }
+   }
+
+   if (airTilesAroundDoorway < 2)
+   {
+      Feature* newDoor = FeatureFactory::CreateRandomFeatureOfType(DOOR_FEATURE, random);
       newDoor->AddToMap(outMap, wallToDig);
    }
 
-   std::vector<Tile>* mapTiles = outMap->GetAllTiles();
    TileCoords currentTileCoords = hallwayStartCoords;
    while (currentTileCoords != hallwayEndCoords)
    {
       currentTileCoords = outMap->GetTileCoordsInDirection(currentTileCoords, hallwayDirection);
-      TileIndex index = outMap->GetIndexForTileCoords(currentTileCoords);
-      (*mapTiles)[index].typeToBecome = AIR_TYPE;
+      CarveTile(outMap, currentTileCoords);
    }
 
    // Room
@@ -193,8 +252,7 @@ bool DungeonGenerator::TryToMakeRoom(Map* outMap, const TileCoords& hallwayStart
       for (int depthIndex = 1; depthIndex <= currentRoomDepth; ++depthIndex)
       {
          TileCoords tileToChange = outMap->GetTileCoordsInDirection(currentRoomTile, hallwayDirection, depthIndex);
-         TileIndex index = outMap->GetIndexForTileCoords(tileToChange);
-         (*mapTiles)[index].typeToBecome = AIR_TYPE;
+         CarveTile(outMap, tileToChange);
       }
       currentRoomTile = outMap->GetTileCoordsInDirection(currentRoomTile, roomLeftDirection, 1);
    }
@@ -204,28 +262,209 @@ bool DungeonGenerator::TryToMakeRoom(Map* outMap, const TileCoords& hallwayStart
 
 
 //-----------------------------------------------------------------------------------------------
-std::vector<TileCoords> DungeonGenerator::GetEmptyTilesNextToWalls(const Map* const map) const
+// Carved tiles change type right away, since nothing reads a room before it is finished, and only
+// the carved tile and its neighbors can enter or leave the frontier
+void DungeonGenerator::CarveTile(Map* outMap, const TileCoords& coords) const
+{
+   Tile* tile = outMap->GetTileAtTileCoords(coords);
+   tile->type = AIR_TYPE;
+   tile->typeToBecome = AIR_TYPE;
+
+   UpdateWallFrontierAtCoords(outMap, coords);
+   for (int directionIndex = 0; directionIndex < NUM_CARDINAL_DIRECTIONS; ++directionIndex)
+   {
+      UpdateWallFrontierAtCoords(outMap, outMap->GetTileCoordsInDirection(coords, (TileDirection)directionIndex));
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void DungeonGenerator::RebuildWallFrontier(const Map* map) const
 {
-   const std::vector<Tile>& tiles = map->GetAllTiles();
-   const unsigned int tilesInMap = tiles.size();
+   const Vector2i& dimensions = map->GetDimensions();
+   m_wallFrontierMap = map;
+   m_wallFrontier.clear();
+   m_wallFrontierSlots.assign(dimensions.x * dimensions.y, -1);
 
-   std::vector<TileCoords> tilesNextToWalls;
-   for (TileIndex tileIndex = 0; tileIndex < tilesInMap; ++tileIndex)
+   for (int yIndex = 0; yIndex < dimensions.y; ++yIndex)
    {
-      // If not air, we skip
-      if (tiles[tileIndex].type != AIR_TYPE)
+      for (int xIndex = 0; xIndex < dimensions.x; ++xIndex)
       {
-         continue;
+         TileCoords coords(xIndex, yIndex);
+         if (IsAirNextToWall(map, coords))
+         {
+            m_wallFrontierSlots[(yIndex * dimensions.x) + xIndex] = (int)m_wallFrontier.size();
+            m_wallFrontier.push_back(coords);
+         }
       }
+   }
+}
 
-      TileCoords tCoords = map->GetTileCoordsForIndex(tileIndex);
-      int neighborStoneTiles = map->GetNumberOfTilesOfTypeAroundLocationCross(tCoords, STONE_TYPE, 1);
 
-      if (neighborStoneTiles != 0)
+//-----------------------------------------------------------------------------------------------
+void DungeonGenerator::UpdateWallFrontierAtCoords(const Map* map, const TileCoords& coords) const
+{
+   if (map != m_wallFrontierMap || map->AreTileCoordsOffMap(coords))
+   {
+      return;
+   }
+
+   const int mapWidth = map->GetDimensions().x;
+   int tileSlotIndex = (coords.y * mapWidth) + coords.x;
+   int frontierSlot = m_wallFrontierSlots[tileSlotIndex];
+   bool isOnFrontier = IsAirNextToWall(map, coords);
+
+   if (isOnFrontier && frontierSlot == -1)
+   {
+      m_wallFrontierSlots[tileSlotIndex] = (int)m_wallFrontier.size();
+      m_wallFrontier.push_back(coords);
+   }
+   else if (!isOnFrontier && frontierSlot != -1)
+   {
+      // Swap-remove
+      SwapWallFrontierSlots(frontierSlot, (int)m_wallFrontier.size() - 1);
+      m_wallFrontier.pop_back();
+      m_wallFrontierSlots[tileSlotIndex] = -1;
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void DungeonGenerator::SwapWallFrontierSlots(int firstSlot, int secondSlot) const
+{
+   if (firstSlot == secondSlot)
+   {
+      return;
+   }
+
+   const int mapWidth = m_wallFrontierMap->GetDimensions().x;
+   TileCoords firstCoords = m_wallFrontier[firstSlot];
+   TileCoords secondCoords = m_wallFrontier[secondSlot];
+
+   m_wallFrontier[firstSlot] = secondCoords;
+   m_wallFrontier[secondSlot] = firstCoords;
+   m_wallFrontierSlots[(secondCoords.y * mapWidth) + secondCoords.x] = firstSlot;
+   m_wallFrontierSlots[(firstCoords.y * mapWidth) + firstCoords.x] = secondSlot;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Off map tiles do not count as walls
+STATIC bool DungeonGenerator::IsAirNextToWall(const Map* map, const TileCoords& coords)
+{
+   if (map->GetTileAtTileCoords(coords)->type != AIR_TYPE)
+   {
+      return false;
+   }
+
+   for (int directionIndex = 0; directionIndex < NUM_CARDINAL_DIRECTIONS; ++directionIndex)
+   {
+      TileCoords neighborCoords = map->GetTileCoordsInDirection(coords, (TileDirection)directionIndex);
+      if (!map->AreTileCoordsOffMap(neighborCoords) && map->GetTileAtTileCoords(neighborCoords)->type == STONE_TYPE)
+      {
+         return true;
+      }
+   }
+
+   return false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// The world is a grid of REGION_CELL_SIZE cells with one room each. Corridors meet at doorways
+// chosen per shared edge, so any region can be built without looking at its neighbors
+void DungeonGenerator::GenerateRegionTypes(const TileCoords& mins, const Vector2i& size, unsigned int worldSeed, const Vector2i&, std::vector<TileType>* outTypes) const
+{
+   outTypes->assign(size.x * size.y, STONE_TYPE);
+
+   TileCoords clampedMins(mins.x < 0 ? 0 : mins.x, mins.y < 0 ? 0 : mins.y);
+   TileCoords maxs(mins.x + size.x - 1, mins.y + size.y - 1);
+   if (clampedMins.x > maxs.x || clampedMins.y > maxs.y)
+   {
+      return;
+   }
+
+   std::vector<TileType> cellTypes;
+   for (int cellY = clampedMins.y / REGION_CELL_SIZE; cellY <= maxs.y / REGION_CELL_SIZE; ++cellY)
+   {
+      for (int cellX = clampedMins.x / REGION_CELL_SIZE; cellX <= maxs.x / REGION_CELL_SIZE; ++cellX)
+      {
+         GenerateRegionCell(TileCoords(cellX, cellY), worldSeed, &cellTypes);
+
+         // Copy the part of the cell that overlaps the region
+         TileCoords cellMins(cellX * REGION_CELL_SIZE, cellY * REGION_CELL_SIZE);
+         for (int localY = 0; localY < REGION_CELL_SIZE; ++localY)
+         {
+            int worldY = cellMins.y + localY;
+            if (worldY < mins.y || worldY > maxs.y)
+            {
+               continue;
+            }
+
+            for (int localX = 0; localX < REGION_CELL_SIZE; ++localX)
+            {
+               int worldX = cellMins.x + localX;
+               if (worldX < mins.x || worldX > maxs.x)
+               {
+                  continue;
+               }
+
+               (*outTypes)[((worldY - mins.y) * size.x) + (worldX - mins.x)] = cellTypes[(localY * REGION_CELL_SIZE) + localX];
+            }
+         }
+      }
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void DungeonGenerator::GenerateRegionCell(const TileCoords& cellCoords, unsigned int worldSeed, std::vector<TileType>* outCellTypes) const
+{
+   const int cellSize = REGION_CELL_SIZE;
+   outCellTypes->assign(cellSize * cellSize, STONE_TYPE);
+
+   // Same room limits as TryToMakeRoom. Rooms stay 2 tiles off the cell border so corridors can wrap around them
+   const int minWidth = 3;
+   const int maxWidth = 6;
+   const int minDepth = 4;
+   const int maxDepth = 7;
+
+   int roomWidth = minWidth + (int)(GetRegionCellNoise(cellCoords, worldSeed, 0) % (maxWidth - minWidth + 1));
+   int roomDepth = minDepth + (int)(GetRegionCellNoise(cellCoords, worldSeed, 1) % (maxDepth - minDepth + 1));
+   int roomMinX = 2 + (int)(GetRegionCellNoise(cellCoords, worldSeed, 2) % (cellSize - 4 - roomWidth + 1));
+   int roomMinY = 2 + (int)(GetRegionCellNoise(cellCoords, worldSeed, 3) % (cellSize - 4 - roomDepth + 1));
+
+   for (int yIndex = roomMinY; yIndex < roomMinY + roomDepth; ++yIndex)
+   {
+      for (int xIndex = roomMinX; xIndex < roomMinX + roomWidth; ++xIndex)
       {
-         tilesNextToWalls.push_back(tCoords);
+         (*outCellTypes)[(yIndex * cellSize) + xIndex] = AIR_TYPE;
       }
    }
 
-   return tilesNextToWalls;
+   TileCoords roomCenter(roomMinX + (roomWidth / 2), roomMinY + (roomDepth / 2));
+   int eastDoorwayY = GetRegionDoorwayOffset(cellCoords, true, worldSeed);
+   int westDoorwayY = GetRegionDoorwayOffset(TileCoords(cellCoords.x - 1, cellCoords.y), true, worldSeed);
+   int northDoorwayX = GetRegionDoorwayOffset(cellCoords, false, worldSeed);
+   int southDoorwayX = GetRegionDoorwayOffset(TileCoords(cellCoords.x, cellCoords.y - 1), false, worldSeed);
+
+   // East
+   CarveRegionCellLine(outCellTypes, roomCenter, TileCoords(cellSize - 2, roomCenter.y));
+   CarveRegionCellLine(outCellTypes, TileCoords(cellSize - 2, roomCenter.y), TileCoords(cellSize - 2, eastDoorwayY));
+   CarveRegionCellLine(outCellTypes, TileCoords(cellSize - 2, eastDoorwayY), TileCoords(cellSize - 1, eastDoorwayY));
+
+   // West
+   CarveRegionCellLine(outCellTypes, roomCenter, TileCoords(1, roomCenter.y));
+   CarveRegionCellLine(outCellTypes, TileCoords(1, roomCenter.y), TileCoords(1, westDoorwayY));
+   CarveRegionCellLine(outCellTypes, TileCoords(1, westDoorwayY), TileCoords(0, westDoorwayY));
+
+   // North
+   CarveRegionCellLine(outCellTypes, roomCenter, TileCoords(roomCenter.x, cellSize - 2));
+   CarveRegionCellLine(outCellTypes, TileCoords(roomCenter.x, cellSize - 2), TileCoords(northDoorwayX, cellSize - 2));
+   CarveRegionCellLine(outCellTypes, TileCoords(northDoorwayX, cellSize - 2), TileCoords(northDoorwayX, cellSize - 1));
+
+   // South
+   CarveRegionCellLine(outCellTypes, roomCenter, TileCoords(roomCenter.x, 1));
+   CarveRegionCellLine(outCellTypes, TileCoords(roomCenter.x, 1), TileCoords(southDoorwayX, 1));
+   CarveRegionCellLine(outCellTypes, TileCoords(southDoorwayX, 1), TileCoords(southDoorwayX, 0));
 }
\ No newline at end of file
@@ -23,12 +23,27 @@ public:
 
    static GeneratorRegistration s_dungeonGeneratorRegistration;
 
-   void InitializeMap(Map* outMap) const;
-   bool GenerateStep(Map* outMap, int* outCurrentStepNumber, EnvironmentGenerationProcess* process = nullptr) const;
-   bool TryToMakeRoom(Map* outMap, const TileCoords& hallwayStartCoords, EnvironmentGenerationProcess* process = nullptr) const;
+   void InitializeMap(Map* outMap, RandomNumberGenerator* random) const;
+   bool GenerateStep(Map* outMap, int* outCurrentStepNumber, RandomNumberGenerator* random, EnvironmentGenerationProcess* process = nullptr) const;
+   bool TryToMakeRoom(Map* outMap, const TileCoords& hallwayStartCoords, RandomNumberGenerator* random, EnvironmentGenerationProcess* process = nullptr) const;
+   bool CanGenerateRegions() const { return true; }
+   void GenerateRegionTypes(const TileCoords& mins, const Vector2i& size, unsigned int worldSeed, const Vector2i& worldDimensions, std::vector<TileType>* outTypes) const;
+
+   static const int REGION_CELL_SIZE;
 
 private:
-   std::vector<TileCoords> GetEmptyTilesNextToWalls(const Map* const map) const;
+   void GenerateRegionCell(const TileCoords& cellCoords, unsigned int worldSeed, std::vector<TileType>* outCellTypes) const;
+   void CarveTile(Map* outMap, const TileCoords& coords) const;
+   void RebuildWallFrontier(const Map* map) const;
+   void UpdateWallFrontierAtCoords(const Map* map, const TileCoords& coords) const;
+   void SwapWallFrontierSlots(int firstSlot, int secondSlot) const;
+   static bool IsAirNextToWall(const Map* map, const TileCoords& coords);
 
    int m_currentRoomCount;
+
+   // Air tiles with stone N, S, E or W, kept up to date as rooms are carved so steps never rescan the map.
+   // Slots are indexed row-major by tile coords, -1 when the tile is not on the frontier
+   mutable std::vector<TileCoords> m_wallFrontier;
+   mutable std::vector<int> m_wallFrontierSlots;
+   mutable const Map* m_wallFrontierMap;
 };
\ No newline at end of file
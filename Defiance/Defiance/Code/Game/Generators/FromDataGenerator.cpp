@@ -29,7 +29,7 @@ STATIC EnvironmentGenerationProcess* FromDataGenerator::CreateEnvironmentGenerat
 
 
 //-----------------------------------------------------------------------------------------------
-bool FromDataGenerator::GenerateStep(Map* outMap, int* outCurrentStepNumber, EnvironmentGenerationProcess* process) const
+bool FromDataGenerator::GenerateStep(Map* outMap, int* outCurrentStepNumber, RandomNumberGenerator*, EnvironmentGenerationProcess* process) const
 {
    if (*outCurrentStepNumber != 0)
    {
@@ -68,5 +68,5 @@ FromDataGenerationProcess::FromDataGenerationProcess(const XMLNode& node)
    dataFileNameWithoutExtensions = node.getAttribute("mapName");
 
    // FromData always runs 1 time
-   numSteps = 1;
+   stepRange = IntRange(1, 1);
 }
\ No newline at end of file
@@ -23,8 +23,8 @@ public:
    static GeneratorRegistration s_fromDataGeneratorRegistration;
 
    void SetMapFilePath(const std::string& path) { m_mapFilePath = path; }
-   void InitializeMap(Map*) const {} // Special case
-   bool GenerateStep(Map* outMap, int* outCurrentStepNumber, EnvironmentGenerationProcess*) const;
+   void InitializeMap(Map*, RandomNumberGenerator*) const {} // Special case
+   bool GenerateStep(Map* outMap, int* outCurrentStepNumber, RandomNumberGenerator*, EnvironmentGenerationProcess*) const;
 
 private:
    std::string m_mapFilePath;
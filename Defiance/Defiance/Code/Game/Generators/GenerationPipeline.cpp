@@ -0,0 +1,293 @@
+#include <thread>
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Time/Time.hpp"
+#include "Game/Generators/GenerationPipeline.hpp"
+#include "Game/Generators/Generator.hpp"
+#include "Game/Environments/EnvironmentBlueprint.hpp"
+#include "Game/Environments/EnvironmentGenerationProcess.hpp"
+#include "Game/Map/Map.hpp"
+#include "Game/Map/Tile.hpp"
+#include "Game/Entities/Features/Feature.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+// Everything one area stage needs on its own thread. Nothing here is shared with another stage
+struct AreaStageWork
+{
+   GenerationStage* stage;
+   Map* areaMap;
+   std::string mapName;
+   TileIndexLayout indexLayout;
+   RandomNumberGenerator random;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+static void RunAreaStage(AreaStageWork* work)
+{
+   double startTime = Time::GetCurrentTimeSeconds();
+
+   GenerationStage* stage = work->stage;
+   EnvironmentGenerationProcess* process = stage->process;
+   Generator* generator = GeneratorRegistration::CreateGeneratorByName(process->generatorName);
+   work->areaMap = generator->GenerateEmptyMap(process->areaSize, work->mapName, work->indexLayout);
+   generator->InitializeMap(work->areaMap, &work->random);
+
+   int stepNumber = 0;
+   while (stepNumber < stage->numSteps)
+   {
+      int previousStepNumber = stepNumber;
+      bool didGenerateStep = generator->GenerateStep(work->areaMap, &stepNumber, &work->random, process);
+      if (!didGenerateStep && stepNumber == previousStepNumber)
+      {
+         break;
+      }
+   }
+
+   delete generator;
+   stage->numStepsTaken = stepNumber;
+   stage->elapsedSeconds = Time::GetCurrentTimeSeconds() - startTime;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+GenerationStage::GenerationStage(EnvironmentGenerationProcess* stageProcess, int stageNumSteps)
+   : process(stageProcess)
+   , numSteps(stageNumSteps)
+   , numStepsTaken(0)
+   , parallelGroup(-1)
+   , elapsedSeconds(0.0)
+   , isFinished(false)
+{
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Step counts are rolled from their own stream so changing one process's range never reshapes the others
+GenerationPipeline::GenerationPipeline(EnvironmentBlueprint* environment, unsigned int gameSeed)
+   : m_environment(environment)
+   , m_generator(nullptr)
+   , m_generationRandom(gameSeed, GENERATION_RANDOM_STREAM)
+   , m_gameSeed(gameSeed)
+   , m_currentStageIndex(0)
+   , m_totalNumberOfSteps(0)
+   , m_numberOfStepsTaken(0)
+{
+   RandomNumberGenerator stepCountRandom(gameSeed, STEP_COUNT_RANDOM_STREAM);
+
+   const std::vector<EnvironmentGenerationProcess*>& genProcs = m_environment->GetGenerationProcesses();
+   for (EnvironmentGenerationProcess* genProc : genProcs)
+   {
+      int numSteps = stepCountRandom.GetIntBetweenInclusive(genProc->stepRange);
+      m_stages.push_back(GenerationStage(genProc, numSteps));
+      m_totalNumberOfSteps += numSteps;
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+GenerationPipeline::~GenerationPipeline()
+{
+   delete m_generator;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// The first stage always covers the whole map, so its generator shapes the empty map
+Map* GenerationPipeline::Begin()
+{
+   GenerationStage& firstStage = m_stages[0];
+   m_generator = GeneratorRegistration::CreateGeneratorByName(firstStage.process->generatorName);
+
+   double startTime = Time::GetCurrentTimeSeconds();
+   Map* map = m_generator->GenerateEmptyMap(m_environment->GetSize(), m_environment->GetName(), m_environment->GetTileIndexLayout());
+   m_generator->InitializeMap(map, &m_generationRandom);
+   firstStage.elapsedSeconds += Time::GetCurrentTimeSeconds() - startTime;
+
+   SkipEmptyStages();
+   return map;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// One step of the current whole map stage, or every step of the next run of area stages
+bool GenerationPipeline::TryStep(Map* outMap)
+{
+   bool didStep = true;
+
+   if (IsFinished())
+   {
+      return !didStep;
+   }
+
+   GenerationStage& stage = m_stages[m_currentStageIndex];
+   if (stage.process->HasArea())
+   {
+      RunAreaStages(outMap);
+      return didStep;
+   }
+
+   if (m_generator == nullptr)
+   {
+      m_generator = GeneratorRegistration::CreateGeneratorByName(stage.process->generatorName);
+   }
+
+   double startTime = Time::GetCurrentTimeSeconds();
+   int stepNumber = stage.numStepsTaken;
+   bool didGenerateStep = m_generator->GenerateStep(outMap, &stepNumber, &m_generationRandom, stage.process);
+   stage.elapsedSeconds += Time::GetCurrentTimeSeconds() - startTime;
+
+   // A generator that neither stepped nor moved on has nothing left to do on this map
+   bool isStuck = (!didGenerateStep && stepNumber == stage.numStepsTaken);
+
+   m_numberOfStepsTaken += (stepNumber - stage.numStepsTaken);
+   stage.numStepsTaken = stepNumber;
+   if (isStuck || stage.numStepsTaken >= stage.numSteps)
+   {
+      FinishCurrentStage();
+   }
+
+   return didStep;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Each area stage draws from its own stream, so the result is the same however the threads run
+void GenerationPipeline::RunAreaStages(Map* outMap)
+{
+   int firstStageIndex = m_currentStageIndex;
+   int endStageIndex = firstStageIndex + 1;
+   while (endStageIndex < (int)m_stages.size()
+      && m_stages[endStageIndex].process->HasArea()
+      && !DoesAreaOverlapStages(endStageIndex, firstStageIndex, endStageIndex - 1))
+   {
+      ++endStageIndex;
+   }
+
+   int numStagesInGroup = endStageIndex - firstStageIndex;
+   std::vector<AreaStageWork> stageWork(numStagesInGroup);
+   for (int workIndex = 0; workIndex < numStagesInGroup; ++workIndex)
+   {
+      int stageIndex = firstStageIndex + workIndex;
+      AreaStageWork& work = stageWork[workIndex];
+      work.stage = &m_stages[stageIndex];
+      work.areaMap = nullptr;
+      work.mapName = m_environment->GetName();
+      work.indexLayout = outMap->GetTileIndexLayout();
+      work.random.Seed(m_gameSeed, ((unsigned int)stageIndex << 16) | AREA_GENERATION_RANDOM_STREAM);
+      work.stage->parallelGroup = firstStageIndex;
+   }
+
+   std::vector<std::thread> stageThreads;
+   for (int workIndex = 1; workIndex < numStagesInGroup; ++workIndex)
+   {
+      stageThreads.push_back(std::thread(&RunAreaStage, &stageWork[workIndex]));
+   }
+
+   RunAreaStage(&stageWork[0]);
+
+   for (std::thread& stageThread : stageThreads)
+   {
+      stageThread.join();
+   }
+
+   // Stamped in stage order on this thread, so features are added to the map the same way every time
+   for (AreaStageWork& work : stageWork)
+   {
+      StampAreaMap(outMap, work.areaMap, work.stage->process->areaMins);
+      delete work.areaMap;
+
+      m_numberOfStepsTaken += work.stage->numStepsTaken;
+      work.stage->isFinished = true;
+   }
+
+   outMap->MarkTileTypesChanged();
+   m_currentStageIndex = endStageIndex;
+   SkipEmptyStages();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool GenerationPipeline::DoesAreaOverlapStages(int stageIndex, int firstStageIndex, int lastStageIndex) const
+{
+   const EnvironmentGenerationProcess* process = m_stages[stageIndex].process;
+   for (int otherStageIndex = firstStageIndex; otherStageIndex <= lastStageIndex; ++otherStageIndex)
+   {
+      const EnvironmentGenerationProcess* otherProcess = m_stages[otherStageIndex].process;
+      bool isSeparateInX = (process->areaMins.x + process->areaSize.x <= otherProcess->areaMins.x)
+         || (otherProcess->areaMins.x + otherProcess->areaSize.x <= process->areaMins.x);
+      bool isSeparateInY = (process->areaMins.y + process->areaSize.y <= otherProcess->areaMins.y)
+         || (otherProcess->areaMins.y + otherProcess->areaSize.y <= process->areaMins.y);
+
+      if (!isSeparateInX && !isSeparateInY)
+      {
+         return true;
+      }
+   }
+
+   return false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void GenerationPipeline::FinishCurrentStage()
+{
+   m_stages[m_currentStageIndex].isFinished = true;
+   ++m_currentStageIndex;
+
+   delete m_generator;
+   m_generator = nullptr;
+
+   SkipEmptyStages();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void GenerationPipeline::SkipEmptyStages()
+{
+   while (m_currentStageIndex < (int)m_stages.size() && m_stages[m_currentStageIndex].numSteps <= 0)
+   {
+      m_stages[m_currentStageIndex].isFinished = true;
+      ++m_currentStageIndex;
+
+      delete m_generator;
+      m_generator = nullptr;
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Replaces the area's tiles and features with the area map's. The area map is left without features
+STATIC void GenerationPipeline::StampAreaMap(Map* outMap, Map* areaMap, const Vector2i& areaMins)
+{
+   const Vector2i& areaSize = areaMap->GetDimensions();
+   for (int yIndex = 0; yIndex < areaSize.y; ++yIndex)
+   {
+      for (int xIndex = 0; xIndex < areaSize.x; ++xIndex)
+      {
+         TileCoords areaCoords(xIndex, yIndex);
+         TileCoords mapCoords = areaMins + areaCoords;
+         Tile* areaTile = areaMap->GetTileAtTileCoords(areaCoords);
+         Tile* mapTile = outMap->GetTileAtTileCoords(mapCoords);
+
+         Feature* buriedFeature = mapTile->occupyingFeature;
+         if (buriedFeature != nullptr)
+         {
+            outMap->GetEntityGrid()->RemoveEntity(buriedFeature);
+            mapTile->occupyingFeature = nullptr;
+            delete buriedFeature;
+         }
+
+         mapTile->type = areaTile->type;
+         mapTile->typeToBecome = areaTile->type;
+
+         Feature* areaFeature = areaTile->occupyingFeature;
+         if (areaFeature != nullptr)
+         {
+            areaMap->GetEntityGrid()->RemoveEntity(areaFeature);
+            areaTile->occupyingFeature = nullptr;
+            areaFeature->AddToMap(outMap, mapCoords);
+         }
+      }
+   }
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+#include "Engine/Math/RandomNumberGenerator.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+class EnvironmentBlueprint;
+class Generator;
+class Map;
+class Vector2i;
+struct EnvironmentGenerationProcess;
+
+
+//-----------------------------------------------------------------------------------------------
+struct GenerationStage
+{
+   GenerationStage(EnvironmentGenerationProcess* stageProcess, int stageNumSteps);
+
+   EnvironmentGenerationProcess* process;
+   int numSteps;
+   int numStepsTaken;
+   int parallelGroup; // first stage of the group it ran with, -1 for whole map stages
+   double elapsedSeconds;
+   bool isFinished;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Runs every generation process of an environment over one map, in order. Whole map stages pick up
+// from whatever the stages before them built. Area stages build their own small map and stamp it
+// into their area, so a run of area stages that don't overlap is generated in parallel
+class GenerationPipeline
+{
+public:
+   GenerationPipeline(EnvironmentBlueprint* environment, unsigned int gameSeed);
+   ~GenerationPipeline();
+
+   Map* Begin();
+   bool TryStep(Map* outMap);
+
+   const std::vector<GenerationStage>& GetStages() const { return m_stages; }
+   int GetTotalNumberOfSteps() const { return m_totalNumberOfSteps; }
+   int GetNumberOfStepsTaken() const { return m_numberOfStepsTaken; }
+   bool IsFinished() const { return (m_currentStageIndex >= (int)m_stages.size()); }
+
+private:
+   GenerationPipeline(const GenerationPipeline&);
+   GenerationPipeline& operator=(const GenerationPipeline&);
+
+   void RunAreaStages(Map* outMap);
+   bool DoesAreaOverlapStages(int stageIndex, int firstStageIndex, int lastStageIndex) const;
+   void FinishCurrentStage();
+   void SkipEmptyStages();
+   static void StampAreaMap(Map* outMap, Map* areaMap, const Vector2i& areaMins);
+
+   EnvironmentBlueprint* m_environment;
+   std::vector<GenerationStage> m_stages;
+   Generator* m_generator;
+   RandomNumberGenerator m_generationRandom;
+   unsigned int m_gameSeed;
+   int m_currentStageIndex;
+   int m_totalNumberOfSteps;
+   int m_numberOfStepsTaken;
+};
\ No newline at end of file
@@ -0,0 +1,399 @@
+#include <stdlib.h>
+#include <map>
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Tokenizer.hpp"
+#include "Engine/IO/FileUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Time/Time.hpp"
+#include "ThirdParty/Parsers/XmlParser.h"
+#include "Game/Generators/GenerationRegression.hpp"
+#include "Game/Generators/Generator.hpp"
+#include "Game/Environments/EnvironmentGenerationProcess.hpp"
+#include "Game/Entities/Features/Feature.hpp"
+#include "Game/Entities/Features/FeatureFactory.hpp"
+#include "Game/Map/Map.hpp"
+#include "Game/Map/Tile.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+#if defined(_WIN32)
+STATIC const char* GenerationRegression::BASELINE_FILE_PATH = "Data/Regression/Generation.Win32.baseline";
+#elif defined(__linux__)
+STATIC const char* GenerationRegression::BASELINE_FILE_PATH = "Data/Regression/Generation.Linux.baseline";
+#else
+STATIC const char* GenerationRegression::BASELINE_FILE_PATH = "Data/Regression/Generation.baseline";
+#endif
+STATIC const int GenerationRegression::NUM_TIMED_RUNS = 5;
+STATIC const double GenerationRegression::MAX_STEP_TIME_GROWTH = 1.25;
+STATIC const double GenerationRegression::MIN_COMPARED_SECONDS_PER_STEP = 0.0001;
+
+
+//-----------------------------------------------------------------------------------------------
+static const char* REGRESSION_BASELINE_DIRECTORY = "Data/Regression";
+static const unsigned long long FNV_OFFSET_BASIS = 14695981039346656037ULL;
+static const unsigned long long FNV_PRIME = 1099511628211ULL;
+
+
+//-----------------------------------------------------------------------------------------------
+struct BaselineEntry
+{
+   unsigned long long tileHash;
+   double secondsPerStep;
+};
+typedef std::map<std::string, BaselineEntry> BaselineMap;
+
+
+//-----------------------------------------------------------------------------------------------
+static void HashBytes(const void* bytes, size_t numBytes, unsigned long long* inOutHash)
+{
+   const unsigned char* byteData = (const unsigned char*)bytes;
+   for (size_t byteIndex = 0; byteIndex < numBytes; ++byteIndex)
+   {
+      *inOutHash = (*inOutHash ^ byteData[byteIndex]) * FNV_PRIME;
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Lines are "<generator> <width> <height> <seed> <hash> <microseconds per step>", # starts a comment
+static void ParseBaselineText(const std::string& baselineText, BaselineMap* outBaseline)
+{
+   Tokenizer lineTokens(baselineText, "\r\n");
+   while (!lineTokens.IsFinished())
+   {
+      std::string line = lineTokens.GetNextToken();
+      if (line.empty() || line[0] == '#')
+      {
+         continue;
+      }
+
+      std::vector<std::string> fields;
+      Tokenizer fieldTokens(line, " \t");
+      while (!fieldTokens.IsFinished())
+      {
+         std::string field = fieldTokens.GetNextToken();
+         if (!field.empty())
+         {
+            fields.push_back(field);
+         }
+      }
+
+      if (fields.size() < 6)
+      {
+         continue;
+      }
+
+      GenerationRegressionResult keyResult;
+      keyResult.generatorName = fields[0];
+      keyResult.size = Vector2i(atoi(fields[1].c_str()), atoi(fields[2].c_str()));
+      keyResult.seed = (unsigned int)strtoul(fields[3].c_str(), nullptr, 10);
+
+      BaselineEntry entry;
+      entry.tileHash = strtoull(fields[4].c_str(), nullptr, 16);
+      entry.secondsPerStep = atof(fields[5].c_str()) / 1000000.0;
+      (*outBaseline)[keyResult.GetKey()] = entry;
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+std::string GenerationRegressionResult::GetKey() const
+{
+   return Stringf("%s %d %d %u", generatorName.c_str(), size.x, size.y, seed);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Step counts sit near the top of what the environments ask for
+STATIC void GenerationRegression::GetDefaultCases(std::vector<GenerationRegressionCase>* outCases)
+{
+   const unsigned int seeds[] = { 1, 42, 90210 };
+   const Vector2i sizes[] = { Vector2i(32, 32), Vector2i(64, 64), Vector2i(256, 256) };
+
+   for (unsigned int seed : seeds)
+   {
+      for (const Vector2i& size : sizes)
+      {
+         outCases->push_back(GenerationRegressionCase("CellularAutomata", size, seed, 10));
+         outCases->push_back(GenerationRegressionCase("Dungeon", size, seed, 15));
+         outCases->push_back(GenerationRegressionCase("River", size, seed, 5));
+      }
+
+      outCases->push_back(GenerationRegressionCase("FromData", Vector2i::ZERO, seed, 1));
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Generates the way a single stage pipeline would, then finalizes so the hash covers features too
+STATIC void GenerationRegression::RunCase(const GenerationRegressionCase& regressionCase, GenerationRegressionResult* outResult)
+{
+   std::string processXML = Stringf("<GenerationProcessData generator=\"%s\" steps=\"%d\" mapName=\"default\"/>",
+      regressionCase.generatorName.c_str(), regressionCase.numSteps);
+   XMLNode processNode = XMLNode::parseString(processXML.c_str(), "GenerationProcessData");
+   EnvironmentGenerationProcess* process = GeneratorRegistration::CreateEnvironmentGenerationProcessByName(regressionCase.generatorName, processNode);
+
+   RandomNumberGenerator generationRandom(regressionCase.seed, GENERATION_RANDOM_STREAM);
+   Generator* generator = GeneratorRegistration::CreateGeneratorByName(regressionCase.generatorName);
+   Vector2i emptyMapSize = (regressionCase.size.x > 0 && regressionCase.size.y > 0) ? regressionCase.size : Vector2i(1, 1);
+   Map* map = generator->GenerateEmptyMap(emptyMapSize, regressionCase.generatorName, ROW_MAJOR_LAYOUT);
+   generator->InitializeMap(map, &generationRandom);
+
+   int stepNumber = 0;
+   int numStepCalls = 0;
+   double totalStepSeconds = 0.0;
+   double maxStepSeconds = 0.0;
+   while (stepNumber < regressionCase.numSteps)
+   {
+      int previousStepNumber = stepNumber;
+      double stepStartTime = Time::GetCurrentTimeSeconds();
+      bool didGenerateStep = generator->GenerateStep(map, &stepNumber, &generationRandom, process);
+      double stepSeconds = Time::GetCurrentTimeSeconds() - stepStartTime;
+
+      ++numStepCalls;
+      totalStepSeconds += stepSeconds;
+      if (stepSeconds > maxStepSeconds)
+      {
+         maxStepSeconds = stepSeconds;
+      }
+
+      if (!didGenerateStep && stepNumber == previousStepNumber)
+      {
+         break;
+      }
+   }
+
+   std::vector<Entity*> features;
+   double finalizeStartTime = Time::GetCurrentTimeSeconds();
+   Generator::FinalizeMap(map, &features);
+   double finalizeSeconds = Time::GetCurrentTimeSeconds() - finalizeStartTime;
+
+   outResult->generatorName = regressionCase.generatorName;
+   outResult->size = map->GetDimensions();
+   outResult->seed = regressionCase.seed;
+   outResult->tileHash = HashMapTiles(map);
+   outResult->numStepsTaken = stepNumber;
+   outResult->secondsPerStep = (numStepCalls > 0) ? (totalStepSeconds / (double)numStepCalls) : 0.0;
+   outResult->maxSecondsPerStep = maxStepSeconds;
+   outResult->finalizeSeconds = finalizeSeconds;
+
+   for (Entity* feature : features)
+   {
+      delete feature;
+   }
+   delete map;
+   delete generator;
+   delete process;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC void GenerationRegression::RunCases(const std::vector<GenerationRegressionCase>& cases, std::vector<GenerationRegressionResult>* outResults)
+{
+   outResults->resize(cases.size());
+   for (int caseIndex = 0; caseIndex < (int)cases.size(); ++caseIndex)
+   {
+      GenerationRegressionResult& result = (*outResults)[caseIndex];
+      RunCase(cases[caseIndex], &result);
+
+      for (int runIndex = 1; runIndex < NUM_TIMED_RUNS; ++runIndex)
+      {
+         GenerationRegressionResult rerunResult;
+         RunCase(cases[caseIndex], &rerunResult);
+         if (rerunResult.tileHash != result.tileHash)
+         {
+            result.isRepeatable = false;
+         }
+
+         if (rerunResult.secondsPerStep < result.secondsPerStep)
+         {
+            result.secondsPerStep = rerunResult.secondsPerStep;
+            result.maxSecondsPerStep = rerunResult.maxSecondsPerStep;
+            result.finalizeSeconds = rerunResult.finalizeSeconds;
+         }
+      }
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// FNV-1a over tiles in coordinate order, so the hash doesn't depend on the tile index layout
+STATIC unsigned long long GenerationRegression::HashMapTiles(const Map* map)
+{
+   unsigned long long tileHash = FNV_OFFSET_BASIS;
+   const Vector2i& dimensions = map->GetDimensions();
+   HashBytes(&dimensions.x, sizeof(dimensions.x), &tileHash);
+   HashBytes(&dimensions.y, sizeof(dimensions.y), &tileHash);
+
+   for (int yIndex = 0; yIndex < dimensions.y; ++yIndex)
+   {
+      for (int xIndex = 0; xIndex < dimensions.x; ++xIndex)
+      {
+         const Tile* tile = map->GetTileAtTileCoords(TileCoords(xIndex, yIndex));
+         unsigned char tileBytes[3];
+         tileBytes[0] = (unsigned char)(tile->type + 1);
+         tileBytes[1] = tile->isHidden ? 1 : 0;
+         tileBytes[2] = tile->HasAFeature() ? (unsigned char)(tile->occupyingFeature->GetFeatureType() + 1) : 0;
+         HashBytes(tileBytes, sizeof(tileBytes), &tileHash);
+
+         if (tile->HasAFeature())
+         {
+            const std::string& featureName = tile->occupyingFeature->GetName();
+            HashBytes(featureName.c_str(), featureName.size(), &tileHash);
+         }
+      }
+   }
+
+   return tileHash;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC int GenerationRegression::CompareToBaseline(const std::vector<GenerationRegressionResult>& results, const std::string& baselineText,
+   double maxStepTimeGrowth, std::vector<std::string>* outReportLines)
+{
+   BaselineMap baseline;
+   ParseBaselineText(baselineText, &baseline);
+
+   int numFailures = 0;
+   for (const GenerationRegressionResult& result : results)
+   {
+      std::string timing = Stringf("%d steps, %.1fus/step (max %.1fus), finalize %.1fus", result.numStepsTaken,
+         result.secondsPerStep * 1000000.0, result.maxSecondsPerStep * 1000000.0, result.finalizeSeconds * 1000000.0);
+
+      if (!result.isRepeatable)
+      {
+         ++numFailures;
+         outReportLines->push_back(Stringf("UNSTABLE %s: same seed hashed differently across runs", result.GetKey().c_str()));
+         continue;
+      }
+
+      BaselineMap::const_iterator baselineIter = baseline.find(result.GetKey());
+      if (baselineIter == baseline.end())
+      {
+         outReportLines->push_back(Stringf("NEW     %s: %016llx, %s", result.GetKey().c_str(), result.tileHash, timing.c_str()));
+         continue;
+      }
+
+      const BaselineEntry& entry = baselineIter->second;
+      if (entry.tileHash != result.tileHash)
+      {
+         ++numFailures;
+         outReportLines->push_back(Stringf("CHANGED %s: %016llx, baseline %016llx", result.GetKey().c_str(), result.tileHash, entry.tileHash));
+      }
+      else if (entry.secondsPerStep >= MIN_COMPARED_SECONDS_PER_STEP && result.secondsPerStep > entry.secondsPerStep * maxStepTimeGrowth)
+      {
+         ++numFailures;
+         outReportLines->push_back(Stringf("SLOWER  %s: %s, baseline %.1fus/step", result.GetKey().c_str(), timing.c_str(), entry.secondsPerStep * 1000000.0));
+      }
+      else
+      {
+         outReportLines->push_back(Stringf("ok      %s: %s", result.GetKey().c_str(), timing.c_str()));
+      }
+   }
+
+   return numFailures;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC std::string GenerationRegression::GetBaselineText(const std::vector<GenerationRegressionResult>& results)
+{
+   std::string baselineText("# generator width height seed hash microsecondsPerStep\n");
+   for (const GenerationRegressionResult& result : results)
+   {
+      baselineText += Stringf("%s %016llx %.1f\n", result.GetKey().c_str(), result.tileHash, result.secondsPerStep * 1000000.0);
+   }
+
+   return baselineText;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Exits 1 on any failure, and 2 when there is no baseline to compare against
+STATIC bool GenerationRegression::RunFromCommandLine(const std::string& commandLine, std::string* outReport, int* outExitCode)
+{
+   std::vector<std::string> arguments;
+   Tokenizer argumentTokens(commandLine, " \t");
+   while (!argumentTokens.IsFinished())
+   {
+      std::string argument = argumentTokens.GetNextToken();
+      if (!argument.empty())
+      {
+         arguments.push_back(argument);
+      }
+   }
+
+   if (arguments.empty() || arguments[0] != "-genregress")
+   {
+      return false;
+   }
+
+   bool isRecording = (arguments.size() > 1 && arguments[1] == "record");
+   size_t baselineArgumentIndex = isRecording ? 2 : 1;
+   std::string baselineFilePath = (arguments.size() > baselineArgumentIndex) ? arguments[baselineArgumentIndex] : BASELINE_FILE_PATH;
+   double maxStepTimeGrowth = (!isRecording && arguments.size() > 2) ? atof(arguments[2].c_str()) : MAX_STEP_TIME_GROWTH;
+   if (maxStepTimeGrowth < 1.0)
+   {
+      maxStepTimeGrowth = MAX_STEP_TIME_GROWTH;
+   }
+
+   FeatureFactory::LoadAllFeatureBlueprints();
+
+   std::vector<GenerationRegressionCase> cases;
+   std::vector<GenerationRegressionResult> results;
+   GetDefaultCases(&cases);
+   RunCases(cases, &results);
+
+   *outExitCode = 0;
+   if (isRecording)
+   {
+      if (arguments.size() <= baselineArgumentIndex)
+      {
+         CreateDirectoryIfMissing(REGRESSION_BASELINE_DIRECTORY);
+      }
+
+      std::string baselineText = GetBaselineText(results);
+      std::vector<unsigned char> baselineBuffer(baselineText.begin(), baselineText.end());
+      if (SaveBufferToBinaryFile(baselineFilePath, baselineBuffer))
+      {
+         *outReport = Stringf("Recorded %d generation results to %s", (int)results.size(), baselineFilePath.c_str());
+      }
+      else
+      {
+         *outReport = Stringf("Failed to write %s", baselineFilePath.c_str());
+         *outExitCode = 1;
+      }
+   }
+   else
+   {
+      std::string baselineText;
+      if (!LoadTextFileToBuffer(baselineFilePath, baselineText))
+      {
+         baselineText.clear();
+         *outExitCode = 2;
+      }
+
+      std::vector<std::string> reportLines;
+      int numFailures = CompareToBaseline(results, baselineText, maxStepTimeGrowth, &reportLines);
+      for (const std::string& reportLine : reportLines)
+      {
+         *outReport += reportLine + "\n";
+      }
+
+      if (*outExitCode == 2)
+      {
+         *outReport += Stringf("No baseline at %s; run -genregress record first", baselineFilePath.c_str());
+      }
+      else
+      {
+         *outReport += Stringf("%d of %d generation results failed against %s", numFailures, (int)results.size(), baselineFilePath.c_str());
+         *outExitCode = (numFailures > 0) ? 1 : 0;
+      }
+   }
+
+   GeneratorRegistration::FreeAllGeneratorRegistrations();
+   FeatureFactory::FreeAllFeatureBlueprints();
+   return true;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Engine/Math/Vector2i.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+class Map;
+
+
+//-----------------------------------------------------------------------------------------------
+struct GenerationRegressionCase
+{
+   GenerationRegressionCase(const std::string& caseGeneratorName, const Vector2i& caseSize, unsigned int caseSeed, int caseNumSteps)
+      : generatorName(caseGeneratorName), size(caseSize), seed(caseSeed), numSteps(caseNumSteps) {}
+
+   std::string generatorName;
+   Vector2i size; // FromData maps take their size from the data
+   unsigned int seed;
+   int numSteps;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+struct GenerationRegressionResult
+{
+   GenerationRegressionResult() : seed(0), tileHash(0), isRepeatable(true), numStepsTaken(0), secondsPerStep(0.0), maxSecondsPerStep(0.0), finalizeSeconds(0.0) {}
+
+   std::string GetKey() const;
+
+   std::string generatorName;
+   Vector2i size;
+   unsigned int seed;
+   unsigned long long tileHash;
+   bool isRepeatable; // False if a rerun of the same case hashed differently
+   int numStepsTaken;
+   double secondsPerStep;
+   double maxSecondsPerStep;
+   double finalizeSeconds;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Runs every generator for fixed seeds at several sizes and checks the finished maps against a
+// recorded baseline. A changed hash means a generator's output changed; a step time well past the
+// baseline's means it got slower. Needs only generator and feature registrations, never a renderer
+class GenerationRegression
+{
+public:
+   static void GetDefaultCases(std::vector<GenerationRegressionCase>* outCases);
+   static void RunCase(const GenerationRegressionCase& regressionCase, GenerationRegressionResult* outResult);
+   // Runs each case NUM_TIMED_RUNS times and keeps the fastest timings, so one slow run doesn't fail it
+   static void RunCases(const std::vector<GenerationRegressionCase>& cases, std::vector<GenerationRegressionResult>* outResults);
+   static unsigned long long HashMapTiles(const Map* map);
+
+   // Returns the number of failures, with one report line per result
+   static int CompareToBaseline(const std::vector<GenerationRegressionResult>& results, const std::string& baselineText, double maxStepTimeGrowth,
+      std::vector<std::string>* outReportLines);
+   static std::string GetBaselineText(const std::vector<GenerationRegressionResult>& results);
+
+   // -genregress [record] [baselineFile] [maxStepTimeGrowth]. Returns false if the command line isn't a regression run
+   static bool RunFromCommandLine(const std::string& commandLine, std::string* outReport, int* outExitCode);
+
+   static const char* BASELINE_FILE_PATH; // One per platform, since libm's trig differs between them
+   static const int NUM_TIMED_RUNS;
+   static const double MAX_STEP_TIME_GROWTH;
+   static const double MIN_COMPARED_SECONDS_PER_STEP;
+};
\ No newline at end of file
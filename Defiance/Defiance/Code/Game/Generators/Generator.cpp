@@ -1,9 +1,9 @@
 #include <vector>
+#include <thread>
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Debug/ErrorWarningAssert.hpp"
-#include "Game/Core/TheGame.hpp"
-#include "Game/Core/GameContext.hpp"
+#include "Engine/Math/MathUtils.hpp"
 #include "Game/Generators/Generator.hpp"
 #include "Game/Map/Map.hpp"
 #include "Game/Map/Tile.hpp"
@@ -21,79 +21,197 @@ Generator::Generator(const std::string& name)
 
 
 //-----------------------------------------------------------------------------------------------
-Map* Generator::GenerateEmptyMap(const Vector2i& dimensions, const std::string& name) const
+Map* Generator::GenerateEmptyMap(const Vector2i& dimensions, const std::string& name, TileIndexLayout indexLayout) const
 {
-   std::vector<Tile> tiles;
-   tiles.resize(dimensions.x * dimensions.y);
+   Tile stoneTile(STONE_TYPE);
+   stoneTile.isHidden = false;
 
-   for (Tile& tile : tiles)
+   Map* map = new Map(dimensions, name, indexLayout, stoneTile);
+   return map;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// What finalization decided about a feature. Applied on the calling thread once every band is done
+struct FeatureDecision
+{
+   FeatureDecision(Feature* decidedFeature, const TileCoords& featureCoords, bool shouldPrune)
+      : feature(decidedFeature), coords(featureCoords), isPruned(shouldPrune) {}
+
+   Feature* feature;
+   TileCoords coords;
+   bool isPruned;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// A run of rows finalized by one thread. Bands only write their own tiles and decisions
+struct FinalizeBand
+{
+   Map* map;
+   std::vector<TileType>* paddedTypes;
+   int firstRow;
+   int endRow;
+   std::vector<FeatureDecision> featureDecisions;
+};
+
+typedef void (FinalizeBandFunc)(FinalizeBand* band);
+
+
+//-----------------------------------------------------------------------------------------------
+// The map's border becomes stone, except the far corner, which finalization has never touched
+static bool IsFinalizedBorderTile(int xIndex, int yIndex, const Vector2i& mapDimensions)
+{
+   bool isOnBorder = (xIndex == 0 || yIndex == 0 || xIndex == mapDimensions.x - 1 || yIndex == mapDimensions.y - 1);
+   bool isFarCorner = (xIndex == mapDimensions.x - 1 && yIndex == mapDimensions.y - 1);
+   return isOnBorder && !isFarCorner;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Copies tile types into a grid padded by one stone tile on every side, stoning the border on the way
+static void SnapshotFinalizeBandTypes(FinalizeBand* band)
+{
+   Map* map = band->map;
+   const Vector2i& mapDimensions = map->GetDimensions();
+   const int paddedWidth = mapDimensions.x + 2;
+   std::vector<TileType>& paddedTypes = *band->paddedTypes;
+
+   for (int yIndex = band->firstRow; yIndex < band->endRow; ++yIndex)
    {
-      tile.type = STONE_TYPE;
-      tile.typeToBecome = STONE_TYPE;
-      tile.isHidden = false;
-   }
+      for (int xIndex = 0; xIndex < mapDimensions.x; ++xIndex)
+      {
+         Tile* tile = map->GetTileAtTileCoords(TileCoords(xIndex, yIndex));
+         if (IsFinalizedBorderTile(xIndex, yIndex, mapDimensions))
+         {
+            tile->type = STONE_TYPE;
+            tile->typeToBecome = STONE_TYPE;
+         }
 
-   Map* map = new Map(tiles, dimensions, name);
-   return map;
+         paddedTypes[((yIndex + 1) * paddedWidth) + (xIndex + 1)] = tile->type;
+      }
+   }
 }
 
 
 //-----------------------------------------------------------------------------------------------
-STATIC void Generator::FinalizeMap(Map* outMap)
+// Hidden flags, visibility and door validity in one sweep. Off map reads as stone, which is never
+// air, so the counts match the map's own circular stone count and cross air count
+static void FinalizeBandTiles(FinalizeBand* band)
 {
-   std::vector<Tile>* tiles = outMap->GetAllTiles();
-   Vector2i mapDimensions = outMap->GetDimensions();
+   Map* map = band->map;
+   const Vector2i& mapDimensions = map->GetDimensions();
+   const int paddedWidth = mapDimensions.x + 2;
+   const std::vector<TileType>& paddedTypes = *band->paddedTypes;
 
-   // Set Boundaries to Stone
-   for (int xIndex = 0; xIndex < mapDimensions.x - 1; ++xIndex)
+   for (int yIndex = band->firstRow; yIndex < band->endRow; ++yIndex)
    {
-      TileIndex tileIndex = outMap->GetIndexForTileCoords(TileCoords(xIndex, 0));
-      (*tiles)[tileIndex].type = STONE_TYPE;
-      (*tiles)[tileIndex].typeToBecome = STONE_TYPE;
-      
-      tileIndex = outMap->GetIndexForTileCoords(TileCoords(xIndex, mapDimensions.y - 1));
-      (*tiles)[tileIndex].type = STONE_TYPE;
-      (*tiles)[tileIndex].typeToBecome = STONE_TYPE;
+      for (int xIndex = 0; xIndex < mapDimensions.x; ++xIndex)
+      {
+         int paddedIndex = ((yIndex + 1) * paddedWidth) + (xIndex + 1);
+         const TileType* southRow = &paddedTypes[paddedIndex - paddedWidth];
+         const TileType* centerRow = &paddedTypes[paddedIndex];
+         const TileType* northRow = &paddedTypes[paddedIndex + paddedWidth];
+
+         int neighboringStoneTiles = (southRow[-1] == STONE_TYPE) + (southRow[0] == STONE_TYPE) + (southRow[1] == STONE_TYPE)
+            + (centerRow[-1] == STONE_TYPE) + (centerRow[1] == STONE_TYPE)
+            + (northRow[-1] == STONE_TYPE) + (northRow[0] == STONE_TYPE) + (northRow[1] == STONE_TYPE);
+
+         Tile* tile = map->GetTileAtTileCoords(TileCoords(xIndex, yIndex));
+         if (neighboringStoneTiles == 8)
+         {
+            tile->isHidden = true;
+         }
+
+         tile->isVisible = false;
+         tile->isKnown = false;
+
+         if (tile->HasAFeature())
+         {
+            int neighboringAirTiles = (southRow[0] == AIR_TYPE) + (centerRow[-1] == AIR_TYPE) + (centerRow[1] == AIR_TYPE) + (northRow[0] == AIR_TYPE);
+            band->featureDecisions.push_back(FeatureDecision(tile->occupyingFeature, TileCoords(xIndex, yIndex), (neighboringAirTiles > 2)));
+         }
+
+         tile->type = tile->typeToBecome;
+      }
    }
+}
 
-   for (int yIndex = 0; yIndex < mapDimensions.y - 1; ++yIndex)
+
+//-----------------------------------------------------------------------------------------------
+static void RunFinalizeBands(std::vector<FinalizeBand>* bands, FinalizeBandFunc* bandFunc)
+{
+   std::vector<std::thread> bandThreads;
+   for (int bandIndex = 1; bandIndex < (int)bands->size(); ++bandIndex)
    {
-      TileIndex tileIndex = outMap->GetIndexForTileCoords(TileCoords(0, yIndex));
-      (*tiles)[tileIndex].type = STONE_TYPE;
-      (*tiles)[tileIndex].typeToBecome = STONE_TYPE;
+      bandThreads.push_back(std::thread(bandFunc, &(*bands)[bandIndex]));
+   }
 
-      tileIndex = outMap->GetIndexForTileCoords(TileCoords(mapDimensions.x - 1, yIndex));
-      (*tiles)[tileIndex].type = STONE_TYPE;
-      (*tiles)[tileIndex].typeToBecome = STONE_TYPE;
+   bandFunc(&(*bands)[0]);
+
+   for (std::thread& bandThread : bandThreads)
+   {
+      bandThread.join();
    }
+}
+
 
-   // Set hidden tiles
-   // and adjust for features
-   for (TileIndex index = 0; index < tiles->size(); ++index)
+//-----------------------------------------------------------------------------------------------
+STATIC const int Generator::MIN_TILES_PER_FINALIZE_THREAD = 64 * 64 * 4;
+
+
+//-----------------------------------------------------------------------------------------------
+// Every tile is read and written by exactly one band; the padded grid sits between the two passes so
+// no band ever reads a row another band is changing
+STATIC void Generator::FinalizeMap(Map* outMap, std::vector<Entity*>* outFeatures)
+{
+   const Vector2i& mapDimensions = outMap->GetDimensions();
+   std::vector<TileType> paddedTypes((mapDimensions.x + 2) * (mapDimensions.y + 2), STONE_TYPE);
+
+   int numHardwareThreads = (int)std::thread::hardware_concurrency();
+   int numBands = Clampi((mapDimensions.x * mapDimensions.y) / MIN_TILES_PER_FINALIZE_THREAD, 1, (numHardwareThreads > 0) ? numHardwareThreads : 1);
+   numBands = Clampi(numBands, 1, mapDimensions.y);
+
+   std::vector<FinalizeBand> bands(numBands);
+   for (int bandIndex = 0; bandIndex < numBands; ++bandIndex)
    {
-      TileCoords coordsToCheck = outMap->GetTileCoordsForIndex(index);
-      int neighboringStoneTiles = outMap->GetNumberOfTilesOfTypeAroundLocationCircular(coordsToCheck, STONE_TYPE, 1);
-      
-      if (neighboringStoneTiles == 8)
-      {
-         (*tiles)[index].isHidden = true;
-      }
+      FinalizeBand& band = bands[bandIndex];
+      band.map = outMap;
+      band.paddedTypes = &paddedTypes;
+      band.firstRow = (mapDimensions.y * bandIndex) / numBands;
+      band.endRow = (mapDimensions.y * (bandIndex + 1)) / numBands;
+   }
 
-      (*tiles)[index].isVisible = false;
-      (*tiles)[index].isKnown = false;
-      
-      if ((*tiles)[index].HasAFeature() && (outMap->GetNumberOfTilesOfTypeAroundLocationCross(coordsToCheck, AIR_TYPE) > 2))
-      {
-         delete (*tiles)[index].occupyingFeature;
-         (*tiles)[index].occupyingFeature = nullptr;
-      }
-      else if ((*tiles)[index].HasAFeature())
+   RunFinalizeBands(&bands, &SnapshotFinalizeBandTypes);
+   RunFinalizeBands(&bands, &FinalizeBandTiles);
+
+   // Features are kept or deleted here, in row order, so ownership never depends on thread timing
+   for (FinalizeBand& band : bands)
+   {
+      for (FeatureDecision& decision : band.featureDecisions)
       {
-         g_theGame->GetGameContext()->activeEntities.push_back((*tiles)[index].occupyingFeature);
+         Feature* feature = decision.feature;
+         if (decision.isPruned)
+         {
+            outMap->GetTileAtTileCoords(decision.coords)->occupyingFeature = nullptr;
+            outMap->GetEntityGrid()->RemoveEntity(feature);
+            delete feature;
+         }
+         else if (outFeatures != nullptr)
+         {
+            outFeatures->push_back(feature);
+         }
       }
    }
 
-   outMap->UpdateAllTilesToNewType();
+   outMap->MarkTileTypesChanged();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Generator::GenerateRegionTypes(const TileCoords&, const Vector2i&, unsigned int, const Vector2i&, std::vector<TileType>*) const
+{
+   ERROR_AND_DIE(Stringf("Error: generator %s cannot generate regions!", m_name.c_str()));
 }
 
 
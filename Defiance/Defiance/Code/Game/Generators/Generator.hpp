@@ -2,11 +2,16 @@
 
 #include <string>
 #include <map>
+#include <vector>
+#include "Game/Core/GameCommon.hpp"
+#include "Game/Map/Tile.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
 class Map;
+class Entity;
 class Vector2i;
+class RandomNumberGenerator;
 struct XMLNode;
 struct EnvironmentGenerationProcess;
 
@@ -18,14 +23,24 @@ public:
    Generator(const std::string& name);
    virtual ~Generator() {}
 
-   Map* GenerateEmptyMap(const Vector2i& dimensions, const std::string& name) const;
-   static void FinalizeMap(Map* outMap);
+   Map* GenerateEmptyMap(const Vector2i& dimensions, const std::string& name, TileIndexLayout indexLayout = ROW_MAJOR_LAYOUT) const;
+   // Features that survive are appended to outFeatures for the caller to register
+   static void FinalizeMap(Map* outMap, std::vector<Entity*>* outFeatures = nullptr);
 
-   virtual void InitializeMap(Map* outMap) const = 0;
-   virtual bool GenerateStep(Map* outMap, int* outCurrentStepNumber, EnvironmentGenerationProcess* process = nullptr) const = 0;
+   // Generation draws only from the stream it is handed, so a map depends on nothing but its seed
+   virtual void InitializeMap(Map* outMap, RandomNumberGenerator* random) const = 0;
+   virtual bool GenerateStep(Map* outMap, int* outCurrentStepNumber, RandomNumberGenerator* random, EnvironmentGenerationProcess* process = nullptr) const = 0;
+
+   // Region generation builds tile types for any rectangle of world coords from (worldSeed, coords) alone,
+   // so neighboring regions always agree along their shared border
+   virtual bool CanGenerateRegions() const { return false; }
+   virtual void GenerateRegionTypes(const TileCoords& mins, const Vector2i& size, unsigned int worldSeed, const Vector2i& worldDimensions, std::vector<TileType>* outTypes) const;
 
    const std::string& GetName() const { return m_name; }
 
+   // Smaller maps finalize on the calling thread
+   static const int MIN_TILES_PER_FINALIZE_THREAD;
+
 private:
    std::string m_name;
 };
@@ -0,0 +1,177 @@
+#include <stdlib.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Tokenizer.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/IO/FileUtils.hpp"
+#include "Engine/Time/Time.hpp"
+#include "Game/Generators/LevelBaker.hpp"
+#include "Game/Generators/Generator.hpp"
+#include "Game/Generators/MapGenerationJob.hpp"
+#include "Game/Environments/EnvironmentBlueprint.hpp"
+#include "Game/Entities/Features/FeatureFactory.hpp"
+#include "Game/IO/LevelLibrary.hpp"
+#include "Game/Map/Map.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC const char* LevelBaker::LEVEL_LIBRARY_DIRECTORY = "Data/Levels";
+STATIC const char* LevelBaker::LEVEL_LIBRARY_EXTENSION = ".levels";
+
+
+//-----------------------------------------------------------------------------------------------
+// Shared by every bake worker. Each seed's slot in levels is written by exactly one worker
+struct LevelBakeWork
+{
+   EnvironmentBlueprint* environment;
+   unsigned int firstSeed;
+   std::vector<BakedLevel>* levels;
+   std::atomic<int> nextLevelIndex;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+static void RunLevelBakeWorker(LevelBakeWork* work)
+{
+   const int numLevels = (int)work->levels->size();
+   for (int levelIndex = work->nextLevelIndex++; levelIndex < numLevels; levelIndex = work->nextLevelIndex++)
+   {
+      BakedLevel& level = (*work->levels)[levelIndex];
+      level.seed = work->firstSeed + (unsigned int)levelIndex;
+
+      MapGenerationJob job(work->environment, level.seed);
+      job.RunToCompletion();
+
+      std::vector<Entity*> features;
+      Map* map = job.TakeMap(&features);
+      LevelLibrary::EncodeLevel(map, &level);
+
+      for (Entity* feature : features)
+      {
+         delete feature;
+      }
+      delete map;
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC bool LevelBaker::BakeLevels(EnvironmentBlueprint* environment, unsigned int firstSeed, unsigned int lastSeed, int numThreads,
+   const std::string& outFilePath, LevelBakeReport* outReport)
+{
+   if (environment->IsGeneratedByRegion() || lastSeed < firstSeed)
+   {
+      return false;
+   }
+
+   double startTime = Time::GetCurrentTimeSeconds();
+
+   std::vector<BakedLevel> levels((size_t)(lastSeed - firstSeed) + 1);
+   LevelBakeWork work;
+   work.environment = environment;
+   work.firstSeed = firstSeed;
+   work.levels = &levels;
+   work.nextLevelIndex = 0;
+
+   numThreads = Clampi(numThreads, 1, (int)levels.size());
+   std::vector<std::thread> workerThreads;
+   for (int threadIndex = 1; threadIndex < numThreads; ++threadIndex)
+   {
+      workerThreads.push_back(std::thread(&RunLevelBakeWorker, &work));
+   }
+
+   RunLevelBakeWorker(&work);
+
+   for (std::thread& workerThread : workerThreads)
+   {
+      workerThread.join();
+   }
+
+   size_t numLevelBytes = 0;
+   for (const BakedLevel& level : levels)
+   {
+      numLevelBytes += level.bytes.size();
+   }
+
+   bool didWrite = LevelLibrary::WriteLibrary(outFilePath, environment->GetName(), environment->GetSize(), environment->GetTileIndexLayout(), &levels);
+
+   outReport->numLevelsBaked = (int)levels.size();
+   outReport->numThreadsUsed = numThreads;
+   outReport->elapsedSeconds = Time::GetCurrentTimeSeconds() - startTime;
+   outReport->numLevelBytes = numLevelBytes;
+   return didWrite;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Runs without a window or renderer; only the blueprints generation needs are loaded
+STATIC bool LevelBaker::RunFromCommandLine(const std::string& commandLine, std::string* outReport)
+{
+   std::vector<std::string> arguments;
+   Tokenizer argumentTokens(commandLine, " \t");
+   while (!argumentTokens.IsFinished())
+   {
+      std::string argument = argumentTokens.GetNextToken();
+      if (!argument.empty())
+      {
+         arguments.push_back(argument);
+      }
+   }
+
+   if (arguments.empty() || arguments[0] != "-bake")
+   {
+      return false;
+   }
+
+   if (arguments.size() < 4)
+   {
+      *outReport = "Usage: -bake <environment> <firstSeed> <lastSeed> [threads] [outFile]";
+      return true;
+   }
+
+   const std::string& environmentName = arguments[1];
+   unsigned int firstSeed = (unsigned int)strtoul(arguments[2].c_str(), nullptr, 10);
+   unsigned int lastSeed = (unsigned int)strtoul(arguments[3].c_str(), nullptr, 10);
+   int numThreads = (arguments.size() > 4) ? atoi(arguments[4].c_str()) : (int)std::thread::hardware_concurrency();
+   std::string outFilePath = (arguments.size() > 5) ? arguments[5] : Stringf("%s/%s%s", LEVEL_LIBRARY_DIRECTORY, environmentName.c_str(), LEVEL_LIBRARY_EXTENSION);
+
+   EnvironmentBlueprint::LoadEnvironmentBlueprints();
+   FeatureFactory::LoadAllFeatureBlueprints();
+
+   EnvironmentBlueprintMap* environments = EnvironmentBlueprint::s_environmentBlueprintMap;
+   if (environments == nullptr || environments->find(environmentName) == environments->end())
+   {
+      *outReport = Stringf("Unknown environment %s", environmentName.c_str());
+   }
+   else
+   {
+      EnvironmentBlueprint* environment = environments->find(environmentName)->second;
+      if (arguments.size() <= 5)
+      {
+         CreateDirectoryIfMissing(LEVEL_LIBRARY_DIRECTORY);
+      }
+
+      LevelBakeReport report;
+      if (BakeLevels(environment, firstSeed, lastSeed, numThreads, outFilePath, &report))
+      {
+         *outReport = Stringf("Baked %d %s maps into %s (%u bytes of levels) on %d threads in %.2fs: %.1f maps/sec",
+            report.numLevelsBaked, environmentName.c_str(), outFilePath.c_str(), (unsigned int)report.numLevelBytes,
+            report.numThreadsUsed, report.elapsedSeconds, report.GetMapsPerSecond());
+      }
+      else
+      {
+         *outReport = Stringf("Failed to bake %s into %s", environmentName.c_str(), outFilePath.c_str());
+      }
+   }
+
+   GeneratorRegistration::FreeAllGeneratorRegistrations();
+   if (environments != nullptr)
+   {
+      EnvironmentBlueprint::CleanUpEnvironmentBlueprints();
+   }
+   FeatureFactory::FreeAllFeatureBlueprints();
+   return true;
+}
\ No newline at end of file
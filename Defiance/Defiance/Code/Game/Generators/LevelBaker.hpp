@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+
+
+//-----------------------------------------------------------------------------------------------
+class EnvironmentBlueprint;
+
+
+//-----------------------------------------------------------------------------------------------
+struct LevelBakeReport
+{
+   LevelBakeReport() : numLevelsBaked(0), numThreadsUsed(0), elapsedSeconds(0.0), numLevelBytes(0) {}
+   double GetMapsPerSecond() const { return (elapsedSeconds > 0.0) ? ((double)numLevelsBaked / elapsedSeconds) : 0.0; }
+
+   int numLevelsBaked;
+   int numThreadsUsed;
+   double elapsedSeconds;
+   size_t numLevelBytes;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Generates and finalizes one map per seed in [firstSeed, lastSeed], one map per worker at a time,
+// and writes them all to a level library
+class LevelBaker
+{
+public:
+   static bool BakeLevels(EnvironmentBlueprint* environment, unsigned int firstSeed, unsigned int lastSeed, int numThreads,
+      const std::string& outFilePath, LevelBakeReport* outReport);
+
+   // -bake <environment> <firstSeed> <lastSeed> [threads] [outFile]. Returns false if the command line isn't a bake
+   static bool RunFromCommandLine(const std::string& commandLine, std::string* outReport);
+
+   static const char* LEVEL_LIBRARY_DIRECTORY;
+   static const char* LEVEL_LIBRARY_EXTENSION;
+};
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "Engine/Core/EngineCommon.hpp"
+#include "Game/Generators/MapGenerationJob.hpp"
+#include "Game/Generators/Generator.hpp"
+#include "Game/Map/Map.hpp"
+#include "Game/Map/Tile.hpp"
+#include "Game/Entities/Features/Feature.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+MapGenerationJob::MapGenerationJob(EnvironmentBlueprint* environment, unsigned int gameSeed)
+   : m_environment(environment)
+   , m_pipeline(environment, gameSeed)
+   , m_map(nullptr)
+   , m_gameSeed(gameSeed)
+   , m_totalNumberOfSteps(m_pipeline.GetTotalNumberOfSteps())
+   , m_numberOfStepsTaken(0)
+   , m_isGenerationFinished(false)
+   , m_isFinalized(false)
+   , m_isCancelled(false)
+{
+}
+
+
+//-----------------------------------------------------------------------------------------------
+MapGenerationJob::~MapGenerationJob()
+{
+   if (m_map == nullptr)
+   {
+      return;
+   }
+
+   // Features live on their tiles until the map is taken
+   const TileIndex numTilesInMap = m_map->GetNumberOfTilesInMap();
+   for (TileIndex tileIndex = 0; tileIndex < numTilesInMap; ++tileIndex)
+   {
+      Tile* tile = m_map->GetTileAtIndex(tileIndex);
+      delete tile->occupyingFeature;
+      tile->occupyingFeature = nullptr;
+   }
+
+   delete m_map;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void MapGenerationJob::Begin()
+{
+   m_map = m_pipeline.Begin();
+   m_isGenerationFinished = m_pipeline.IsFinished();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool MapGenerationJob::TryGenerationStep()
+{
+   bool didGenerateStep = m_pipeline.TryStep(m_map);
+   m_numberOfStepsTaken = m_pipeline.GetNumberOfStepsTaken();
+   m_isGenerationFinished = m_pipeline.IsFinished();
+   return didGenerateStep;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void MapGenerationJob::Finalize()
+{
+   Generator::FinalizeMap(m_map, &m_features);
+   m_isFinalized = true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Stops between steps once cancelled, leaving the job unfinalized
+void MapGenerationJob::RunToCompletion()
+{
+   if (m_map == nullptr)
+   {
+      Begin();
+   }
+
+   while (!m_isCancelled && TryGenerationStep());
+
+   if (!m_isCancelled)
+   {
+      Finalize();
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+Map* MapGenerationJob::TakeMap(std::vector<Entity*>* outFeatures)
+{
+   outFeatures->insert(outFeatures->end(), m_features.begin(), m_features.end());
+   m_features.clear();
+
+   Map* map = m_map;
+   m_map = nullptr;
+   return map;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+float MapGenerationJob::GetProgress() const
+{
+   if (m_isFinalized)
+   {
+      return 1.f;
+   }
+
+   if (m_totalNumberOfSteps <= 0)
+   {
+      return 0.f;
+   }
+
+   float progress = (float)m_numberOfStepsTaken / (float)m_totalNumberOfSteps;
+   return (progress < 1.f) ? progress : 1.f;
+}
\ No newline at end of file
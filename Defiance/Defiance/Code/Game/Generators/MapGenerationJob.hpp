@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include "Game/Generators/GenerationPipeline.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+class EnvironmentBlueprint;
+class Map;
+class Entity;
+
+
+//-----------------------------------------------------------------------------------------------
+// Builds one map for an environment, either a step at a time from the main thread or all at once
+// on a worker. A job only touches its own map and generator, never the game context
+class MapGenerationJob
+{
+public:
+   MapGenerationJob(EnvironmentBlueprint* environment, unsigned int gameSeed);
+   ~MapGenerationJob();
+
+   void Begin();
+   bool TryGenerationStep();
+   void Finalize();
+   void RunToCompletion();
+   void Cancel() { m_isCancelled = true; }
+
+   // The caller owns the map and the surviving features after this
+   Map* TakeMap(std::vector<Entity*>* outFeatures);
+
+   EnvironmentBlueprint* GetEnvironment() const { return m_environment; }
+   const Map* GetMap() const { return m_map; }
+   unsigned int GetGameSeed() const { return m_gameSeed; }
+   const std::vector<GenerationStage>& GetStages() const { return m_pipeline.GetStages(); }
+   int GetNumberOfStepsTaken() const { return m_numberOfStepsTaken; }
+   int GetTotalNumberOfSteps() const { return m_totalNumberOfSteps; }
+   float GetProgress() const;
+   bool IsGenerationFinished() const { return m_isGenerationFinished; }
+   bool IsFinalized() const { return m_isFinalized; }
+   bool IsCancelled() const { return m_isCancelled; }
+
+private:
+   MapGenerationJob(const MapGenerationJob&);
+   MapGenerationJob& operator=(const MapGenerationJob&);
+
+   EnvironmentBlueprint* m_environment;
+   GenerationPipeline m_pipeline;
+   Map* m_map;
+   std::vector<Entity*> m_features;
+   unsigned int m_gameSeed;
+   int m_totalNumberOfSteps;
+   std::atomic<int> m_numberOfStepsTaken;
+   std::atomic<bool> m_isGenerationFinished;
+   std::atomic<bool> m_isFinalized;
+   std::atomic<bool> m_isCancelled;
+};
\ No newline at end of file
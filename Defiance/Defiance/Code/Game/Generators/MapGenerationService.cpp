@@ -0,0 +1,230 @@
+#include "Engine/Core/EngineCommon.hpp"
+#include "Game/Generators/MapGenerationService.hpp"
+#include "Game/Generators/MapGenerationJob.hpp"
+#include "Game/Environments/EnvironmentBlueprint.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC const int MapGenerationService::MAX_CACHED_MAPS = 2;
+
+
+//-----------------------------------------------------------------------------------------------
+MapGenerationService::MapGenerationService(unsigned int seed)
+   : m_runningJob(nullptr)
+   , m_likelyEnvironment(nullptr)
+   , m_seedRandom(seed)
+   , m_isShuttingDown(false)
+{
+   m_workerThread = std::thread(&MapGenerationService::RunWorker, this);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+MapGenerationService::~MapGenerationService()
+{
+   {
+      std::lock_guard<std::mutex> lock(m_jobMutex);
+      m_isShuttingDown = true;
+   }
+
+   CancelAllJobs();
+   m_jobCondition.notify_all();
+   m_workerThread.join();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Main thread only. Queues a map for the likely environment when the cache doesn't have one
+void MapGenerationService::Update()
+{
+   if (m_likelyEnvironment == nullptr || m_likelyEnvironment->IsGeneratedByRegion())
+   {
+      return;
+   }
+
+   std::lock_guard<std::mutex> lock(m_jobMutex);
+   if (m_isShuttingDown || HasJobForEnvironment(m_likelyEnvironment))
+   {
+      return;
+   }
+
+   int numCachedMaps = (int)(m_queuedJobs.size() + m_readyJobs.size()) + ((m_runningJob != nullptr) ? 1 : 0);
+   if (numCachedMaps >= MAX_CACHED_MAPS && !TryEvictReadyJob())
+   {
+      return;
+   }
+
+   // The job's seed becomes the game seed if its map gets played
+   unsigned int gameSeed = (unsigned int)m_seedRandom.GetIntBetweenInclusive(1, 0x7FFFFFFF);
+   m_queuedJobs.push_back(new MapGenerationJob(m_likelyEnvironment, gameSeed));
+   m_jobCondition.notify_one();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void MapGenerationService::SetLikelyEnvironment(EnvironmentBlueprint* environment)
+{
+   m_likelyEnvironment = environment;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns a finalized job for the environment, or nullptr if none is ready yet
+MapGenerationJob* MapGenerationService::TakeReadyJob(EnvironmentBlueprint* environment)
+{
+   std::lock_guard<std::mutex> lock(m_jobMutex);
+   for (std::deque<MapGenerationJob*>::iterator jobIter = m_readyJobs.begin(); jobIter != m_readyJobs.end(); ++jobIter)
+   {
+      MapGenerationJob* readyJob = *jobIter;
+      if (readyJob->GetEnvironment() == environment)
+      {
+         m_readyJobs.erase(jobIter);
+         return readyJob;
+      }
+   }
+
+   return nullptr;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// The running job stops at its next step and the worker deletes it
+void MapGenerationService::CancelAllJobs()
+{
+   std::lock_guard<std::mutex> lock(m_jobMutex);
+   for (MapGenerationJob* queuedJob : m_queuedJobs)
+   {
+      delete queuedJob;
+   }
+   m_queuedJobs.clear();
+
+   for (MapGenerationJob* readyJob : m_readyJobs)
+   {
+      delete readyJob;
+   }
+   m_readyJobs.clear();
+
+   if (m_runningJob != nullptr)
+   {
+      m_runningJob->Cancel();
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int MapGenerationService::GetNumberOfReadyJobs() const
+{
+   std::lock_guard<std::mutex> lock(m_jobMutex);
+   return (int)m_readyJobs.size();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int MapGenerationService::GetNumberOfQueuedJobs() const
+{
+   std::lock_guard<std::mutex> lock(m_jobMutex);
+   return (int)m_queuedJobs.size() + ((m_runningJob != nullptr) ? 1 : 0);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+float MapGenerationService::GetProgressForEnvironment(EnvironmentBlueprint* environment) const
+{
+   std::lock_guard<std::mutex> lock(m_jobMutex);
+   for (MapGenerationJob* readyJob : m_readyJobs)
+   {
+      if (readyJob->GetEnvironment() == environment)
+      {
+         return 1.f;
+      }
+   }
+
+   if (m_runningJob != nullptr && m_runningJob->GetEnvironment() == environment)
+   {
+      return m_runningJob->GetProgress();
+   }
+
+   return 0.f;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Worker thread. Jobs are only touched here while they are running
+void MapGenerationService::RunWorker()
+{
+   std::unique_lock<std::mutex> lock(m_jobMutex);
+   while (true)
+   {
+      while (!m_isShuttingDown && m_queuedJobs.empty())
+      {
+         m_jobCondition.wait(lock);
+      }
+
+      if (m_isShuttingDown)
+      {
+         break;
+      }
+
+      MapGenerationJob* job = m_queuedJobs.front();
+      m_queuedJobs.pop_front();
+      m_runningJob = job;
+      lock.unlock();
+
+      job->RunToCompletion();
+
+      lock.lock();
+      m_runningJob = nullptr;
+      if (job->IsCancelled() || m_isShuttingDown)
+      {
+         delete job;
+      }
+      else
+      {
+         m_readyJobs.push_back(job);
+      }
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Expects m_jobMutex to be held
+bool MapGenerationService::HasJobForEnvironment(EnvironmentBlueprint* environment) const
+{
+   if (m_runningJob != nullptr && m_runningJob->GetEnvironment() == environment)
+   {
+      return true;
+   }
+
+   for (MapGenerationJob* queuedJob : m_queuedJobs)
+   {
+      if (queuedJob->GetEnvironment() == environment)
+      {
+         return true;
+      }
+   }
+
+   for (MapGenerationJob* readyJob : m_readyJobs)
+   {
+      if (readyJob->GetEnvironment() == environment)
+      {
+         return true;
+      }
+   }
+
+   return false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Expects m_jobMutex to be held
+bool MapGenerationService::TryEvictReadyJob()
+{
+   if (m_readyJobs.empty())
+   {
+      return false;
+   }
+
+   delete m_readyJobs.front();
+   m_readyJobs.pop_front();
+   return true;
+}
\ No newline at end of file
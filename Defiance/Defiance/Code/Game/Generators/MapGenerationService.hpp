@@ -0,0 +1,53 @@
+#pragma once
+
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "Engine/Math/RandomNumberGenerator.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+class EnvironmentBlueprint;
+class MapGenerationJob;
+
+
+//-----------------------------------------------------------------------------------------------
+// Builds maps for the environment the player is likely to pick next on a worker thread, so
+// choosing it can start play right away. Finished maps wait in a small cache, oldest evicted first
+class MapGenerationService
+{
+public:
+   MapGenerationService(unsigned int seed);
+   ~MapGenerationService();
+
+   void Update();
+   void SetLikelyEnvironment(EnvironmentBlueprint* environment);
+   MapGenerationJob* TakeReadyJob(EnvironmentBlueprint* environment);
+   void CancelAllJobs();
+
+   EnvironmentBlueprint* GetLikelyEnvironment() const { return m_likelyEnvironment; }
+   int GetNumberOfReadyJobs() const;
+   int GetNumberOfQueuedJobs() const;
+   float GetProgressForEnvironment(EnvironmentBlueprint* environment) const;
+
+   static const int MAX_CACHED_MAPS;
+
+private:
+   MapGenerationService(const MapGenerationService&);
+   MapGenerationService& operator=(const MapGenerationService&);
+
+   void RunWorker();
+   bool HasJobForEnvironment(EnvironmentBlueprint* environment) const;
+   bool TryEvictReadyJob();
+
+   std::thread m_workerThread;
+   mutable std::mutex m_jobMutex;
+   std::condition_variable m_jobCondition;
+   std::deque<MapGenerationJob*> m_queuedJobs;
+   std::deque<MapGenerationJob*> m_readyJobs;
+   MapGenerationJob* m_runningJob;
+   EnvironmentBlueprint* m_likelyEnvironment;
+   RandomNumberGenerator m_seedRandom;
+   bool m_isShuttingDown;
+};
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "ThirdParty/Parsers/XmlParser.h"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/Noise.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Game/Generators/RiverGenerator.hpp"
 #include "Game/Map/Map.hpp"
@@ -29,23 +30,26 @@ STATIC EnvironmentGenerationProcess* RiverGenerator::CreateEnvironmentGeneration
 
 
 //-----------------------------------------------------------------------------------------------
-void RiverGenerator::InitializeMap(Map* outMap) const
+void RiverGenerator::InitializeMap(Map* outMap, RandomNumberGenerator*) const
 {
-   std::vector<Tile>* mapTiles = outMap->GetAllTiles();
-   for (Tile& tile : (*mapTiles))
+   const TileIndex numTilesInMap = outMap->GetNumberOfTilesInMap();
+   for (TileIndex tileIndex = 0; tileIndex < numTilesInMap; ++tileIndex)
    {
-      tile.type = STONE_TYPE;
-      tile.typeToBecome = STONE_TYPE;
-      tile.isHidden = false;
+      Tile* tile = outMap->GetTileAtIndex(tileIndex);
+      tile->type = STONE_TYPE;
+      tile->typeToBecome = STONE_TYPE;
+      tile->isHidden = false;
    }
+
+   outMap->MarkTileTypesChanged();
 }
 
 
 //-----------------------------------------------------------------------------------------------
-bool RiverGenerator::GenerateStep(Map* outMap, int* outCurrentStepNumber, EnvironmentGenerationProcess*) const
+bool RiverGenerator::GenerateStep(Map* outMap, int* outCurrentStepNumber, RandomNumberGenerator* random, EnvironmentGenerationProcess*) const
 {
    const Vector2i& dimensions = outMap->GetDimensions();
-   TileCoords startCoords(GetRandomIntBetweenInclusive(0, dimensions.x - 1), GetRandomIntBetweenInclusive(0, dimensions.y - 1));
+   TileCoords startCoords(random->GetIntBetweenInclusive(0, dimensions.x - 1), random->GetIntBetweenInclusive(0, dimensions.y - 1));
 
    Vector2f currentPreciseCoords(startCoords);
    while (!outMap->AreTileCoordsOffMap(currentPreciseCoords))
@@ -80,4 +84,26 @@ bool RiverGenerator::GenerateStep(Map* outMap, int* outCurrentStepNumber, Enviro
    outMap->UpdateAllTilesToNewType();
    *outCurrentStepNumber = *outCurrentStepNumber + 1;
    return true;
-}
\ No newline at end of file
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Rivers follow the zero crossings of seeded perlin noise, which depends only on world coords
+void RiverGenerator::GenerateRegionTypes(const TileCoords& mins, const Vector2i& size, unsigned int worldSeed, const Vector2i&, std::vector<TileType>* outTypes) const
+{
+   const float riverHalfWidth = .06f;
+   const Vector2f seedOffset((float)(worldSeed % 4096) * 17.f, (float)((worldSeed / 4096) % 4096) * 13.f);
+
+   // Sample positions are whole numbers, so neighboring regions agree exactly on their shared noise
+   std::vector<float> perlinValues(size.x * size.y);
+   Vector2f noiseOrigin((float)mins.x + seedOffset.x, (float)mins.y + seedOffset.y);
+   ComputePerlinNoiseGrid2D(&perlinValues[0], noiseOrigin, size.x, size.y, 1.f, 40.f, 1.f, 3, .5f);
+
+   outTypes->resize(size.x * size.y);
+   for (int sampleIndex = 0; sampleIndex < (int)perlinValues.size(); ++sampleIndex)
+   {
+      float perlinValue = perlinValues[sampleIndex];
+      bool isRiver = (perlinValue > -riverHalfWidth && perlinValue < riverHalfWidth);
+      (*outTypes)[sampleIndex] = isRiver ? WATER_TYPE : STONE_TYPE;
+   }
+}
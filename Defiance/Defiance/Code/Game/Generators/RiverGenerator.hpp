@@ -20,6 +20,8 @@ public:
 
    static GeneratorRegistration s_riverGeneratorRegistration;
 
-   void InitializeMap(Map* outMap) const;
-   bool GenerateStep(Map* outMap, int* outCurrentStepNumber, EnvironmentGenerationProcess* process = nullptr) const;
+   void InitializeMap(Map* outMap, RandomNumberGenerator* random) const;
+   bool GenerateStep(Map* outMap, int* outCurrentStepNumber, RandomNumberGenerator* random, EnvironmentGenerationProcess* process = nullptr) const;
+   bool CanGenerateRegions() const { return true; }
+   void GenerateRegionTypes(const TileCoords& mins, const Vector2i& size, unsigned int worldSeed, const Vector2i& worldDimensions, std::vector<TileType>* outTypes) const;
 };
\ No newline at end of file
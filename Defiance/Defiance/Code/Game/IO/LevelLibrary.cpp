@@ -0,0 +1,464 @@
+#include <algorithm>
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/IO/FileBinaryWriter.hpp"
+#include "Game/IO/LevelLibrary.hpp"
+#include "Game/Map/Map.hpp"
+#include "Game/Map/Tile.hpp"
+#include "Game/Entities/Features/Feature.hpp"
+#include "Game/Entities/Features/FeatureFactory.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC const unsigned int LevelLibrary::LEVEL_LIBRARY_MAGIC = 0x564C4644; // "DFLV"
+STATIC const unsigned int LevelLibrary::LEVEL_LIBRARY_VERSION = 1;
+STATIC const unsigned char LevelLibrary::LEVEL_TILE_HIDDEN_FLAG = 0x80;
+
+
+//-----------------------------------------------------------------------------------------------
+static const size_t LEVEL_INDEX_ENTRY_SIZE = 12;
+static const size_t LEVEL_FEATURE_RECORD_SIZE = 6;
+static const int MAX_TILES_PER_RUN = 255;
+static const int MAX_LEVEL_DIMENSION = 65535; // Feature coords are stored in 16 bits
+
+
+//-----------------------------------------------------------------------------------------------
+// Byte at a time, so neither alignment nor the machine's endianness matter
+static void AppendUint32(std::vector<unsigned char>* outBytes, unsigned int value)
+{
+   outBytes->push_back((unsigned char)(value & 0xFF));
+   outBytes->push_back((unsigned char)((value >> 8) & 0xFF));
+   outBytes->push_back((unsigned char)((value >> 16) & 0xFF));
+   outBytes->push_back((unsigned char)((value >> 24) & 0xFF));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static void AppendUint16(std::vector<unsigned char>* outBytes, unsigned short value)
+{
+   outBytes->push_back((unsigned char)(value & 0xFF));
+   outBytes->push_back((unsigned char)((value >> 8) & 0xFF));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static unsigned int ReadUint32(const unsigned char* source)
+{
+   return (unsigned int)source[0] | ((unsigned int)source[1] << 8) | ((unsigned int)source[2] << 16) | ((unsigned int)source[3] << 24);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static unsigned short ReadUint16(const unsigned char* source)
+{
+   return (unsigned short)(source[0] | (source[1] << 8));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static bool AreBytesLeft(const unsigned char* cursor, const unsigned char* end, size_t numBytes)
+{
+   return ((size_t)(end - cursor) >= numBytes);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static bool IsBakedLevelSeedLess(const BakedLevel& first, const BakedLevel& second)
+{
+   return first.seed < second.seed;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+LevelLibrary::LevelLibrary()
+   : m_environmentName("")
+   , m_dimensions(0, 0)
+   , m_indexLayout(ROW_MAJOR_LAYOUT)
+   , m_numLevels(0)
+   , m_indexOffset(0)
+{
+}
+
+
+//-----------------------------------------------------------------------------------------------
+LevelLibrary::~LevelLibrary()
+{
+   Close();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool LevelLibrary::Open(const std::string& filePath)
+{
+   bool didOpen = true;
+
+   Close();
+   if (!m_file.OpenForReading(filePath))
+   {
+      return !didOpen;
+   }
+
+   const unsigned char* data = m_file.GetData();
+   const size_t fileSize = m_file.GetSize();
+   const size_t fixedHeaderSize = 28;
+   if (fileSize < fixedHeaderSize || ReadUint32(data) != LEVEL_LIBRARY_MAGIC || ReadUint32(data + 4) != LEVEL_LIBRARY_VERSION)
+   {
+      Close();
+      return !didOpen;
+   }
+
+   // Sizes are checked against what is left of the file before adding them, so nothing can overflow
+   unsigned int numLevels = ReadUint32(data + 8);
+   unsigned int width = ReadUint32(data + 12);
+   unsigned int height = ReadUint32(data + 16);
+   unsigned int indexLayout = ReadUint32(data + 20);
+   unsigned int nameLength = ReadUint32(data + 24);
+   if (width == 0 || width > (unsigned int)MAX_LEVEL_DIMENSION || height == 0 || height > (unsigned int)MAX_LEVEL_DIMENSION
+      || indexLayout >= (unsigned int)NUM_TILE_INDEX_LAYOUTS
+      || nameLength > fileSize - fixedHeaderSize
+      || numLevels > (fileSize - fixedHeaderSize - nameLength) / LEVEL_INDEX_ENTRY_SIZE)
+   {
+      Close();
+      return !didOpen;
+   }
+
+   m_numLevels = (int)numLevels;
+   m_dimensions = Vector2i((int)width, (int)height);
+   m_indexLayout = (TileIndexLayout)indexLayout;
+   m_indexOffset = fixedHeaderSize + nameLength;
+
+   m_environmentName.assign((const char*)(data + fixedHeaderSize), nameLength);
+   return didOpen;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void LevelLibrary::Close()
+{
+   m_file.Close();
+   m_numLevels = 0;
+   m_indexOffset = 0;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns nullptr if the seed isn't in the library, or if its level is truncated or doesn't fit the
+// library's map. Either way the caller can generate the level instead
+Map* LevelLibrary::LoadLevel(unsigned int seed, std::vector<Entity*>* outFeatures) const
+{
+   int levelIndex = FindLevelIndex(seed);
+   if (levelIndex == -1)
+   {
+      return nullptr;
+   }
+
+   const unsigned char* indexEntry = m_file.GetData() + m_indexOffset + (levelIndex * LEVEL_INDEX_ENTRY_SIZE);
+   size_t levelOffset = ReadUint32(indexEntry + 4);
+   size_t levelSize = ReadUint32(indexEntry + 8);
+   if (levelOffset > m_file.GetSize() || levelSize > m_file.GetSize() - levelOffset)
+   {
+      return nullptr;
+   }
+
+   const unsigned char* levelData = m_file.GetData() + levelOffset;
+   if (!IsLevelDataValid(levelData, levelSize))
+   {
+      return nullptr;
+   }
+
+   Tile stoneTile(STONE_TYPE);
+   stoneTile.isHidden = false;
+   Map* map = new Map(m_dimensions, m_environmentName, m_indexLayout, stoneTile);
+
+   // Runs cover the map row by row
+   unsigned int numRuns = ReadUint32(levelData);
+   levelData += 4;
+
+   int tileX = 0;
+   int tileY = 0;
+   for (unsigned int runIndex = 0; runIndex < numRuns; ++runIndex)
+   {
+      int runLength = levelData[0];
+      unsigned char tileByte = levelData[1];
+      levelData += 2;
+
+      TileType runType = (TileType)(tileByte & ~LEVEL_TILE_HIDDEN_FLAG);
+      bool isRunHidden = ((tileByte & LEVEL_TILE_HIDDEN_FLAG) != 0);
+      for (int tileInRun = 0; tileInRun < runLength; ++tileInRun)
+      {
+         Tile* tile = map->GetTileAtTileCoords(TileCoords(tileX, tileY));
+         tile->type = runType;
+         tile->typeToBecome = runType;
+         tile->isHidden = isRunHidden;
+
+         ++tileX;
+         if (tileX == m_dimensions.x)
+         {
+            tileX = 0;
+            ++tileY;
+         }
+      }
+   }
+
+   unsigned int numFeatures = ReadUint32(levelData);
+   levelData += 4;
+   for (unsigned int featureIndex = 0; featureIndex < numFeatures; ++featureIndex)
+   {
+      TileCoords featureCoords(ReadUint16(levelData), ReadUint16(levelData + 2));
+      FeatureType featureType = (FeatureType)levelData[4];
+      int nameLength = levelData[5];
+      std::string featureName((const char*)(levelData + LEVEL_FEATURE_RECORD_SIZE), nameLength);
+      levelData += LEVEL_FEATURE_RECORD_SIZE + nameLength;
+
+      Feature* feature = FeatureFactory::CreateByNameOfType(featureName, featureType);
+      feature->AddToMap(map, featureCoords);
+      outFeatures->push_back(feature);
+   }
+
+   map->MarkTileTypesChanged();
+   return map;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Walks a level without decoding it. Every run and feature record has to lie inside the level,
+// the runs have to cover the map exactly, and every feature has to be on the map and known to
+// FeatureFactory
+bool LevelLibrary::IsLevelDataValid(const unsigned char* levelData, size_t levelSize) const
+{
+   bool isValid = true;
+   const unsigned char* levelEnd = levelData + levelSize;
+
+   if (!AreBytesLeft(levelData, levelEnd, 4))
+   {
+      return !isValid;
+   }
+
+   unsigned int numRuns = ReadUint32(levelData);
+   levelData += 4;
+   if (numRuns > (size_t)(levelEnd - levelData) / 2)
+   {
+      return !isValid;
+   }
+
+   const unsigned int numTilesInMap = (unsigned int)m_dimensions.x * (unsigned int)m_dimensions.y;
+   unsigned int numTilesCovered = 0;
+   for (unsigned int runIndex = 0; runIndex < numRuns; ++runIndex)
+   {
+      unsigned int runLength = levelData[0];
+      int runType = (levelData[1] & ~LEVEL_TILE_HIDDEN_FLAG);
+      levelData += 2;
+
+      if (runLength == 0 || runLength > numTilesInMap - numTilesCovered || runType >= NUM_TILE_TYPES)
+      {
+         return !isValid;
+      }
+
+      numTilesCovered += runLength;
+   }
+
+   if (numTilesCovered != numTilesInMap || !AreBytesLeft(levelData, levelEnd, 4))
+   {
+      return !isValid;
+   }
+
+   unsigned int numFeatures = ReadUint32(levelData);
+   levelData += 4;
+   for (unsigned int featureIndex = 0; featureIndex < numFeatures; ++featureIndex)
+   {
+      if (!AreBytesLeft(levelData, levelEnd, LEVEL_FEATURE_RECORD_SIZE))
+      {
+         return !isValid;
+      }
+
+      TileCoords featureCoords(ReadUint16(levelData), ReadUint16(levelData + 2));
+      int featureType = levelData[4];
+      int nameLength = levelData[5];
+      levelData += LEVEL_FEATURE_RECORD_SIZE;
+
+      if (!AreBytesLeft(levelData, levelEnd, nameLength)
+         || featureCoords.x >= m_dimensions.x || featureCoords.y >= m_dimensions.y
+         || featureType >= NUM_FEATURE_TYPES)
+      {
+         return !isValid;
+      }
+
+      std::string featureName((const char*)levelData, nameLength);
+      levelData += nameLength;
+      if (!FeatureFactory::HasFeatureOfType(featureName, (FeatureType)featureType))
+      {
+         return !isValid;
+      }
+   }
+
+   return isValid;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+unsigned int LevelLibrary::GetSeedAtIndex(int levelIndex) const
+{
+   return ReadUint32(m_file.GetData() + m_indexOffset + (levelIndex * LEVEL_INDEX_ENTRY_SIZE));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Expects a finalized map
+STATIC void LevelLibrary::EncodeLevel(const Map* map, BakedLevel* outLevel)
+{
+   std::vector<unsigned char>& bytes = outLevel->bytes;
+   bytes.clear();
+
+   const Vector2i& dimensions = map->GetDimensions();
+   AppendUint32(&bytes, 0);
+
+   unsigned int numRuns = 0;
+   int runLength = 0;
+   unsigned char runByte = 0;
+   std::vector<const Feature*> features;
+   std::vector<TileCoords> featureCoords;
+   for (int yIndex = 0; yIndex < dimensions.y; ++yIndex)
+   {
+      for (int xIndex = 0; xIndex < dimensions.x; ++xIndex)
+      {
+         const Tile* tile = map->GetTileAtTileCoords(TileCoords(xIndex, yIndex));
+         unsigned char tileByte = (unsigned char)tile->type;
+         if (tile->isHidden)
+         {
+            tileByte |= LEVEL_TILE_HIDDEN_FLAG;
+         }
+
+         if (tile->occupyingFeature != nullptr)
+         {
+            features.push_back(tile->occupyingFeature);
+            featureCoords.push_back(TileCoords(xIndex, yIndex));
+         }
+
+         if (runLength > 0 && (tileByte != runByte || runLength == MAX_TILES_PER_RUN))
+         {
+            bytes.push_back((unsigned char)runLength);
+            bytes.push_back(runByte);
+            ++numRuns;
+            runLength = 0;
+         }
+
+         runByte = tileByte;
+         ++runLength;
+      }
+   }
+
+   if (runLength > 0)
+   {
+      bytes.push_back((unsigned char)runLength);
+      bytes.push_back(runByte);
+      ++numRuns;
+   }
+
+   bytes[0] = (unsigned char)(numRuns & 0xFF);
+   bytes[1] = (unsigned char)((numRuns >> 8) & 0xFF);
+   bytes[2] = (unsigned char)((numRuns >> 16) & 0xFF);
+   bytes[3] = (unsigned char)((numRuns >> 24) & 0xFF);
+
+   AppendUint32(&bytes, (unsigned int)features.size());
+   for (int featureIndex = 0; featureIndex < (int)features.size(); ++featureIndex)
+   {
+      const std::string& featureName = features[featureIndex]->GetName();
+      int nameLength = ((int)featureName.size() < 255) ? (int)featureName.size() : 255;
+
+      AppendUint16(&bytes, (unsigned short)featureCoords[featureIndex].x);
+      AppendUint16(&bytes, (unsigned short)featureCoords[featureIndex].y);
+      bytes.push_back((unsigned char)features[featureIndex]->GetFeatureType());
+      bytes.push_back((unsigned char)nameLength);
+      bytes.insert(bytes.end(), featureName.begin(), featureName.begin() + nameLength);
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Sorts levels by seed. Later duplicates of a seed are dropped
+STATIC bool LevelLibrary::WriteLibrary(const std::string& filePath, const std::string& environmentName, const Vector2i& dimensions,
+   TileIndexLayout indexLayout, std::vector<BakedLevel>* levels)
+{
+   bool didWrite = true;
+
+   std::stable_sort(levels->begin(), levels->end(), IsBakedLevelSeedLess);
+
+   std::vector<const BakedLevel*> uniqueLevels;
+   for (const BakedLevel& level : *levels)
+   {
+      if (uniqueLevels.empty() || uniqueLevels.back()->seed != level.seed)
+      {
+         uniqueLevels.push_back(&level);
+      }
+   }
+
+   std::vector<unsigned char> header;
+   AppendUint32(&header, LEVEL_LIBRARY_MAGIC);
+   AppendUint32(&header, LEVEL_LIBRARY_VERSION);
+   AppendUint32(&header, (unsigned int)uniqueLevels.size());
+   AppendUint32(&header, (unsigned int)dimensions.x);
+   AppendUint32(&header, (unsigned int)dimensions.y);
+   AppendUint32(&header, (unsigned int)indexLayout);
+   AppendUint32(&header, (unsigned int)environmentName.size());
+   header.insert(header.end(), environmentName.begin(), environmentName.end());
+
+   unsigned int levelOffset = (unsigned int)(header.size() + (uniqueLevels.size() * LEVEL_INDEX_ENTRY_SIZE));
+   for (const BakedLevel* level : uniqueLevels)
+   {
+      AppendUint32(&header, level->seed);
+      AppendUint32(&header, levelOffset);
+      AppendUint32(&header, (unsigned int)level->bytes.size());
+      levelOffset += (unsigned int)level->bytes.size();
+   }
+
+   FileBinaryWriter writer;
+   if (!writer.OpenFile(filePath))
+   {
+      return !didWrite;
+   }
+
+   bool wroteEverything = (writer.WriteBytes(&header[0], header.size()) == header.size());
+   for (const BakedLevel* level : uniqueLevels)
+   {
+      if (!level->bytes.empty())
+      {
+         wroteEverything = wroteEverything && (writer.WriteBytes(&level->bytes[0], level->bytes.size()) == level->bytes.size());
+      }
+   }
+
+   writer.CloseFile();
+   return wroteEverything ? didWrite : !didWrite;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Binary search over the sorted index
+int LevelLibrary::FindLevelIndex(unsigned int seed) const
+{
+   if (!m_file.IsOpen())
+   {
+      return -1;
+   }
+
+   const unsigned char* index = m_file.GetData() + m_indexOffset;
+   int lowIndex = 0;
+   int highIndex = m_numLevels - 1;
+   while (lowIndex <= highIndex)
+   {
+      int middleIndex = lowIndex + ((highIndex - lowIndex) / 2);
+      unsigned int middleSeed = ReadUint32(index + (middleIndex * LEVEL_INDEX_ENTRY_SIZE));
+      if (middleSeed == seed)
+      {
+         return middleIndex;
+      }
+      else if (middleSeed < seed)
+      {
+         lowIndex = middleIndex + 1;
+      }
+      else
+      {
+         highIndex = middleIndex - 1;
+      }
+   }
+
+   return -1;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Engine/IO/MemoryMappedFile.hpp"
+#include "Engine/Math/Vector2i.hpp"
+#include "Game/Core/GameCommon.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+class Map;
+class Entity;
+
+
+//-----------------------------------------------------------------------------------------------
+// One finished map, already encoded for a level library
+struct BakedLevel
+{
+   BakedLevel() : seed(0) {}
+
+   unsigned int seed;
+   std::vector<unsigned char> bytes;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// A file of finished maps for one environment, looked up by the seed that generated them.
+//
+// Layout, little endian:
+//    header   magic, version, level count, width, height, index layout, name length, name
+//    index    level count x (seed, offset from file start, size), sorted by seed
+//    levels   run count, runs of (count, tile byte), feature count, features of
+//             (x, y, feature type, name length, name). A tile byte is its type, plus
+//             LEVEL_TILE_HIDDEN_FLAG when hidden
+//
+// Levels are decoded straight out of the memory mapped file, so only the ones loaded are ever read
+class LevelLibrary
+{
+public:
+   LevelLibrary();
+   ~LevelLibrary();
+
+   bool Open(const std::string& filePath);
+   void Close();
+
+   bool HasLevel(unsigned int seed) const { return (FindLevelIndex(seed) != -1); }
+   Map* LoadLevel(unsigned int seed, std::vector<Entity*>* outFeatures) const;
+
+   bool IsOpen() const { return m_file.IsOpen(); }
+   int GetNumberOfLevels() const { return m_numLevels; }
+   unsigned int GetSeedAtIndex(int levelIndex) const;
+   const std::string& GetEnvironmentName() const { return m_environmentName; }
+   const Vector2i& GetDimensions() const { return m_dimensions; }
+
+   static void EncodeLevel(const Map* map, BakedLevel* outLevel);
+   static bool WriteLibrary(const std::string& filePath, const std::string& environmentName, const Vector2i& dimensions,
+      TileIndexLayout indexLayout, std::vector<BakedLevel>* levels);
+
+   static const unsigned int LEVEL_LIBRARY_MAGIC;
+   static const unsigned int LEVEL_LIBRARY_VERSION;
+   static const unsigned char LEVEL_TILE_HIDDEN_FLAG;
+
+private:
+   LevelLibrary(const LevelLibrary&);
+   LevelLibrary& operator=(const LevelLibrary&);
+
+   int FindLevelIndex(unsigned int seed) const;
+   bool IsLevelDataValid(const unsigned char* levelData, size_t levelSize) const;
+
+   MemoryMappedFile m_file;
+   std::string m_environmentName;
+   Vector2i m_dimensions;
+   TileIndexLayout m_indexLayout;
+   int m_numLevels;
+   size_t m_indexOffset;
+};
\ No newline at end of file
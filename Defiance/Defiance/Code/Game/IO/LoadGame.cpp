@@ -98,7 +98,7 @@ bool LoadGame::LoadEntities(XMLNode& topNode)
 
          loadedEntities.insert(std::pair<int, Entity*>(savedID, newPlayer));
          m_context->activePlayer = newPlayer;
-         m_context->activeAgents.insert(TurnOrderMapPair(0.f, newPlayer));
+         m_context->activeAgents.Schedule(newPlayer, 0.f);
          m_context->activeEntities.push_back(newPlayer);
          newPlayer->AddToMap(activeMap, newPlayer->GetPosition());
       }
@@ -107,7 +107,7 @@ bool LoadGame::LoadEntities(XMLNode& topNode)
          NPC* newNPC = NPCFactory::CreateNPCFromXMLNode(entityNode);
 
          loadedEntities.insert(std::pair<int, Entity*>(savedID, newNPC));
-         m_context->activeAgents.insert(TurnOrderMapPair(1.f, newNPC));
+         m_context->activeAgents.Schedule(newNPC, 1.f);
          m_context->activeEntities.push_back(newNPC);
          newNPC->AddToMap(activeMap, newNPC->GetPosition());
       }
@@ -0,0 +1,311 @@
+#include <iterator>
+#include "Engine/Core/EngineCommon.hpp"
+#include "Game/Map/EntitySpatialGrid.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC const int EntitySpatialGrid::CELL_SIZE = 8;
+
+
+//-----------------------------------------------------------------------------------------------
+EntitySpatialGrid::EntitySpatialGrid()
+   : m_cellDimensions(Vector2i::ZERO)
+   , m_numEntities(0)
+{}
+
+
+//-----------------------------------------------------------------------------------------------
+EntitySpatialGrid::EntitySpatialGrid(const Vector2i& mapDimensions)
+   : m_cellDimensions(Vector2i::ZERO)
+   , m_numEntities(0)
+{
+   Init(mapDimensions);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySpatialGrid::Init(const Vector2i& mapDimensions)
+{
+   m_cellDimensions.x = (mapDimensions.x + CELL_SIZE - 1) / CELL_SIZE;
+   m_cellDimensions.y = (mapDimensions.y + CELL_SIZE - 1) / CELL_SIZE;
+   Clear();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Entities that were in the grid keep their old slot, which ContainsEntity no longer matches
+void EntitySpatialGrid::Clear()
+{
+   m_cells.clear();
+   m_cells.resize(m_cellDimensions.x * m_cellDimensions.y);
+   m_numEntities = 0;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySpatialGrid::MoveEntity(Entity* entity, const TileCoords& newPosition)
+{
+   int newCellIndex = GetCellIndexForTileCoords(newPosition);
+   if (newCellIndex == -1)
+   {
+      RemoveEntity(entity);
+      return;
+   }
+
+   if (!ContainsEntity(entity))
+   {
+      AddToCell(entity, newPosition, newCellIndex);
+      ++m_numEntities;
+      return;
+   }
+
+   int cellIndex = entity->GetGridCellIndex();
+   if (cellIndex == newCellIndex)
+   {
+      m_cells[cellIndex][entity->GetGridSlot()].position = newPosition;
+      return;
+   }
+
+   RemoveFromCell(entity);
+   AddToCell(entity, newPosition, newCellIndex);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySpatialGrid::RemoveEntity(const Entity* entity)
+{
+   if (!ContainsEntity(entity))
+   {
+      return;
+   }
+
+   RemoveFromCell(m_cells[entity->GetGridCellIndex()][entity->GetGridSlot()].entity);
+   --m_numEntities;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// The entity's slot has to hold the entity itself, so a slot left over from another grid or from
+// before a Clear doesn't count
+bool EntitySpatialGrid::ContainsEntity(const Entity* entity) const
+{
+   int cellIndex = entity->GetGridCellIndex();
+   int slot = entity->GetGridSlot();
+   if (cellIndex < 0 || cellIndex >= (int)m_cells.size() || slot < 0 || slot >= (int)m_cells[cellIndex].size())
+   {
+      return false;
+   }
+
+   return m_cells[cellIndex][slot].entity == entity;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySpatialGrid::FindEntitiesInArea(const TileCoords& mins, const TileCoords& maxs, std::vector<Entity*>* outEntities, EntityType typeFilter) const
+{
+   if (m_cells.empty())
+   {
+      return;
+   }
+
+   TileCoords minCell = GetCellCoordsForTileCoords(mins);
+   TileCoords maxCell = GetCellCoordsForTileCoords(maxs);
+
+   for (int cellY = minCell.y; cellY <= maxCell.y; ++cellY)
+   {
+      for (int cellX = minCell.x; cellX <= maxCell.x; ++cellX)
+      {
+         for (const EntityGridEntry& entry : m_cells[(cellY * m_cellDimensions.x) + cellX])
+         {
+            const TileCoords& position = entry.position;
+            if (position.x < mins.x || position.x > maxs.x
+               || position.y < mins.y || position.y > maxs.y
+               || !DoesEntityMatchFilter(entry.entity, typeFilter))
+            {
+               continue;
+            }
+
+            outEntities->push_back(entry.entity);
+         }
+      }
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySpatialGrid::FindEntitiesInRadius(const TileCoords& center, float radius, DistanceToEntityMap* outEntities, EntityType typeFilter) const
+{
+   if (m_cells.empty() || radius < 0.f)
+   {
+      return;
+   }
+
+   int tileRadius = (int)radius + 1;
+   TileCoords minCell = GetCellCoordsForTileCoords(TileCoords(center.x - tileRadius, center.y - tileRadius));
+   TileCoords maxCell = GetCellCoordsForTileCoords(TileCoords(center.x + tileRadius, center.y + tileRadius));
+
+   DistanceToEntityMap entitiesInCells;
+   for (int cellY = minCell.y; cellY <= maxCell.y; ++cellY)
+   {
+      for (int cellX = minCell.x; cellX <= maxCell.x; ++cellX)
+      {
+         AddCellToDistanceMap(TileCoords(cellX, cellY), center, &entitiesInCells, typeFilter);
+      }
+   }
+
+   DistanceToEntityIter lastInRadius = entitiesInCells.upper_bound(radius);
+   outEntities->insert(entitiesInCells.begin(), lastInRadius);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySpatialGrid::FindNearestEntities(const TileCoords& center, int numberOfEntities, DistanceToEntityMap* outEntities, EntityType typeFilter) const
+{
+   if (m_cells.empty() || numberOfEntities <= 0)
+   {
+      return;
+   }
+
+   TileCoords centerCell = GetCellCoordsForTileCoords(center);
+   int maxRing = (m_cellDimensions.x > m_cellDimensions.y) ? m_cellDimensions.x : m_cellDimensions.y;
+
+   DistanceToEntityMap nearestEntities;
+   for (int ring = 0; ring <= maxRing; ++ring)
+   {
+      // Nothing in this ring or beyond can be closer than this
+      if (ring > 0 && (int)nearestEntities.size() >= numberOfEntities)
+      {
+         float closestPossibleDistance = (float)(((ring - 1) * CELL_SIZE) + 1);
+         DistanceToEntityIter farthestKept = nearestEntities.begin();
+         std::advance(farthestKept, numberOfEntities - 1);
+         if (farthestKept->first < closestPossibleDistance)
+         {
+            break;
+         }
+      }
+
+      for (int cellY = centerCell.y - ring; cellY <= centerCell.y + ring; ++cellY)
+      {
+         if (cellY < 0 || cellY >= m_cellDimensions.y)
+         {
+            continue;
+         }
+
+         bool isEdgeRow = (cellY == centerCell.y - ring || cellY == centerCell.y + ring);
+         int cellXStep = (isEdgeRow || ring == 0) ? 1 : (ring * 2);
+         for (int cellX = centerCell.x - ring; cellX <= centerCell.x + ring; cellX += cellXStep)
+         {
+            if (cellX < 0 || cellX >= m_cellDimensions.x)
+            {
+               continue;
+            }
+
+            AddCellToDistanceMap(TileCoords(cellX, cellY), center, &nearestEntities, typeFilter);
+         }
+      }
+   }
+
+   DistanceToEntityIter lastKept = nearestEntities.begin();
+   for (int entityIndex = 0; entityIndex < numberOfEntities && lastKept != nearestEntities.end(); ++entityIndex)
+   {
+      ++lastKept;
+   }
+   outEntities->insert(nearestEntities.begin(), lastKept);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns -1 if off the grid
+int EntitySpatialGrid::GetCellIndexForTileCoords(const TileCoords& coords) const
+{
+   if (coords.x < 0 || coords.y < 0)
+   {
+      return -1;
+   }
+
+   int cellX = coords.x / CELL_SIZE;
+   int cellY = coords.y / CELL_SIZE;
+   if (cellX >= m_cellDimensions.x || cellY >= m_cellDimensions.y)
+   {
+      return -1;
+   }
+
+   return (cellY * m_cellDimensions.x) + cellX;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Clamped to the grid
+TileCoords EntitySpatialGrid::GetCellCoordsForTileCoords(const TileCoords& coords) const
+{
+   TileCoords cellCoords(coords.x < 0 ? 0 : coords.x / CELL_SIZE, coords.y < 0 ? 0 : coords.y / CELL_SIZE);
+
+   if (cellCoords.x >= m_cellDimensions.x)
+   {
+      cellCoords.x = m_cellDimensions.x - 1;
+   }
+
+   if (cellCoords.y >= m_cellDimensions.y)
+   {
+      cellCoords.y = m_cellDimensions.y - 1;
+   }
+
+   return cellCoords;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySpatialGrid::AddToCell(Entity* entity, const TileCoords& position, int cellIndex)
+{
+   std::vector<EntityGridEntry>& cell = m_cells[cellIndex];
+   entity->SetGridLocation(cellIndex, (int)cell.size());
+   cell.push_back(EntityGridEntry(entity, position));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// The last entry in the cell moves into the freed slot
+void EntitySpatialGrid::RemoveFromCell(Entity* entity)
+{
+   int cellIndex = entity->GetGridCellIndex();
+   int slot = entity->GetGridSlot();
+   std::vector<EntityGridEntry>& cell = m_cells[cellIndex];
+
+   cell[slot] = cell.back();
+   cell[slot].entity->SetGridLocation(cellIndex, slot);
+   cell.pop_back();
+   entity->SetGridLocation(-1, -1);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void EntitySpatialGrid::AddCellToDistanceMap(const TileCoords& cellCoords, const TileCoords& center, DistanceToEntityMap* outEntities, EntityType typeFilter) const
+{
+   for (const EntityGridEntry& entry : m_cells[(cellCoords.y * m_cellDimensions.x) + cellCoords.x])
+   {
+      if (!DoesEntityMatchFilter(entry.entity, typeFilter))
+      {
+         continue;
+      }
+
+      float distanceToEntity = Vector2i::GetDistanceBetween(center, entry.position);
+      outEntities->insert(DistanceToEntityPair(distanceToEntity, entry.entity));
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC bool EntitySpatialGrid::DoesEntityMatchFilter(const Entity* entity, EntityType typeFilter)
+{
+   switch (typeFilter)
+   {
+   case AGENT_TYPE:
+      return entity->IsAgent();
+   case ITEM_TYPE:
+      return entity->IsItem();
+   case FEATURE_TYPE:
+      return entity->IsFeature();
+   default:
+      return true;
+   }
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include "Engine/Math/Vector2i.hpp"
+#include "Game/Core/GameCommon.hpp"
+#include "Game/Entities/Entity.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+// Position is kept next to the entity so range queries can reject it without touching the entity
+struct EntityGridEntry
+{
+   EntityGridEntry() : entity(nullptr), position(TileCoords::ZERO) {}
+   EntityGridEntry(Entity* gridEntity, const TileCoords& gridPosition) : entity(gridEntity), position(gridPosition) {}
+
+   Entity* entity;
+   TileCoords position;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Uniform grid of CELL_SIZE x CELL_SIZE tile buckets holding the entities on the map. Entities know
+// their own cell and slot, so moves and removals are O(1) swap-removes with no lookup by ID
+class EntitySpatialGrid
+{
+public:
+   EntitySpatialGrid();
+   EntitySpatialGrid(const Vector2i& mapDimensions);
+
+   void Init(const Vector2i& mapDimensions);
+   void Clear();
+
+   // Adds the entity if it is not in the grid yet
+   void MoveEntity(Entity* entity, const TileCoords& newPosition);
+   void AddEntity(Entity* entity, const TileCoords& position) { MoveEntity(entity, position); }
+   void RemoveEntity(const Entity* entity);
+   bool ContainsEntity(const Entity* entity) const;
+   int GetNumberOfEntities() const { return m_numEntities; }
+
+   // typeFilter of INVALID_ENTITY_TYPE matches everything
+   void FindEntitiesInArea(const TileCoords& mins, const TileCoords& maxs, std::vector<Entity*>* outEntities, EntityType typeFilter = INVALID_ENTITY_TYPE) const;
+   void FindEntitiesInRadius(const TileCoords& center, float radius, DistanceToEntityMap* outEntities, EntityType typeFilter = INVALID_ENTITY_TYPE) const;
+   void FindNearestEntities(const TileCoords& center, int numberOfEntities, DistanceToEntityMap* outEntities, EntityType typeFilter = INVALID_ENTITY_TYPE) const;
+
+   static const int CELL_SIZE;
+
+private:
+   int GetCellIndexForTileCoords(const TileCoords& coords) const;
+   TileCoords GetCellCoordsForTileCoords(const TileCoords& coords) const;
+   void AddToCell(Entity* entity, const TileCoords& position, int cellIndex);
+   void RemoveFromCell(Entity* entity);
+   void AddCellToDistanceMap(const TileCoords& cellCoords, const TileCoords& center, DistanceToEntityMap* outEntities, EntityType typeFilter) const;
+   static bool DoesEntityMatchFilter(const Entity* entity, EntityType typeFilter);
+
+   Vector2i m_cellDimensions;
+   std::vector<std::vector<EntityGridEntry>> m_cells;
+   int m_numEntities;
+};
\ No newline at end of file
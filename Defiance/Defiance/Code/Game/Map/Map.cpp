@@ -1,18 +1,32 @@
-#include <sstream>
-#include "Engine/Renderer/TheRenderer.hpp"
-#include "Engine/Renderer/BitmapFont.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
 #include "Engine/Debug/ErrorWarningAssert.hpp"
-#include "Engine/Debug/DebugRenderer.hpp"
 #include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Parsers/XMLUtilities.hpp"
+#include "Engine/IO/MemoryMappedFile.hpp"
 #include "Game/Generators/Generator.hpp"
 #include "Game/Core/GameCommon.hpp"
 #include "Game/Map/Map.hpp"
 #include "Game/Map/Tile.hpp"
-#include "Game/Entities/Agents/Player.hpp"
+#include "Game/Map/MapLegend.hpp"
 #include "Game/Entities/Features/Feature.hpp"
-#include "Game/Pathfinding/Pathfinder.hpp"
-#include "Game/FieldOfView/FieldOfView.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC const int Map::TILE_BLOCK_SIZE = 8;
+STATIC const int Map::CHUNK_SIZE = 64;
+STATIC const int Map::CHUNK_RECORD_SIZE = Map::CHUNK_SIZE * Map::CHUNK_SIZE * 2;
+STATIC const int Map::CHUNK_RESIDENCY_RADIUS = 1;
+STATIC int Map::s_numChunkCachesCreated = 0;
+
+
+//-----------------------------------------------------------------------------------------------
+// Cached tiles are 2 bytes: (type + 1) | ((typeToBecome + 1) << 4), then these flags
+static const unsigned char CACHED_TILE_HIDDEN_FLAG = 1;
+static const unsigned char CACHED_TILE_VISIBLE_FLAG = 2;
+static const unsigned char CACHED_TILE_KNOWN_FLAG = 4;
 
 
 //-----------------------------------------------------------------------------------------------
@@ -20,110 +34,178 @@ Map::Map()
    : m_showAllTiles(false)
    , m_dimensions(Vector2i::ZERO)
    , m_name("")
+   , m_indexLayout(ROW_MAJOR_LAYOUT)
+   , m_chunkDimensions(Vector2i::ZERO)
+   , m_chunkCache(nullptr)
+   , m_chunkCacheFilePath("")
+   , m_wasChunkLoadedSinceResidencyUpdate(false)
+   , m_numChunksPagedInSinceResidencyUpdate(0)
+   , m_regionGenerator(nullptr)
+   , m_worldSeed(0)
+   , m_numOpenTiles(0)
 {}
 
 
 //-----------------------------------------------------------------------------------------------
-Map::Map(const std::vector<Tile>& tiles, const Vector2i& dimenisons, const std::string& name)
+Map::Map(const Vector2i& dimenisons, const std::string& name, TileIndexLayout indexLayout, const Tile& fillTile)
    : m_showAllTiles(false)
-   , m_tiles(tiles)
    , m_dimensions(dimenisons)
    , m_name(name)
-{}
+   , m_indexLayout(indexLayout)
+   , m_entityGrid(dimenisons)
+   , m_chunkCache(nullptr)
+   , m_chunkCacheFilePath("")
+   , m_wasChunkLoadedSinceResidencyUpdate(false)
+   , m_numChunksPagedInSinceResidencyUpdate(0)
+   , m_regionGenerator(nullptr)
+   , m_worldSeed(0)
+   , m_numOpenTiles(0)
+{
+   InitChunks(fillTile);
+}
 
 
 //-----------------------------------------------------------------------------------------------
-bool Map::InitToXMLNode(const XMLNode& node, const std::string& name)
+// Nothing is generated up front. Each chunk is generated by regionGenerator the first time it is touched
+Map::Map(const Vector2i& dimenisons, const std::string& name, TileIndexLayout indexLayout, Generator* regionGenerator, unsigned int worldSeed)
+   : m_showAllTiles(false)
+   , m_dimensions(dimenisons)
+   , m_name(name)
+   , m_indexLayout(indexLayout)
+   , m_entityGrid(dimenisons)
+   , m_chunkCache(nullptr)
+   , m_chunkCacheFilePath("")
+   , m_wasChunkLoadedSinceResidencyUpdate(false)
+   , m_numChunksPagedInSinceResidencyUpdate(0)
+   , m_regionGenerator(regionGenerator)
+   , m_worldSeed(worldSeed)
+   , m_numOpenTiles(0)
 {
-   bool initSuccessful = true;
+   ASSERT_OR_DIE(regionGenerator != nullptr && regionGenerator->CanGenerateRegions(), Stringf("Defiance ERROR: Map %s needs a generator that can generate regions!", name.c_str()));
 
-   Vector2i dimensions = ReadXMLAttribute(node, "mapSize", Vector2i::ZERO);
-   m_dimensions = dimensions;
+   m_chunkDimensions.x = (m_dimensions.x + CHUNK_SIZE - 1) / CHUNK_SIZE;
+   m_chunkDimensions.y = (m_dimensions.y + CHUNK_SIZE - 1) / CHUNK_SIZE;
+   m_chunks.resize(m_chunkDimensions.x * m_chunkDimensions.y);
+   for (MapChunk& chunk : m_chunks)
+   {
+      chunk.isResident = false;
+      chunk.isGenerated = false;
+   }
+}
 
-   XMLNode tileDataNode = node.getChildNode("TileData");
-   
-   ASSERT_OR_DIE(!tileDataNode.isEmpty(), "ERROR: TileData field empty!");
 
-   std::string rawTileData = tileDataNode.getText();
-   std::stringstream tileDataStream(rawTileData);
-   
-   std::string tileRow;
-   std::vector<std::string> tileRows;
-   while (tileDataStream >> tileRow)
+//-----------------------------------------------------------------------------------------------
+Map::~Map()
+{
+   if (m_chunkCache != nullptr)
    {
-      tileRows.push_back(tileRow);
+      m_chunkCache->Close();
+      delete m_chunkCache;
+      remove(m_chunkCacheFilePath.c_str());
    }
 
-   m_dimensions.y = tileRows.size();
+   delete m_regionGenerator;
+}
+
 
-   // Longest string will be the minimum width
-   int maxLength = 0;
-   for (const std::string& row : tileRows)
+//-----------------------------------------------------------------------------------------------
+void Map::InitChunks(const Tile& fillTile)
+{
+   m_chunkDimensions.x = (m_dimensions.x + CHUNK_SIZE - 1) / CHUNK_SIZE;
+   m_chunkDimensions.y = (m_dimensions.y + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+   // Edge chunks are allocated in full so every chunk shares one local layout
+   m_chunks.clear();
+   m_chunks.resize(m_chunkDimensions.x * m_chunkDimensions.y);
+   for (MapChunk& chunk : m_chunks)
    {
-      int currentRowSize = row.size();
-      if (currentRowSize > maxLength)
-      {
-         maxLength = currentRowSize;
-      }
+      chunk.tiles.assign(CHUNK_SIZE * CHUNK_SIZE, fillTile);
    }
 
-   m_dimensions.x = maxLength;
+   m_chunksKeptResident.clear();
+   m_numOpenTiles = 0;
+}
+
 
-   // Make space for map, then init tiles
-   m_tiles.clear();
-   m_tiles.reserve(m_dimensions.x * m_dimensions.y);
+//-----------------------------------------------------------------------------------------------
+// Map text is the node's own text, or for big hand made maps a file in Data/Maps named by the
+// node's file attribute. Files are memory mapped and parsed in place
+static bool GetMapTextForXMLNode(const XMLNode& textNode, MemoryMappedFile* textFile, const char** outText, size_t* outTextLength)
+{
+   bool didGetText = true;
 
-   for (int rowIndex = tileRows.size() - 1; rowIndex >= 0; --rowIndex)
+   std::string fileName = ReadXMLAttribute(textNode, "file", std::string(""));
+   if (fileName.empty())
    {
-      const std::string& row(tileRows[rowIndex]);
-      for (int charIndex = 0; charIndex < m_dimensions.x; ++charIndex)
-      {
-         // If characters are missing, make stone tiles
-         if (charIndex >= (int)row.size())
-         {
-            m_tiles.push_back(Tile(STONE_TYPE));
-            continue;
-         }
+      const char* nodeText = textNode.getText();
+      *outText = nodeText;
+      *outTextLength = (nodeText != nullptr) ? strlen(nodeText) : 0;
+      return didGetText;
+   }
 
-         // #TODO - update this with legend!
-         if (row[charIndex] == '#')
-         {
-            m_tiles.push_back(Tile(STONE_TYPE));
-         }
-         else if (row[charIndex] == '~')
-         {
-            m_tiles.push_back(Tile(WATER_TYPE));
-         }
-         else // char = .
-         {
-            m_tiles.push_back(Tile(AIR_TYPE));
-         }
-      }
+   if (!textFile->OpenForReading(Stringf("Data/Maps/%s", fileName.c_str())))
+   {
+      return !didGetText;
    }
+
+   *outText = (const char*)textFile->GetData();
+   *outTextLength = textFile->GetSize();
+   return didGetText;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static bool IsMapTextWhitespace(char character)
+{
+   return ((unsigned char)character <= ' ');
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool Map::InitToXMLNode(const XMLNode& node, const std::string& name)
+{
+   bool initSuccessful = true;
+
+   MapLegend legend;
+   XMLNode legendNode = node.getChildNode("Legend");
+   if (!legendNode.isEmpty())
+   {
+      legend.AddGlyphsFromXMLNode(legendNode);
+   }
+
+   XMLNode tileDataNode = node.getChildNode("TileData");
+   ASSERT_OR_DIE(!tileDataNode.isEmpty(), "ERROR: TileData field empty!");
+
+   MemoryMappedFile tileDataFile;
+   const char* tileText = nullptr;
+   size_t tileTextLength = 0;
+   if (!GetMapTextForXMLNode(tileDataNode, &tileDataFile, &tileText, &tileTextLength))
+   {
+      return !initSuccessful;
+   }
+
+   // The text decides the size. Saves also write mapSize, which a hand edit can leave stale
+   Vector2i dimensions = MeasureMapText(tileText, tileTextLength);
+   Vector2i savedDimensions = ReadXMLAttribute(node, "mapSize", dimensions);
+   ASSERT_OR_DIE(savedDimensions == dimensions, Stringf("ERROR: Map %s has mapSize %d,%d but its tile text is %d,%d!",
+      name.c_str(), savedDimensions.x, savedDimensions.y, dimensions.x, dimensions.y));
+
+   std::string layoutString = ReadXMLAttribute(node, "indexLayout", GetStringForTileIndexLayout(m_indexLayout));
+   InitToTileText(tileText, tileTextLength, dimensions, GetTileIndexLayoutForString(layoutString), legend);
+   tileDataFile.Close();
+
    Generator::FinalizeMap(this);
 
    // Check for visibility data
    XMLNode visibilityNode = node.getChildNode("VisibilityData");
    if (!visibilityNode.isEmpty())
    {
-      std::string visibilityString = visibilityNode.getText();
-      int stringIndex = 0;
-      for (int yIndex = 0; yIndex < m_dimensions.y; ++yIndex)
+      MemoryMappedFile visibilityFile;
+      const char* visibilityText = nullptr;
+      size_t visibilityTextLength = 0;
+      if (GetMapTextForXMLNode(visibilityNode, &visibilityFile, &visibilityText, &visibilityTextLength))
       {
-         for (int xIndex = 0; xIndex < m_dimensions.x; ++xIndex)
-         {
-            TileIndex tileIndex = GetIndexForTileCoords(TileCoords(xIndex, yIndex));
-            Tile* tile = GetTileAtIndex(tileIndex);
-
-            if (visibilityString[stringIndex] == '#')
-            {
-               tile->isKnown = true;
-            }
-            ++stringIndex;
-         }
-
-         // eat the newline
-         ++stringIndex;
+         ApplyVisibilityText(visibilityText, visibilityTextLength);
       }
    }
 
@@ -136,194 +218,590 @@ bool Map::InitToXMLNode(const XMLNode& node, const std::string& name)
 
 
 //-----------------------------------------------------------------------------------------------
-void Map::UpdateAllTilesToNewType()
+// Rows missing characters, or missing entirely, are left as stone
+void Map::InitToTileText(const char* tileText, size_t textLength, const Vector2i& dimensions, TileIndexLayout indexLayout, const MapLegend& legend)
 {
-   for (Tile& tile : m_tiles)
-   {
-      tile.type = tile.typeToBecome;
-   }
+   m_dimensions = dimensions;
+   m_entityGrid.Init(m_dimensions);
+   m_indexLayout = indexLayout;
+
+   InitChunks(Tile(STONE_TYPE));
+   ParseMapText(tileText, textLength, legend.glyphTypes, false);
+   MarkTileTypesChanged();
 }
 
 
-// #TODO - remember last seen feature state
 //-----------------------------------------------------------------------------------------------
-void Map::Render() const
+// Same layout as the tile text. # is known, anything else is not
+void Map::ApplyVisibilityText(const char* visibilityText, size_t textLength)
 {
-   const Vector2f screenCenter(800.f, 450.f);
-   const Vector2f mapSize(m_dimensions.x * 20.f, m_dimensions.y * 20.f);
-   const Vector2f startLocation(screenCenter - (mapSize / 2.f));
+   signed char glyphIsKnown[256];
+   memset(glyphIsKnown, 0, sizeof(glyphIsKnown));
+   glyphIsKnown['#'] = 1;
 
-   const BitmapFont* font = BitmapFont::CreateOrGetFont("CopperplateGothicBold");
+   ParseMapText(visibilityText, textLength, glyphIsKnown, true);
+}
 
 
-   int currentIndex = 0;
-   for (const Tile& tile : m_tiles)
+//-----------------------------------------------------------------------------------------------
+// Rows are runs of non-whitespace, top row first. One pass over the text, writing straight into
+// the chunk storage. Anything past the map's dimensions is ignored
+void Map::ParseMapText(const char* text, size_t textLength, const signed char* glyphValues, bool isVisibilityText)
+{
+   const char* textEnd = text + textLength;
+   const char* cursor = text;
+
+   for (int yIndex = m_dimensions.y - 1; yIndex >= 0; --yIndex)
    {
-      if (tile.isHidden
-         || (!m_showAllTiles && !tile.isKnown))
+      while (cursor < textEnd && IsMapTextWhitespace(*cursor))
       {
-         ++currentIndex;
-         continue;
+         ++cursor;
+      }
+
+      const char* rowStart = cursor;
+      while (cursor < textEnd && !IsMapTextWhitespace(*cursor))
+      {
+         ++cursor;
       }
 
-      TileCoords tCoords = GetTileCoordsForIndex(currentIndex);
-      float xLocation = startLocation.x + (tCoords.x * 20.f);
-      float yLocation = startLocation.y + (tCoords.y * 20.f);
+      int rowLength = cursor - rowStart;
+      if (rowLength == 0)
+      {
+         break;
+      }
 
-      Vector2f tileLocation(xLocation, yLocation);
+      if (rowLength > m_dimensions.x)
+      {
+         rowLength = m_dimensions.x;
+      }
 
-      if (tile.IsOccupiedByAgent() 
-         && (tile.isVisible || m_showAllTiles))
+      const int localY = yIndex % CHUNK_SIZE;
+      const int chunkRowStart = (yIndex / CHUNK_SIZE) * m_chunkDimensions.x;
+      Tile* chunkTiles = nullptr;
+      for (int xIndex = 0; xIndex < rowLength; ++xIndex)
       {
-         Agent* agent = tile.occupyingAgent;
-         std::string glyphAsString;
-         glyphAsString.push_back(agent->GetGlyph());
-         g_theRenderer->DrawText2D(tileLocation, glyphAsString, agent->GetColor(), 30.f, font);
-         ++currentIndex;
-         continue;
+         const int localX = xIndex % CHUNK_SIZE;
+         if (localX == 0)
+         {
+            chunkTiles = m_chunks[chunkRowStart + (xIndex / CHUNK_SIZE)].tiles.data();
+         }
+
+         Tile& tile = chunkTiles[GetIndexInChunk(localX, localY, m_indexLayout)];
+         signed char glyphValue = glyphValues[(unsigned char)rowStart[xIndex]];
+         if (isVisibilityText)
+         {
+            tile.isKnown = (glyphValue != 0);
+         }
+         else
+         {
+            tile.type = (TileType)glyphValue;
+            tile.typeToBecome = (TileType)glyphValue;
+         }
+      }
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Row count and longest row of some map text, without touching any tiles
+STATIC Vector2i Map::MeasureMapText(const char* text, size_t textLength)
+{
+   Vector2i textDimensions(0, 0);
+   const char* textEnd = text + textLength;
+   const char* cursor = text;
+   while (cursor < textEnd)
+   {
+      while (cursor < textEnd && IsMapTextWhitespace(*cursor))
+      {
+         ++cursor;
       }
 
-      if (tile.HasItems()
-         && (tile.isVisible || m_showAllTiles))
+      const char* rowStart = cursor;
+      while (cursor < textEnd && !IsMapTextWhitespace(*cursor))
       {
-         std::string glyphAsString;
-         glyphAsString.push_back(tile.GetItemGlyph());
-         g_theRenderer->DrawText2D(tileLocation, glyphAsString, Rgba::YELLOW, 30.f, font);
-         ++currentIndex;
-         continue;
+         ++cursor;
       }
 
-      if (tile.HasAFeature()
-         && (tile.isVisible || m_showAllTiles))
+      int rowLength = cursor - rowStart;
+      if (rowLength == 0)
       {
-         std::string glyphAsString;
-         glyphAsString.push_back(tile.occupyingFeature->GetGlyphForCurrentState());
-         g_theRenderer->DrawText2D(tileLocation, glyphAsString, Rgba::YELLOW, 30.f, font);
-         ++currentIndex;
-         continue;
+         break;
       }
 
-      unsigned char tileAlpha = tile.isVisible ? 255 : 50;
+      ++textDimensions.y;
+      if (rowLength > textDimensions.x)
+      {
+         textDimensions.x = rowLength;
+      }
+   }
+
+   return textDimensions;
+}
+
 
-      if (tile.type == STONE_TYPE)
+//-----------------------------------------------------------------------------------------------
+void Map::UpdateAllTilesToNewType()
+{
+   for (int chunkIndex = 0; chunkIndex < (int)m_chunks.size(); ++chunkIndex)
+   {
+      if (!m_chunks[chunkIndex].isGenerated)
       {
-         g_theRenderer->DrawText2D(tileLocation, "#", Rgba(255, 255, 255, tileAlpha), 30.f, font);
+         continue;
       }
-      else if (tile.type == AIR_TYPE)
+
+      if (!m_chunks[chunkIndex].isResident)
       {
-         g_theRenderer->DrawText2D(tileLocation + Vector2f(5.f, 8.f), ".", Rgba(255, 255, 255, tileAlpha), 30.f, font);
+         LoadChunkFromCache(chunkIndex);
       }
-      else if (tile.type == WATER_TYPE)
+
+      for (Tile& tile : m_chunks[chunkIndex].tiles)
       {
-         g_theRenderer->DrawText2D(tileLocation, "~", Rgba(0, 0, 255, tileAlpha), 30.f, font);
+         tile.type = tile.typeToBecome;
       }
 
-      ++currentIndex;
+      MarkChunkTileTypesChanged(chunkIndex);
    }
 }
 
 
 //-----------------------------------------------------------------------------------------------
-void Map::RenderPath(const Path& path) const
+// Tiles can only have been changed in resident chunks, so evicted chunks keep their summaries
+void Map::MarkTileTypesChanged()
 {
-   const Vector2f screenCenter(800.f, 450.f);
-   const Vector2f mapSize(m_dimensions.x * 20.f, m_dimensions.y * 20.f);
-   const Vector2f startLocation(screenCenter - (mapSize / 2.f));
+   for (int chunkIndex = 0; chunkIndex < (int)m_chunks.size(); ++chunkIndex)
+   {
+      if (m_chunks[chunkIndex].isResident)
+      {
+         MarkChunkTileTypesChanged(chunkIndex);
+      }
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Map::MarkChunkTileTypesChanged(int chunkIndex) const
+{
+   m_chunks[chunkIndex].areTileTypeCountsDirty = true;
+   m_chunks[chunkIndex].isOpenTileListDirty = true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+Tile* Map::GetTileAtIndex(TileIndex index)
+{
+   return GetTileInChunk(GetTileCoordsForIndex(index));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+const Tile* Map::GetTileAtIndex(TileIndex index) const
+{
+   return GetTileInChunk(GetTileCoordsForIndex(index));
+}
+
 
-   // Render open list
-   for (const PathNode* const node : path.openList)
+//-----------------------------------------------------------------------------------------------
+Tile* Map::GetTileAtTileCoords(const TileCoords& coords)
+{
+   Tile* tile = GetTileInChunk(coords);
+   return tile;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+const Tile* Map::GetTileAtTileCoords(const TileCoords& coords) const
+{
+   const Tile* tile = GetTileInChunk(coords);
+   return tile;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int Map::GetChunkIndexForTileCoords(const TileCoords& location) const
+{
+   return ((location.y / CHUNK_SIZE) * m_chunkDimensions.x) + (location.x / CHUNK_SIZE);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+TileCoords Map::GetChunkMins(int chunkIndex) const
+{
+   return TileCoords((chunkIndex % m_chunkDimensions.x) * CHUNK_SIZE, (chunkIndex / m_chunkDimensions.x) * CHUNK_SIZE);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Generates the chunk, or pages it back in from the cache if it was evicted
+Tile* Map::GetTileInChunk(const TileCoords& location) const
+{
+   int chunkIndex = GetChunkIndexForTileCoords(location);
+   MapChunk& chunk = m_chunks[chunkIndex];
+   if (!chunk.isGenerated)
    {
-      const TileCoords& tCoords = node->position;
-      float xLocation = startLocation.x + (tCoords.x * 20.f);
-      float yLocation = startLocation.y + (tCoords.y * 20.f);
+      GenerateChunk(chunkIndex);
+   }
+   else if (!chunk.isResident)
+   {
+      LoadChunkFromCache(chunkIndex);
+   }
 
-      Vector2f tileLocation(xLocation, yLocation - 20.f);
+   int indexInChunk = GetIndexInChunk(location.x % CHUNK_SIZE, location.y % CHUNK_SIZE, m_indexLayout);
+   return &(chunk.tiles[indexInChunk]);
+}
 
-      g_theRenderer->DrawAABB2(AABB2(tileLocation, Vector2f(tileLocation.x + 20.f, tileLocation.y + 20.f)), Rgba(0, 0, 100, 120));
+
+//-----------------------------------------------------------------------------------------------
+STATIC int Map::GetIndexInChunk(int localX, int localY, TileIndexLayout layout)
+{
+   if (layout == TILED_LAYOUT)
+   {
+      const int blocksPerChunkRow = CHUNK_SIZE / TILE_BLOCK_SIZE;
+      int blockIndex = ((localY / TILE_BLOCK_SIZE) * blocksPerChunkRow) + (localX / TILE_BLOCK_SIZE);
+      int mortonIndex = GetMortonIndexInBlock(localX % TILE_BLOCK_SIZE, localY % TILE_BLOCK_SIZE);
+      return (blockIndex * TILE_BLOCK_SIZE * TILE_BLOCK_SIZE) + mortonIndex;
+   }
+
+   return (localY * CHUNK_SIZE) + localX;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Interleave the 3 bits of x and y
+STATIC int Map::GetMortonIndexInBlock(int localX, int localY)
+{
+   int mortonIndex = (localX & 1) | ((localY & 1) << 1)
+      | ((localX & 2) << 1) | ((localY & 2) << 2)
+      | ((localX & 4) << 2) | ((localY & 4) << 3);
+
+   return mortonIndex;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Every map gets its own cache file, so a map being torn down never deletes its replacement's cache
+bool Map::EnableChunkStreaming(const std::string& cacheDirectory)
+{
+   bool didEnable = true;
+   if (m_chunkCache != nullptr)
+   {
+      return didEnable;
+   }
+
+   std::string cacheFilePath = Stringf("%s/Map%d.ChunkCache", cacheDirectory.c_str(), s_numChunkCachesCreated);
+   ++s_numChunkCachesCreated;
+
+   MemoryMappedFile* chunkCache = new MemoryMappedFile();
+   if (!chunkCache->CreateForReadWrite(cacheFilePath, m_chunks.size() * CHUNK_RECORD_SIZE))
+   {
+      delete chunkCache;
+      return !didEnable;
+   }
+
+   m_chunkCache = chunkCache;
+   m_chunkCacheFilePath = cacheFilePath;
+   return didEnable;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Keeps every chunk within CHUNK_RESIDENCY_RADIUS chunks of an active position and tries to evict the rest
+void Map::UpdateChunkResidency(const std::vector<TileCoords>& activePositions)
+{
+   if (m_chunkCache == nullptr)
+   {
+      return;
    }
 
-   // Render closed list
-   for (const PathNode* const node : path.closedList)
+   std::vector<int> chunksToKeep;
+   chunksToKeep.reserve(activePositions.size() * (2 * CHUNK_RESIDENCY_RADIUS + 1) * (2 * CHUNK_RESIDENCY_RADIUS + 1));
+   for (const TileCoords& position : activePositions)
    {
-      const TileCoords& tCoords = node->position;
-      float xLocation = startLocation.x + (tCoords.x * 20.f);
-      float yLocation = startLocation.y + (tCoords.y * 20.f);
+      if (AreTileCoordsOffMap(position))
+      {
+         continue;
+      }
+
+      int minChunkX = Clampi((position.x / CHUNK_SIZE) - CHUNK_RESIDENCY_RADIUS, 0, m_chunkDimensions.x - 1);
+      int maxChunkX = Clampi((position.x / CHUNK_SIZE) + CHUNK_RESIDENCY_RADIUS, 0, m_chunkDimensions.x - 1);
+      int minChunkY = Clampi((position.y / CHUNK_SIZE) - CHUNK_RESIDENCY_RADIUS, 0, m_chunkDimensions.y - 1);
+      int maxChunkY = Clampi((position.y / CHUNK_SIZE) + CHUNK_RESIDENCY_RADIUS, 0, m_chunkDimensions.y - 1);
+      for (int chunkY = minChunkY; chunkY <= maxChunkY; ++chunkY)
+      {
+         for (int chunkX = minChunkX; chunkX <= maxChunkX; ++chunkX)
+         {
+            chunksToKeep.push_back((chunkY * m_chunkDimensions.x) + chunkX);
+         }
+      }
+   }
+
+   std::sort(chunksToKeep.begin(), chunksToKeep.end());
+   chunksToKeep.erase(std::unique(chunksToKeep.begin(), chunksToKeep.end()), chunksToKeep.end());
+
+   // Nothing moved between chunks or was paged in since the last pass
+   if (chunksToKeep == m_chunksKeptResident && !m_wasChunkLoadedSinceResidencyUpdate)
+   {
+      return;
+   }
+
+   // Agents only look and step around where they stand, so everything paged back in since the last
+   // pass should be near one of them. Much more than that means something is scanning evicted regions
+   // and streaming is thrashing the cache instead of bounding memory
+   ASSERT_RECOVERABLE(m_numChunksPagedInSinceResidencyUpdate <= (int)chunksToKeep.size(),
+      Stringf("Defiance WARNING: %d map chunks were paged in since the last residency update, but only %d are near agents!",
+      m_numChunksPagedInSinceResidencyUpdate, (int)chunksToKeep.size()));
+
+   m_chunksKeptResident.swap(chunksToKeep);
+   m_wasChunkLoadedSinceResidencyUpdate = false;
+   m_numChunksPagedInSinceResidencyUpdate = 0;
 
-      Vector2f tileLocation(xLocation, yLocation - 20.f);
+   int numPinnedChunks = 0;
+   std::vector<int>::const_iterator keepIter = m_chunksKeptResident.begin();
+   for (int chunkIndex = 0; chunkIndex < (int)m_chunks.size(); ++chunkIndex)
+   {
+      if (keepIter != m_chunksKeptResident.end() && *keepIter == chunkIndex)
+      {
+         ++keepIter;
+         continue;
+      }
 
-      g_theRenderer->DrawAABB2(AABB2(tileLocation, Vector2f(tileLocation.x + 20.f, tileLocation.y + 20.f)), Rgba(100, 0, 0, 120));
+      if (!TryEvictChunk(chunkIndex) && m_chunks[chunkIndex].isResident)
+      {
+         ++numPinnedChunks;
+      }
    }
 
-   // Render goal
-   TileCoords tCoords = path.pathEnd;
-   float xLocation = startLocation.x + (tCoords.x * 20.f);
-   float yLocation = startLocation.y + (tCoords.y * 20.f);
+   // Memory stays bounded by the agents' neighborhoods plus the chunks their entities pin
+   ASSERT_RECOVERABLE(GetNumberOfResidentChunks() <= (int)m_chunksKeptResident.size() + numPinnedChunks,
+      "Defiance WARNING: Map chunks far from every agent stayed resident after a residency update!");
+}
 
-   Vector2f tileLocation(xLocation, yLocation - 20.f);
 
-   g_theRenderer->DrawAABB2(AABB2(tileLocation, Vector2f(tileLocation.x + 20.f, tileLocation.y + 20.f)), Rgba(0, 100, 0, 120));
+//-----------------------------------------------------------------------------------------------
+// Pages in (or generates) everything UpdateChunkResidency would keep for an agent standing at position
+void Map::MakeChunksResidentAround(const TileCoords& position)
+{
+   if (AreTileCoordsOffMap(position))
+   {
+      return;
+   }
+
+   int minChunkX = Clampi((position.x / CHUNK_SIZE) - CHUNK_RESIDENCY_RADIUS, 0, m_chunkDimensions.x - 1);
+   int maxChunkX = Clampi((position.x / CHUNK_SIZE) + CHUNK_RESIDENCY_RADIUS, 0, m_chunkDimensions.x - 1);
+   int minChunkY = Clampi((position.y / CHUNK_SIZE) - CHUNK_RESIDENCY_RADIUS, 0, m_chunkDimensions.y - 1);
+   int maxChunkY = Clampi((position.y / CHUNK_SIZE) + CHUNK_RESIDENCY_RADIUS, 0, m_chunkDimensions.y - 1);
+   for (int chunkY = minChunkY; chunkY <= maxChunkY; ++chunkY)
+   {
+      for (int chunkX = minChunkX; chunkX <= maxChunkX; ++chunkX)
+      {
+         int chunkIndex = (chunkY * m_chunkDimensions.x) + chunkX;
+         if (!m_chunks[chunkIndex].isGenerated)
+         {
+            GenerateChunk(chunkIndex);
+         }
+         else if (!m_chunks[chunkIndex].isResident)
+         {
+            LoadChunkFromCache(chunkIndex);
+         }
+      }
+   }
 }
 
 
 //-----------------------------------------------------------------------------------------------
-void Map::RenderRaycastResult(const Vector2f& start, const Vector2f& end, const RaycastResult& result) const
+bool Map::IsTileResident(const TileCoords& coords) const
 {
-   const Vector2f screenCenter(800.f, 450.f);
-   const Vector2f mapSize(m_dimensions.x * 20.f, m_dimensions.y * 20.f);
-   const Vector2f startLocation(screenCenter - (mapSize / 2.f));
+   return m_chunks[GetChunkIndexForTileCoords(coords)].isResident;
+}
 
-   float xLocation = startLocation.x + (start.x * 20.f);
-   float yLocation = startLocation.y + (start.y * 20.f);
-   Vector2f lineStart(xLocation, yLocation);
 
-   xLocation = startLocation.x + (result.impactPos.x * 20.f);
-   yLocation = startLocation.y + (result.impactPos.y * 20.f);
-   Vector2f lineEnd(xLocation, yLocation);
+//-----------------------------------------------------------------------------------------------
+int Map::GetNumberOfGeneratedChunks() const
+{
+   int numGeneratedChunks = 0;
+   for (const MapChunk& chunk : m_chunks)
+   {
+      if (chunk.isGenerated)
+      {
+         ++numGeneratedChunks;
+      }
+   }
+
+   return numGeneratedChunks;
+}
 
-   Rgba lineColor = result.didImpact ? Rgba::RED : Rgba::GREEN;
 
-   g_theRenderer->DrawLine(lineStart, lineEnd, lineColor, 3.f);
+//-----------------------------------------------------------------------------------------------
+void Map::GenerateRegionsInArea(const TileCoords& mins, const TileCoords& maxs)
+{
+   int minChunkX = Clampi(mins.x, 0, m_dimensions.x - 1) / CHUNK_SIZE;
+   int minChunkY = Clampi(mins.y, 0, m_dimensions.y - 1) / CHUNK_SIZE;
+   int maxChunkX = Clampi(maxs.x, 0, m_dimensions.x - 1) / CHUNK_SIZE;
+   int maxChunkY = Clampi(maxs.y, 0, m_dimensions.y - 1) / CHUNK_SIZE;
 
-   xLocation = startLocation.x + (end.x * 20.f);
-   yLocation = startLocation.y + (end.y * 20.f);
-   Vector2f endLoc(xLocation, yLocation);
-   g_theRenderer->DrawPoint(endLoc, Rgba::GREEN, 3.f);
+   for (int chunkY = minChunkY; chunkY <= maxChunkY; ++chunkY)
+   {
+      for (int chunkX = minChunkX; chunkX <= maxChunkX; ++chunkX)
+      {
+         int chunkIndex = (chunkY * m_chunkDimensions.x) + chunkX;
+         if (!m_chunks[chunkIndex].isGenerated)
+         {
+            GenerateChunk(chunkIndex);
+         }
+      }
+   }
 }
 
 
 //-----------------------------------------------------------------------------------------------
-Tile* Map::GetTileAtIndex(TileIndex index)
+// Does what the whole-map generation steps plus Generator::FinalizeMap would do, for one chunk.
+// The generator fills in a 1 tile apron as well so hidden tiles are found without touching neighbors
+void Map::GenerateChunk(int chunkIndex) const
 {
-   return &(m_tiles[index]);
+   MapChunk& chunk = m_chunks[chunkIndex];
+   TileCoords chunkMins = GetChunkMins(chunkIndex);
+   TileCoords regionMins(chunkMins.x - 1, chunkMins.y - 1);
+   Vector2i regionSize(CHUNK_SIZE + 2, CHUNK_SIZE + 2);
+
+   std::vector<TileType> regionTypes;
+   m_regionGenerator->GenerateRegionTypes(regionMins, regionSize, m_worldSeed, m_dimensions, &regionTypes);
+
+   // The map border and everything past it is stone
+   for (int regionY = 0; regionY < regionSize.y; ++regionY)
+   {
+      for (int regionX = 0; regionX < regionSize.x; ++regionX)
+      {
+         TileCoords worldCoords(regionMins.x + regionX, regionMins.y + regionY);
+         if (worldCoords.x <= 0 || worldCoords.x >= m_dimensions.x - 1 || worldCoords.y <= 0 || worldCoords.y >= m_dimensions.y - 1)
+         {
+            regionTypes[(regionY * regionSize.x) + regionX] = STONE_TYPE;
+         }
+      }
+   }
+
+   chunk.tiles.assign(CHUNK_SIZE * CHUNK_SIZE, Tile(STONE_TYPE));
+   for (int localY = 0; localY < CHUNK_SIZE; ++localY)
+   {
+      for (int localX = 0; localX < CHUNK_SIZE; ++localX)
+      {
+         int neighboringStoneTiles = 0;
+         for (int yOffset = -1; yOffset <= 1; ++yOffset)
+         {
+            for (int xOffset = -1; xOffset <= 1; ++xOffset)
+            {
+               if ((xOffset != 0 || yOffset != 0)
+                  && regionTypes[((localY + 1 + yOffset) * regionSize.x) + (localX + 1 + xOffset)] == STONE_TYPE)
+               {
+                  ++neighboringStoneTiles;
+               }
+            }
+         }
+
+         Tile& tile = chunk.tiles[GetIndexInChunk(localX, localY, m_indexLayout)];
+         tile.type = regionTypes[((localY + 1) * regionSize.x) + (localX + 1)];
+         tile.typeToBecome = tile.type;
+         tile.isHidden = (neighboringStoneTiles == 8);
+         tile.isVisible = false;
+         tile.isKnown = false;
+      }
+   }
+
+   chunk.isGenerated = true;
+   chunk.isResident = true;
+   m_wasChunkLoadedSinceResidencyUpdate = true;
+   MarkChunkTileTypesChanged(chunkIndex);
 }
 
 
 //-----------------------------------------------------------------------------------------------
-const Tile* Map::GetTileAtIndex(TileIndex index) const
+int Map::GetNumberOfResidentChunks() const
 {
-   return &(m_tiles[index]);
+   int numResidentChunks = 0;
+   for (const MapChunk& chunk : m_chunks)
+   {
+      if (chunk.isResident)
+      {
+         ++numResidentChunks;
+      }
+   }
+
+   return numResidentChunks;
 }
 
 
 //-----------------------------------------------------------------------------------------------
-Tile* Map::GetTileAtTileCoords(const TileCoords& coords)
+// Only type and visibility are cached, so chunks holding agents, features, or items stay resident
+bool Map::TryEvictChunk(int chunkIndex)
 {
-   TileIndex index = GetIndexForTileCoords(coords);
-   Tile* tile = GetTileAtIndex(index);
-   return tile;
+   bool didEvict = true;
+   MapChunk& chunk = m_chunks[chunkIndex];
+   if (!chunk.isResident || m_chunkCache == nullptr)
+   {
+      return !didEvict;
+   }
+
+   for (const Tile& tile : chunk.tiles)
+   {
+      if (tile.IsOccupiedByAgent() || tile.HasAFeature() || tile.HasItems())
+      {
+         return !didEvict;
+      }
+   }
+
+   UpdateChunkSummaries(chunkIndex);
+
+   // Records are always row-major so they survive a layout change
+   unsigned char* record = m_chunkCache->GetData() + (chunkIndex * CHUNK_RECORD_SIZE);
+   for (int localY = 0; localY < CHUNK_SIZE; ++localY)
+   {
+      for (int localX = 0; localX < CHUNK_SIZE; ++localX)
+      {
+         const Tile& tile = chunk.tiles[GetIndexInChunk(localX, localY, m_indexLayout)];
+         record[0] = (unsigned char)((tile.type + 1) | ((tile.typeToBecome + 1) << 4));
+         record[1] = (tile.isHidden ? CACHED_TILE_HIDDEN_FLAG : 0)
+            | (tile.isVisible ? CACHED_TILE_VISIBLE_FLAG : 0)
+            | (tile.isKnown ? CACHED_TILE_KNOWN_FLAG : 0);
+         record += 2;
+      }
+   }
+
+   std::vector<Tile>().swap(chunk.tiles);
+   chunk.isResident = false;
+   return didEvict;
 }
 
 
 //-----------------------------------------------------------------------------------------------
-const Tile* Map::GetTileAtTileCoords(const TileCoords& coords) const
+void Map::LoadChunkFromCache(int chunkIndex) const
 {
-   TileIndex index = GetIndexForTileCoords(coords);
-   const Tile* tile = GetTileAtIndex(index);
-   return tile;
+   ASSERT_OR_DIE(m_chunkCache != nullptr, "Defiance ERROR: Tried to load a map chunk without a chunk cache!");
+
+   MapChunk& chunk = m_chunks[chunkIndex];
+   chunk.tiles.resize(CHUNK_SIZE * CHUNK_SIZE);
+
+   const unsigned char* record = m_chunkCache->GetData() + (chunkIndex * CHUNK_RECORD_SIZE);
+   for (int localY = 0; localY < CHUNK_SIZE; ++localY)
+   {
+      for (int localX = 0; localX < CHUNK_SIZE; ++localX)
+      {
+         Tile& tile = chunk.tiles[GetIndexInChunk(localX, localY, m_indexLayout)];
+         tile.type = (TileType)((record[0] & 0x0F) - 1);
+         tile.typeToBecome = (TileType)((record[0] >> 4) - 1);
+         tile.isHidden = (record[1] & CACHED_TILE_HIDDEN_FLAG) != 0;
+         tile.isVisible = (record[1] & CACHED_TILE_VISIBLE_FLAG) != 0;
+         tile.isKnown = (record[1] & CACHED_TILE_KNOWN_FLAG) != 0;
+         record += 2;
+      }
+   }
+
+   chunk.isResident = true;
+   m_wasChunkLoadedSinceResidencyUpdate = true;
+   ++m_numChunksPagedInSinceResidencyUpdate;
 }
 
 
 //-----------------------------------------------------------------------------------------------
+// Row-major whatever the layout. The layout only orders tiles inside each chunk, so code walking
+// tiles by index visits them in the same order on every map
 TileIndex Map::GetIndexForTileCoords(const TileCoords& location) const
 {
    TileIndex index = (m_dimensions.x * location.y) + location.x;
@@ -341,6 +819,40 @@ TileCoords Map::GetTileCoordsForIndex(TileIndex index) const
 }
 
 
+//-----------------------------------------------------------------------------------------------
+void Map::SetTileIndexLayout(TileIndexLayout newLayout)
+{
+   if (newLayout == m_indexLayout)
+   {
+      return;
+   }
+
+   // Evicted chunks are cached row-major, so only resident chunks need reordering
+   std::vector<Tile> reorderedTiles(CHUNK_SIZE * CHUNK_SIZE);
+   for (MapChunk& chunk : m_chunks)
+   {
+      if (!chunk.isResident)
+      {
+         continue;
+      }
+
+      for (int localY = 0; localY < CHUNK_SIZE; ++localY)
+      {
+         for (int localX = 0; localX < CHUNK_SIZE; ++localX)
+         {
+            int oldIndex = GetIndexInChunk(localX, localY, m_indexLayout);
+            int newIndex = GetIndexInChunk(localX, localY, newLayout);
+            reorderedTiles[newIndex] = chunk.tiles[oldIndex];
+         }
+      }
+
+      chunk.tiles.swap(reorderedTiles);
+   }
+
+   m_indexLayout = newLayout;
+}
+
+
 // #TODO - since this doesn't worry about going off map... static?
 //-----------------------------------------------------------------------------------------------
 TileCoords Map::GetTileCoordsInDirection(const TileCoords& location, TileDirection dir, int distance) const
@@ -418,7 +930,7 @@ const Tile& Map::GetTileInDirection(const TileCoords& location, TileDirection di
       {
          TileCoords newLocation(location.x, location.y + distance);
          TileIndex tileIndex = GetIndexForTileCoords(newLocation);
-         return m_tiles[tileIndex];
+         return *GetTileAtIndex(tileIndex);
       }
    }
 
@@ -432,7 +944,7 @@ const Tile& Map::GetTileInDirection(const TileCoords& location, TileDirection di
       {
          TileCoords newLocation(location.x, location.y - distance);
          TileIndex tileIndex = GetIndexForTileCoords(newLocation);
-         return m_tiles[tileIndex];
+         return *GetTileAtIndex(tileIndex);
       }
    }
 
@@ -446,7 +958,7 @@ const Tile& Map::GetTileInDirection(const TileCoords& location, TileDirection di
       {
          TileCoords newLocation(location.x + distance, location.y);
          TileIndex tileIndex = GetIndexForTileCoords(newLocation);
-         return m_tiles[tileIndex];
+         return *GetTileAtIndex(tileIndex);
       }
    }
 
@@ -460,7 +972,7 @@ const Tile& Map::GetTileInDirection(const TileCoords& location, TileDirection di
       {
          TileCoords newLocation(location.x - distance, location.y);
          TileIndex tileIndex = GetIndexForTileCoords(newLocation);
-         return m_tiles[tileIndex];
+         return *GetTileAtIndex(tileIndex);
       }
    }
 
@@ -474,7 +986,7 @@ const Tile& Map::GetTileInDirection(const TileCoords& location, TileDirection di
       {
          TileCoords newLocation(location.x - distance, location.y + distance);
          TileIndex tileIndex = GetIndexForTileCoords(newLocation);
-         return m_tiles[tileIndex];
+         return *GetTileAtIndex(tileIndex);
       }
    }
 
@@ -488,7 +1000,7 @@ const Tile& Map::GetTileInDirection(const TileCoords& location, TileDirection di
       {
          TileCoords newLocation(location.x + distance, location.y + distance);
          TileIndex tileIndex = GetIndexForTileCoords(newLocation);
-         return m_tiles[tileIndex];
+         return *GetTileAtIndex(tileIndex);
       }
    }
 
@@ -502,7 +1014,7 @@ const Tile& Map::GetTileInDirection(const TileCoords& location, TileDirection di
       {
          TileCoords newLocation(location.x - distance, location.y - distance);
          TileIndex tileIndex = GetIndexForTileCoords(newLocation);
-         return m_tiles[tileIndex];
+         return *GetTileAtIndex(tileIndex);
       }
    }
 
@@ -516,7 +1028,7 @@ const Tile& Map::GetTileInDirection(const TileCoords& location, TileDirection di
       {
          TileCoords newLocation(location.x + distance, location.y - distance);
          TileIndex tileIndex = GetIndexForTileCoords(newLocation);
-         return m_tiles[tileIndex];
+         return *GetTileAtIndex(tileIndex);
       }
    }
    }
@@ -526,76 +1038,277 @@ const Tile& Map::GetTileInDirection(const TileCoords& location, TileDirection di
 }
 
 
-// #TODO - off map == stone
 //-----------------------------------------------------------------------------------------------
 int Map::GetNumberOfTilesOfTypeAroundLocationCircular(const TileCoords& location, TileType type, int radius) const
 {
-   int numberOfTilesOfTypeAroundLocation = 0;
-   TileCoords topLeftTile(location.x - radius, location.y - radius);
-   TileCoords botRightTile(location.x + radius, location.y + radius);
+   TileCoords mins(location.x - radius, location.y - radius);
+   TileCoords maxs(location.x + radius, location.y + radius);
+   int numberOfTilesOfTypeAroundLocation = GetNumberOfTilesOfTypeInArea(mins, maxs, type);
 
-   for (int yIndex = topLeftTile.y; yIndex <= botRightTile.y; ++yIndex)
+   // skip the center spot
+   if (!AreTileCoordsOffMap(location) && GetTileAtTileCoords(location)->type == type)
    {
-      for (int xIndex = topLeftTile.x; xIndex <= botRightTile.x; ++xIndex)
-      {
-         TileCoords tileCoordsToCheck(xIndex, yIndex);
+      --numberOfTilesOfTypeAroundLocation;
+   }
+
+   return numberOfTilesOfTypeAroundLocation;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int Map::GetNumberOfTilesOfTypeAroundLocationCross(const TileCoords& location, TileType type, int radius) const
+{
+   // JUST N, S, E, and W - off map tiles do not count here
+   TileCoords horizontalMins(location.x - radius, location.y);
+   TileCoords horizontalMaxs(location.x + radius, location.y);
+   TileCoords verticalMins(location.x, location.y - radius);
+   TileCoords verticalMaxs(location.x, location.y + radius);
+
+   int numberOfTilesOfTypeAroundLocation = GetNumberOfTilesOfTypeInClampedArea(horizontalMins, horizontalMaxs, type)
+      + GetNumberOfTilesOfTypeInClampedArea(verticalMins, verticalMaxs, type);
+
+   // center is in both strips
+   if (!AreTileCoordsOffMap(location) && GetTileAtTileCoords(location)->type == type)
+   {
+      numberOfTilesOfTypeAroundLocation -= 2;
+   }
+
+   return numberOfTilesOfTypeAroundLocation;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int Map::GetNumberOfTilesOfTypeAroundIndex(int index, TileType type, int radius) const
+{
+   TileCoords indexAsCoords = GetTileCoordsForIndex(index);
+   int tileCount = GetNumberOfTilesOfTypeAroundLocationCircular(indexAsCoords, type, radius);
+   return tileCount;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Inclusive of mins and maxs. Off map == stone
+int Map::GetNumberOfTilesOfTypeInArea(const TileCoords& mins, const TileCoords& maxs, TileType type) const
+{
+   int numberOfTilesOfType = GetNumberOfTilesOfTypeInClampedArea(mins, maxs, type);
+
+   if (type == STONE_TYPE)
+   {
+      int areaSize = (maxs.x - mins.x + 1) * (maxs.y - mins.y + 1);
+      int clampedWidth = Clampi(maxs.x, -1, m_dimensions.x - 1) - Clampi(mins.x, 0, m_dimensions.x) + 1;
+      int clampedHeight = Clampi(maxs.y, -1, m_dimensions.y - 1) - Clampi(mins.y, 0, m_dimensions.y) + 1;
+      int clampedAreaSize = (clampedWidth > 0 && clampedHeight > 0) ? clampedWidth * clampedHeight : 0;
+      numberOfTilesOfType += areaSize - clampedAreaSize;
+   }
+
+   return numberOfTilesOfType;
+}
+
 
-         if (AreTileCoordsOffMap(tileCoordsToCheck))
+//-----------------------------------------------------------------------------------------------
+// Before eviction, while the tiles are still here
+void Map::UpdateChunkSummaries(int chunkIndex) const
+{
+   if (m_chunks[chunkIndex].areTileTypeCountsDirty)
+   {
+      RebuildChunkTileTypeCounts(chunkIndex);
+   }
+
+   if (m_chunks[chunkIndex].isOpenTileListDirty)
+   {
+      RebuildChunkOpenTileList(chunkIndex);
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Tiles past the map's edge in edge chunks are not counted
+void Map::RebuildChunkTileTypeCounts(int chunkIndex) const
+{
+   MapChunk& chunk = m_chunks[chunkIndex];
+   if (!chunk.isGenerated)
+   {
+      GenerateChunk(chunkIndex);
+   }
+   else if (!chunk.isResident)
+   {
+      LoadChunkFromCache(chunkIndex);
+   }
+
+   const int tableWidth = CHUNK_SIZE + 1;
+   for (int typeIndex = 0; typeIndex < NUM_TILE_TYPES; ++typeIndex)
+   {
+      chunk.tileTypeCounts[typeIndex].assign(tableWidth * tableWidth, 0);
+   }
+
+   TileCoords chunkMins = GetChunkMins(chunkIndex);
+   for (int localY = 0; localY < CHUNK_SIZE; ++localY)
+   {
+      unsigned short rowCounts[NUM_TILE_TYPES] = { 0 };
+      for (int localX = 0; localX < CHUNK_SIZE; ++localX)
+      {
+         if (chunkMins.x + localX < m_dimensions.x && chunkMins.y + localY < m_dimensions.y)
          {
-            if (type == STONE_TYPE)
+            TileType tileType = chunk.tiles[GetIndexInChunk(localX, localY, m_indexLayout)].type;
+            if (tileType > INVALID_TYLE_TYPE && tileType < NUM_TILE_TYPES)
             {
-               ++numberOfTilesOfTypeAroundLocation;
+               ++rowCounts[tileType];
             }
-
-            continue;
          }
-         
-         // skip the center spot
-         if (tileCoordsToCheck == location)
+
+         int tableIndex = ((localY + 1) * tableWidth) + (localX + 1);
+         for (int typeIndex = 0; typeIndex < NUM_TILE_TYPES; ++typeIndex)
          {
-            continue;
+            std::vector<unsigned short>& counts = chunk.tileTypeCounts[typeIndex];
+            counts[tableIndex] = counts[tableIndex - tableWidth] + rowCounts[typeIndex];
          }
+      }
+   }
+
+   chunk.areTileTypeCountsDirty = false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Only counts tiles that are on the map. Only the chunks the area overlaps are looked at
+int Map::GetNumberOfTilesOfTypeInClampedArea(const TileCoords& mins, const TileCoords& maxs, TileType type) const
+{
+   if (type <= INVALID_TYLE_TYPE || type >= NUM_TILE_TYPES)
+   {
+      return 0;
+   }
+
+   int minX = Clampi(mins.x, 0, m_dimensions.x);
+   int minY = Clampi(mins.y, 0, m_dimensions.y);
+   int maxX = Clampi(maxs.x, -1, m_dimensions.x - 1);
+   int maxY = Clampi(maxs.y, -1, m_dimensions.y - 1);
+   if (minX > maxX || minY > maxY)
+   {
+      return 0;
+   }
 
-         const Tile* tileToCheck = GetTileAtTileCoords(tileCoordsToCheck);
-         if (tileToCheck->type == type)
+   const int tableWidth = CHUNK_SIZE + 1;
+   int numberOfTilesOfType = 0;
+   for (int chunkY = minY / CHUNK_SIZE; chunkY <= maxY / CHUNK_SIZE; ++chunkY)
+   {
+      for (int chunkX = minX / CHUNK_SIZE; chunkX <= maxX / CHUNK_SIZE; ++chunkX)
+      {
+         int chunkIndex = (chunkY * m_chunkDimensions.x) + chunkX;
+         if (!m_chunks[chunkIndex].isGenerated || m_chunks[chunkIndex].areTileTypeCountsDirty)
          {
-            ++numberOfTilesOfTypeAroundLocation;
+            RebuildChunkTileTypeCounts(chunkIndex);
          }
+
+         int localMinX = Clampi(minX - (chunkX * CHUNK_SIZE), 0, CHUNK_SIZE - 1);
+         int localMinY = Clampi(minY - (chunkY * CHUNK_SIZE), 0, CHUNK_SIZE - 1);
+         int localMaxX = Clampi(maxX - (chunkX * CHUNK_SIZE), 0, CHUNK_SIZE - 1);
+         int localMaxY = Clampi(maxY - (chunkY * CHUNK_SIZE), 0, CHUNK_SIZE - 1);
+
+         const std::vector<unsigned short>& counts = m_chunks[chunkIndex].tileTypeCounts[type];
+         int topRight = counts[((localMaxY + 1) * tableWidth) + (localMaxX + 1)];
+         int topLeft = counts[((localMaxY + 1) * tableWidth) + localMinX];
+         int botRight = counts[(localMinY * tableWidth) + (localMaxX + 1)];
+         int botLeft = counts[(localMinY * tableWidth) + localMinX];
+         numberOfTilesOfType += topRight - topLeft - botRight + botLeft;
       }
    }
 
-   return numberOfTilesOfTypeAroundLocation;
+   return numberOfTilesOfType;
 }
 
 
 //-----------------------------------------------------------------------------------------------
-int Map::GetNumberOfTilesOfTypeAroundLocationCross(const TileCoords& location, TileType type, int radius) const
+// Chunks that have not been generated yet have no open tiles
+void Map::RebuildChunkOpenTileList(int chunkIndex) const
 {
-   int numberOfTilesOfTypeAroundLocation = 0;
+   MapChunk& chunk = m_chunks[chunkIndex];
+   m_numOpenTiles -= (int)chunk.openTiles.size();
+   chunk.openTiles.clear();
+   chunk.isOpenTileListDirty = false;
+
+   if (!chunk.isGenerated)
+   {
+      chunk.openTileSlots.clear();
+      return;
+   }
 
-   // Loop through JUST N, S, E, and W
-   for (int radiusSize = 1; radiusSize <= radius; ++radiusSize)
+   if (!chunk.isResident)
    {
-      for (int directionIndex = 0; directionIndex < NUM_CARDINAL_DIRECTIONS; ++directionIndex)
+      LoadChunkFromCache(chunkIndex);
+   }
+
+   chunk.openTileSlots.assign(CHUNK_SIZE * CHUNK_SIZE, -1);
+
+   TileCoords chunkMins = GetChunkMins(chunkIndex);
+   for (int localY = 0; localY < CHUNK_SIZE && chunkMins.y + localY < m_dimensions.y; ++localY)
+   {
+      for (int localX = 0; localX < CHUNK_SIZE && chunkMins.x + localX < m_dimensions.x; ++localX)
       {
-         const Tile& neighbor = GetTileInDirection(location, (TileDirection)directionIndex, radius);
-         if (type == neighbor.type)
+         if (IsTileOpen(chunk.tiles[GetIndexInChunk(localX, localY, m_indexLayout)]))
          {
-            ++numberOfTilesOfTypeAroundLocation;
+            int localIndex = (localY * CHUNK_SIZE) + localX;
+            chunk.openTileSlots[localIndex] = (short)chunk.openTiles.size();
+            chunk.openTiles.push_back((unsigned short)localIndex);
          }
       }
    }
 
-   return numberOfTilesOfTypeAroundLocation;
+   m_numOpenTiles += (int)chunk.openTiles.size();
 }
 
 
 //-----------------------------------------------------------------------------------------------
-int Map::GetNumberOfTilesOfTypeAroundIndex(int index, TileType type, int radius) const
+// Only chunks whose tiles changed are dirty, and those are still resident
+void Map::UpdateDirtyOpenTileLists() const
 {
-   TileCoords indexAsCoords = GetTileCoordsForIndex(index);
-   int tileCount = GetNumberOfTilesOfTypeAroundLocationCircular(indexAsCoords, type, radius);
-   return tileCount;
+   for (int chunkIndex = 0; chunkIndex < (int)m_chunks.size(); ++chunkIndex)
+   {
+      if (m_chunks[chunkIndex].isOpenTileListDirty)
+      {
+         RebuildChunkOpenTileList(chunkIndex);
+      }
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Map::UpdateOpenTileListAtCoords(const TileCoords& coords)
+{
+   // Looking the tile up first makes sure its chunk is generated
+   bool isOpen = IsTileOpen(*GetTileAtTileCoords(coords));
+
+   // Will be picked up by the next rebuild
+   MapChunk& chunk = m_chunks[GetChunkIndexForTileCoords(coords)];
+   if (chunk.isOpenTileListDirty)
+   {
+      return;
+   }
+
+   int localIndex = ((coords.y % CHUNK_SIZE) * CHUNK_SIZE) + (coords.x % CHUNK_SIZE);
+   short& slot = chunk.openTileSlots[localIndex];
+   if (isOpen && slot == -1)
+   {
+      slot = (short)chunk.openTiles.size();
+      chunk.openTiles.push_back((unsigned short)localIndex);
+      ++m_numOpenTiles;
+   }
+   else if (!isOpen && slot != -1)
+   {
+      // Swap remove
+      unsigned short lastLocalIndex = chunk.openTiles.back();
+      chunk.openTiles[slot] = lastLocalIndex;
+      chunk.openTileSlots[lastLocalIndex] = slot;
+      chunk.openTiles.pop_back();
+      slot = -1;
+      --m_numOpenTiles;
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC bool Map::IsTileOpen(const Tile& tile)
+{
+   return (tile.type != STONE_TYPE && !tile.IsOccupiedByAgent() && !tile.HasAFeature());
 }
 
 
@@ -603,7 +1316,7 @@ int Map::GetNumberOfTilesOfTypeAroundIndex(int index, TileType type, int radius)
 bool Map::IsTileIndexOffMap(TileIndex index) const
 {
    bool isOffMap = true;
-   if (index >= m_tiles.size())
+   if (index >= (TileIndex)GetNumberOfTilesInMap())
    {
       return isOffMap;
    }
@@ -630,20 +1343,20 @@ bool Map::AreTileCoordsOffMap(const TileCoords& coords) const
 
 
 //-----------------------------------------------------------------------------------------------
-TileCoords Map::GetRandomEdgeCoords() const
+TileCoords Map::GetRandomEdgeCoords(RandomNumberGenerator* random) const
 {
-   bool isTopOrBot = GetRandomTrueOrFalse();
+   bool isTopOrBot = random->GetTrueOrFalse();
 
    if (isTopOrBot)
    {
-      int y = GetRandomTrueOrFalse() ? 0 : m_dimensions.y - 1;
-      int x = GetRandomIntBetweenInclusive(0, m_dimensions.x - 1);
+      int y = random->GetTrueOrFalse() ? 0 : m_dimensions.y - 1;
+      int x = random->GetIntBetweenInclusive(0, m_dimensions.x - 1);
       return TileCoords(x, y);
    }
    else // isLeftOrRightSide
    {
-      int x = GetRandomTrueOrFalse() ? 0 : m_dimensions.x - 1;
-      int y = GetRandomIntBetweenInclusive(0, m_dimensions.y - 1);
+      int x = random->GetTrueOrFalse() ? 0 : m_dimensions.x - 1;
+      int y = random->GetIntBetweenInclusive(0, m_dimensions.y - 1);
       return TileCoords(x, y);
    }
 }
@@ -679,9 +1392,7 @@ void Map::SetTilesInBlockToType(const TileCoords& location, TileType type, int r
       for (int xIndex = topLeftTile.x; xIndex <= botRightTile.x; ++xIndex)
       {
          TileCoords currentCoords(xIndex, yIndex);
-         TileIndex index = GetIndexForTileCoords(currentCoords);
-
-         m_tiles[index].typeToBecome = type;
+         GetTileAtTileCoords(currentCoords)->typeToBecome = type;
       }
    }
 }
@@ -690,23 +1401,52 @@ void Map::SetTilesInBlockToType(const TileCoords& location, TileType type, int r
 //-----------------------------------------------------------------------------------------------
 void Map::SetTileAtCoordsToType(const TileCoords& location, TileType type)
 {
-   TileIndex index = GetIndexForTileCoords(location);
-   m_tiles[index].typeToBecome = type;
+   GetTileAtTileCoords(location)->typeToBecome = type;
 }
 
 
 //-----------------------------------------------------------------------------------------------
-TileCoords Map::GetRandomOpenCoords() const
+// Slots run through the chunks in order, so only the chunk the slot lands in is looked at
+TileCoords Map::GetRandomOpenCoords(RandomNumberGenerator* random) const
 {
-   TileCoords coords(GetRandomIntBetweenInclusive(0, m_dimensions.x - 1), GetRandomIntBetweenInclusive(0, m_dimensions.y - 1));
-   const Tile* tileAtCoords = GetTileAtTileCoords(coords);
-   while (tileAtCoords->type == STONE_TYPE || tileAtCoords->IsOccupiedByAgent() || tileAtCoords->HasAFeature())
+   int numOpenTiles = GetNumberOfOpenTiles();
+   ASSERT_OR_DIE(numOpenTiles > 0, "Defiance ERROR: Tried to get random open coords on a map with no open tiles!");
+
+   int slot = random->GetIntBetweenInclusive(0, numOpenTiles - 1);
+   int chunkIndex = 0;
+   while (slot >= (int)m_chunks[chunkIndex].openTiles.size())
    {
-      coords = TileCoords(GetRandomIntBetweenInclusive(0, m_dimensions.x - 1), GetRandomIntBetweenInclusive(0, m_dimensions.y - 1));
-      tileAtCoords = GetTileAtTileCoords(coords);
+      slot -= m_chunks[chunkIndex].openTiles.size();
+      ++chunkIndex;
    }
 
-   return coords;
+   TileCoords chunkMins = GetChunkMins(chunkIndex);
+   int localIndex = m_chunks[chunkIndex].openTiles[slot];
+   return TileCoords(chunkMins.x + (localIndex % CHUNK_SIZE), chunkMins.y + (localIndex / CHUNK_SIZE));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int Map::GetNumberOfOpenTiles() const
+{
+   UpdateDirtyOpenTileLists();
+   return m_numOpenTiles;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Map::AddAgent(Agent* newAgent, const TileCoords& position)
+{
+   GetTileAtTileCoords(position)->occupyingAgent = newAgent;
+   UpdateOpenTileListAtCoords(position);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Map::RemoveAgent(const TileCoords& position)
+{
+   GetTileAtTileCoords(position)->RemoveAgent();
+   UpdateOpenTileListAtCoords(position);
 }
 
 
@@ -714,6 +1454,7 @@ TileCoords Map::GetRandomOpenCoords() const
 void Map::AddFeature(Feature* newFeature, const TileCoords& position)
 {
    GetTileAtTileCoords(position)->occupyingFeature = newFeature;
+   UpdateOpenTileListAtCoords(position);
 }
 
 
@@ -724,6 +1465,7 @@ bool Map::WriteToXMLNode(XMLNode& parentNode) const
 
    XMLNode mapNode = parentNode.addChild("MapData");
    mapNode.addAttribute("mapSize", m_dimensions.ToString().c_str());
+   mapNode.addAttribute("indexLayout", GetStringForTileIndexLayout(m_indexLayout).c_str());
    
    XMLNode tileNode = mapNode.addChild("TileData");
    std::string tilesAsString = GetTilesAsString();
@@ -967,4 +1709,29 @@ STATIC Vector2f Map::GetTileCenterFromTileCoords(const TileCoords& coords)
 {
    Vector2f center((float)coords.x + 0.5f, (float)coords.y + 0.5f);
    return center;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC TileIndexLayout Map::GetTileIndexLayoutForString(const std::string& layoutString)
+{
+   if (layoutString == "Tiled")
+   {
+      return TILED_LAYOUT;
+   }
+
+   return ROW_MAJOR_LAYOUT;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+STATIC std::string Map::GetStringForTileIndexLayout(TileIndexLayout layout)
+{
+   switch (layout)
+   {
+   case TILED_LAYOUT:
+      return "Tiled";
+   default:
+      return "RowMajor";
+   }
 }
\ No newline at end of file
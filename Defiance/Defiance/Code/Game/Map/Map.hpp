@@ -5,14 +5,44 @@
 #include "Engine/Math/Vector2i.hpp"
 #include "Game/Core/GameCommon.hpp"
 #include "Game/Map/Tile.hpp"
+#include "Game/Map/EntitySpatialGrid.hpp"
 #include "Game/Entities/Entity.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
 struct XMLNode;
 class Player;
+class MemoryMappedFile;
+class Generator;
 struct Path;
 struct RaycastResult;
+struct MapLegend;
+
+
+//-----------------------------------------------------------------------------------------------
+// CHUNK_SIZE x CHUNK_SIZE tiles. Non-resident chunks live in the map's chunk cache on disk,
+// or have not been generated yet if the map generates regions on demand
+// The tile type counts and open tile list are the chunk's header. They stay in memory when the tiles
+// are evicted, and are brought up to date before eviction, so neither ever pages a chunk back in
+struct MapChunk
+{
+   MapChunk() : isResident(true), isGenerated(true), areTileTypeCountsDirty(true), isOpenTileListDirty(true) {}
+
+   std::vector<Tile> tiles;
+
+   // Summed-area tables, one per tile type, sized (CHUNK_SIZE + 1) x (CHUNK_SIZE + 1)
+   // Entry (x, y) holds the number of tiles of that type in the chunk with local coords below x and below y
+   std::vector<unsigned short> tileTypeCounts[NUM_TILE_TYPES];
+
+   // Open tiles as row-major local indices. Slots are row-major too, -1 if not open
+   std::vector<unsigned short> openTiles;
+   std::vector<short> openTileSlots;
+
+   bool isResident;
+   bool isGenerated;
+   bool areTileTypeCountsDirty;
+   bool isOpenTileListDirty;
+};
 
 
 //-----------------------------------------------------------------------------------------------
@@ -20,9 +50,13 @@ class Map
 {
 public:
    Map();
-   Map(const std::vector<Tile>& tiles, const Vector2i& dimensions, const std::string& name);
+   Map(const Vector2i& dimensions, const std::string& name, TileIndexLayout indexLayout, const Tile& fillTile);
+   Map(const Vector2i& dimensions, const std::string& name, TileIndexLayout indexLayout, Generator* regionGenerator, unsigned int worldSeed);
+   ~Map();
 
    bool InitToXMLNode(const XMLNode& node, const std::string& name);
+   void InitToTileText(const char* tileText, size_t textLength, const Vector2i& dimensions, TileIndexLayout indexLayout, const MapLegend& legend);
+   void ApplyVisibilityText(const char* visibilityText, size_t textLength);
    void UpdateAllTilesToNewType();
 
    void Render() const;
@@ -40,12 +74,16 @@ public:
    int GetNumberOfTilesOfTypeAroundLocationCircular(const TileCoords& location, TileType type, int radius = 1) const;
    int GetNumberOfTilesOfTypeAroundLocationCross(const TileCoords& location, TileType type, int radius = 1) const;
    int GetNumberOfTilesOfTypeAroundIndex(int index, TileType type, int radius = 1) const;
+   int GetNumberOfTilesOfTypeInArea(const TileCoords& mins, const TileCoords& maxs, TileType type) const;
    bool IsTileIndexOffMap(TileIndex index) const;
    bool AreTileCoordsOffMap(const TileCoords& coords) const;
-   TileCoords GetRandomEdgeCoords() const;
+   TileCoords GetRandomEdgeCoords(RandomNumberGenerator* random) const;
    void SetTilesInBlockToType(const TileCoords& location, TileType type, int radius = 1);
    void SetTileAtCoordsToType(const TileCoords& location, TileType type);
-   TileCoords GetRandomOpenCoords() const;
+   TileCoords GetRandomOpenCoords(RandomNumberGenerator* random) const;
+   int GetNumberOfOpenTiles() const;
+   void AddAgent(Agent* newAgent, const TileCoords& position);
+   void RemoveAgent(const TileCoords& position);
    void AddFeature(Feature* newFeature, const TileCoords& position);
 
    bool WriteToXMLNode(XMLNode& parentNode) const;
@@ -56,17 +94,80 @@ public:
    static TileDirection GetTileDirection90DegreesClockwise(TileDirection originalDirection);
    static TileDirection GetDirectionFromSourceToDest(const TileCoords& source, const TileCoords& destination);
    static Vector2f GetTileCenterFromTileCoords(const TileCoords& coords);
+   static TileIndexLayout GetTileIndexLayoutForString(const std::string& layoutString);
+   static std::string GetStringForTileIndexLayout(TileIndexLayout layout);
+   static Vector2i MeasureMapText(const char* text, size_t textLength);
+   static const int TILE_BLOCK_SIZE;
+   static const int CHUNK_SIZE;
+   static const int CHUNK_RECORD_SIZE;
+   static const int CHUNK_RESIDENCY_RADIUS;
 
    void ToggleShowUnknownTiles() { m_showAllTiles = !m_showAllTiles; }
-   std::vector<Tile>* GetAllTiles() { return &m_tiles; }
-   const std::vector<Tile>& GetAllTiles() const { return m_tiles; }
+   void SetTileIndexLayout(TileIndexLayout newLayout);
+   TileIndexLayout GetTileIndexLayout() const { return m_indexLayout; }
+   EntitySpatialGrid* GetEntityGrid() { return &m_entityGrid; }
+   const EntitySpatialGrid& GetEntityGrid() const { return m_entityGrid; }
    const Vector2i& GetDimensions() const { return m_dimensions; }
    int GetNumberOfTilesInMap() const { return m_dimensions.x * m_dimensions.y; }
+   void MarkTileTypesChanged();
+
+   bool EnableChunkStreaming(const std::string& cacheDirectory);
+   bool IsChunkStreamingEnabled() const { return m_chunkCache != nullptr; }
+   void UpdateChunkResidency(const std::vector<TileCoords>& activePositions);
+   void MakeChunksResidentAround(const TileCoords& position);
+   bool IsTileResident(const TileCoords& coords) const;
+   int GetNumberOfChunks() const { return m_chunks.size(); }
+   int GetNumberOfResidentChunks() const;
+   int GetNumberOfGeneratedChunks() const;
+   bool IsGeneratingRegions() const { return m_regionGenerator != nullptr; }
+   unsigned int GetWorldSeed() const { return m_worldSeed; }
+   void GenerateRegionsInArea(const TileCoords& mins, const TileCoords& maxs);
 
 
 private:
+   Map(const Map&);
+   Map& operator=(const Map&);
+
+   void InitChunks(const Tile& fillTile);
+   void ParseMapText(const char* text, size_t textLength, const signed char* glyphValues, bool isVisibilityText);
+   int GetChunkIndexForTileCoords(const TileCoords& location) const;
+   Tile* GetTileInChunk(const TileCoords& location) const;
+   void LoadChunkFromCache(int chunkIndex) const;
+   void GenerateChunk(int chunkIndex) const;
+   TileCoords GetChunkMins(int chunkIndex) const;
+   bool TryEvictChunk(int chunkIndex);
+   static int GetIndexInChunk(int localX, int localY, TileIndexLayout layout);
+   static int GetMortonIndexInBlock(int localX, int localY);
+   void MarkChunkTileTypesChanged(int chunkIndex) const;
+   void UpdateChunkSummaries(int chunkIndex) const;
+   void RebuildChunkTileTypeCounts(int chunkIndex) const;
+   int GetNumberOfTilesOfTypeInClampedArea(const TileCoords& mins, const TileCoords& maxs, TileType type) const;
+   void RebuildChunkOpenTileList(int chunkIndex) const;
+   void UpdateDirtyOpenTileLists() const;
+   void UpdateOpenTileListAtCoords(const TileCoords& coords);
+   static bool IsTileOpen(const Tile& tile);
+
    bool m_showAllTiles;
-   std::vector<Tile> m_tiles;
    Vector2i m_dimensions;
    std::string m_name;
+   TileIndexLayout m_indexLayout;
+   EntitySpatialGrid m_entityGrid;
+
+   // Chunk table, row-major by chunk. Tiles inside a chunk follow m_indexLayout
+   mutable std::vector<MapChunk> m_chunks;
+   Vector2i m_chunkDimensions;
+   MemoryMappedFile* m_chunkCache;
+   std::string m_chunkCacheFilePath;
+   std::vector<int> m_chunksKeptResident;
+   mutable bool m_wasChunkLoadedSinceResidencyUpdate;
+   mutable int m_numChunksPagedInSinceResidencyUpdate;
+
+   // Owned. Only set for maps that generate regions the first time they are touched
+   Generator* m_regionGenerator;
+   unsigned int m_worldSeed;
+
+   // Sum of every chunk's open tile list, counting only lists that are up to date
+   mutable int m_numOpenTiles;
+
+   static int s_numChunkCachesCreated;
 };
\ No newline at end of file
@@ -0,0 +1,38 @@
+#include <string.h>
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Debug/ErrorWarningAssert.hpp"
+#include "Engine/Parsers/XMLUtilities.hpp"
+#include "Game/Map/MapLegend.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+MapLegend::MapLegend()
+{
+   memset(glyphTypes, AIR_TYPE, sizeof(glyphTypes));
+   SetTileTypeForGlyph('#', STONE_TYPE);
+   SetTileTypeForGlyph('.', AIR_TYPE);
+   SetTileTypeForGlyph('~', WATER_TYPE);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// <Tile char="#" type="stone"/> children. Later entries win
+void MapLegend::AddGlyphsFromXMLNode(const XMLNode& legendNode)
+{
+   int glyphIndex = 0;
+   XMLNode glyphNode = legendNode.getChildNode("Tile", &glyphIndex);
+   while (!glyphNode.isEmpty())
+   {
+      // The char overload takes the first character; the unsigned char one parses a number
+      unsigned char glyph = (unsigned char)ReadXMLAttribute(glyphNode, "char", ' ');
+      std::string typeString = ReadXMLAttribute(glyphNode, "type", std::string("invalid"));
+      TileType type = Tile::GetTypeForString(ToLowerCase(typeString));
+
+      ASSERT_OR_DIE(glyph > ' ', "ERROR: Map legend entry needs a visible char!");
+      ASSERT_OR_DIE(type != INVALID_TYLE_TYPE, Stringf("ERROR: Map legend has unknown tile type %s!", typeString.c_str()));
+      SetTileTypeForGlyph(glyph, type);
+
+      glyphNode = legendNode.getChildNode("Tile", &glyphIndex);
+   }
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Game/Map/Tile.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+struct XMLNode;
+
+
+//-----------------------------------------------------------------------------------------------
+// Glyph to tile type lookup for map text. Starts out with the glyphs the game saves maps with,
+// and anything not in the legend reads as air
+struct MapLegend
+{
+   MapLegend();
+
+   void AddGlyphsFromXMLNode(const XMLNode& legendNode);
+   void SetTileTypeForGlyph(unsigned char glyph, TileType type) { glyphTypes[glyph] = (signed char)type; }
+   TileType GetTileTypeForGlyph(unsigned char glyph) const { return (TileType)glyphTypes[glyph]; }
+
+   signed char glyphTypes[256];
+};
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "Engine/Renderer/TheRenderer.hpp"
+#include "Engine/Renderer/BitmapFont.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Game/Core/GameCommon.hpp"
+#include "Game/Map/Map.hpp"
+#include "Game/Map/Tile.hpp"
+#include "Game/Entities/Agents/Agent.hpp"
+#include "Game/Entities/Features/Feature.hpp"
+#include "Game/Pathfinding/Pathfinder.hpp"
+#include "Game/FieldOfView/FieldOfView.hpp"
+
+
+// #TODO - remember last seen feature state
+//-----------------------------------------------------------------------------------------------
+void Map::Render() const
+{
+   const Vector2f screenCenter(800.f, 450.f);
+   const Vector2f mapSize(m_dimensions.x * 20.f, m_dimensions.y * 20.f);
+   const Vector2f startLocation(screenCenter - (mapSize / 2.f));
+
+   const BitmapFont* font = BitmapFont::CreateOrGetFont("CopperplateGothicBold");
+
+
+   // Chunks that are paged out are far from every agent, so nothing there needs drawing
+   for (int chunkIndex = 0; chunkIndex < (int)m_chunks.size(); ++chunkIndex)
+   {
+      const MapChunk& chunk = m_chunks[chunkIndex];
+      if (!chunk.isResident)
+      {
+         continue;
+      }
+
+      TileCoords chunkMins = GetChunkMins(chunkIndex);
+      for (int localY = 0; localY < CHUNK_SIZE && chunkMins.y + localY < m_dimensions.y; ++localY)
+      {
+         for (int localX = 0; localX < CHUNK_SIZE && chunkMins.x + localX < m_dimensions.x; ++localX)
+         {
+            const Tile& tile = chunk.tiles[GetIndexInChunk(localX, localY, m_indexLayout)];
+            TileCoords tCoords(chunkMins.x + localX, chunkMins.y + localY);
+
+            if (tile.isHidden
+               || (!m_showAllTiles && !tile.isKnown))
+            {
+               continue;
+            }
+
+            float xLocation = startLocation.x + (tCoords.x * 20.f);
+            float yLocation = startLocation.y + (tCoords.y * 20.f);
+
+            Vector2f tileLocation(xLocation, yLocation);
+
+            if (tile.IsOccupiedByAgent() 
+               && (tile.isVisible || m_showAllTiles))
+            {
+               Agent* agent = tile.occupyingAgent;
+               std::string glyphAsString;
+               glyphAsString.push_back(agent->GetGlyph());
+               g_theRenderer->DrawText2D(tileLocation, glyphAsString, agent->GetColor(), 30.f, font);
+               continue;
+            }
+
+            if (tile.HasItems()
+               && (tile.isVisible || m_showAllTiles))
+            {
+               std::string glyphAsString;
+               glyphAsString.push_back(tile.GetItemGlyph());
+               g_theRenderer->DrawText2D(tileLocation, glyphAsString, Rgba::YELLOW, 30.f, font);
+               continue;
+            }
+
+            if (tile.HasAFeature()
+               && (tile.isVisible || m_showAllTiles))
+            {
+               std::string glyphAsString;
+               glyphAsString.push_back(tile.occupyingFeature->GetGlyphForCurrentState());
+               g_theRenderer->DrawText2D(tileLocation, glyphAsString, Rgba::YELLOW, 30.f, font);
+               continue;
+            }
+
+            unsigned char tileAlpha = tile.isVisible ? 255 : 50;
+
+            if (tile.type == STONE_TYPE)
+            {
+               g_theRenderer->DrawText2D(tileLocation, "#", Rgba(255, 255, 255, tileAlpha), 30.f, font);
+            }
+            else if (tile.type == AIR_TYPE)
+            {
+               g_theRenderer->DrawText2D(tileLocation + Vector2f(5.f, 8.f), ".", Rgba(255, 255, 255, tileAlpha), 30.f, font);
+            }
+            else if (tile.type == WATER_TYPE)
+            {
+               g_theRenderer->DrawText2D(tileLocation, "~", Rgba(0, 0, 255, tileAlpha), 30.f, font);
+            }
+         }
+      }
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Map::RenderPath(const Path& path) const
+{
+   const Vector2f screenCenter(800.f, 450.f);
+   const Vector2f mapSize(m_dimensions.x * 20.f, m_dimensions.y * 20.f);
+   const Vector2f startLocation(screenCenter - (mapSize / 2.f));
+
+   // Render open list
+   for (const PathNode* const node : path.openList)
+   {
+      const TileCoords& tCoords = node->position;
+      float xLocation = startLocation.x + (tCoords.x * 20.f);
+      float yLocation = startLocation.y + (tCoords.y * 20.f);
+
+      Vector2f tileLocation(xLocation, yLocation - 20.f);
+
+      g_theRenderer->DrawAABB2(AABB2(tileLocation, Vector2f(tileLocation.x + 20.f, tileLocation.y + 20.f)), Rgba(0, 0, 100, 120));
+   }
+
+   // Render closed list
+   for (const PathNode* const node : path.closedList)
+   {
+      const TileCoords& tCoords = node->position;
+      float xLocation = startLocation.x + (tCoords.x * 20.f);
+      float yLocation = startLocation.y + (tCoords.y * 20.f);
+
+      Vector2f tileLocation(xLocation, yLocation - 20.f);
+
+      g_theRenderer->DrawAABB2(AABB2(tileLocation, Vector2f(tileLocation.x + 20.f, tileLocation.y + 20.f)), Rgba(100, 0, 0, 120));
+   }
+
+   // Render goal
+   TileCoords tCoords = path.pathEnd;
+   float xLocation = startLocation.x + (tCoords.x * 20.f);
+   float yLocation = startLocation.y + (tCoords.y * 20.f);
+
+   Vector2f tileLocation(xLocation, yLocation - 20.f);
+
+   g_theRenderer->DrawAABB2(AABB2(tileLocation, Vector2f(tileLocation.x + 20.f, tileLocation.y + 20.f)), Rgba(0, 100, 0, 120));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Map::RenderRaycastResult(const Vector2f& start, const Vector2f& end, const RaycastResult& result) const
+{
+   const Vector2f screenCenter(800.f, 450.f);
+   const Vector2f mapSize(m_dimensions.x * 20.f, m_dimensions.y * 20.f);
+   const Vector2f startLocation(screenCenter - (mapSize / 2.f));
+
+   float xLocation = startLocation.x + (start.x * 20.f);
+   float yLocation = startLocation.y + (start.y * 20.f);
+   Vector2f lineStart(xLocation, yLocation);
+
+   xLocation = startLocation.x + (result.impactPos.x * 20.f);
+   yLocation = startLocation.y + (result.impactPos.y * 20.f);
+   Vector2f lineEnd(xLocation, yLocation);
+
+   Rgba lineColor = result.didImpact ? Rgba::RED : Rgba::GREEN;
+
+   g_theRenderer->DrawLine(lineStart, lineEnd, lineColor, 3.f);
+
+   xLocation = startLocation.x + (end.x * 20.f);
+   yLocation = startLocation.y + (end.y * 20.f);
+   Vector2f endLoc(xLocation, yLocation);
+   g_theRenderer->DrawPoint(endLoc, Rgba::GREEN, 3.f);
+}
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include <string.h>
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Debug/ErrorWarningAssert.hpp"
 #include "Game/Entities/Features/Feature.hpp"
@@ -32,6 +33,28 @@ Tile::Tile(TileType initType)
 {}
 
 
+//-----------------------------------------------------------------------------------------------
+STATIC TileType Tile::GetTypeForString(const std::string& typeString)
+{
+   if (!strcmp(typeString.c_str(), "air"))
+   {
+      return AIR_TYPE;
+   }
+
+   if (!strcmp(typeString.c_str(), "stone"))
+   {
+      return STONE_TYPE;
+   }
+
+   if (!strcmp(typeString.c_str(), "water"))
+   {
+      return WATER_TYPE;
+   }
+
+   return INVALID_TYLE_TYPE;
+}
+
+
 //-----------------------------------------------------------------------------------------------
 char Tile::GetItemGlyph() const
 {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include "Game/Entities/Items/Inventory.hpp"
 
 //-----------------------------------------------------------------------------------------------
@@ -35,8 +36,8 @@ struct Tile
    bool ToggleFeature();
    bool DoesBlockLineOfSight() const;
    bool DoesBlockPathing() const;
-   void PrintItemInfo() const { inventory.PrintItemInfo(); }
 
+   static TileType GetTypeForString(const std::string& typeString);
    static Tile INVALID_TILE;
 
    TileType type;
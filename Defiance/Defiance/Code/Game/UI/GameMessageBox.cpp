@@ -1,7 +1,4 @@
 #include "Engine/Core/EngineCommon.hpp"
-#include "Engine/Input/InputSystem.hpp"
-#include "Engine/Renderer/TheRenderer.hpp"
-#include "Engine/Renderer/BitmapFont.hpp"
 #include "Game/UI/GameMessageBox.hpp"
 
 
@@ -22,39 +19,12 @@ STATIC const std::string GameMessageBox::WELCOME_MESSAGE3 = "Good Luck.";
 GameMessageBox::GameMessageBox()
    : m_fontHeight(20.f)
    , m_color(Rgba(0, 0, 0, 255))
-   , m_font(BitmapFont::CreateOrGetFont("CopperplateGothicBold"))
+   , m_font(nullptr)
    , m_historyDisplayIndex(0)
 {
 }
 
 
-//-----------------------------------------------------------------------------------------------
-void GameMessageBox::Init()
-{
-   PrintNeutralMessage(WELCOME_MESSAGE0);
-   PrintNeutralMessage(WELCOME_MESSAGE1);
-   PrintNeutralMessage(WELCOME_MESSAGE2);
-   PrintNeutralMessage(WELCOME_MESSAGE3);
-}
-
-
-//-----------------------------------------------------------------------------------------------
-void GameMessageBox::HandleInput()
-{
-   // PgUP
-   if (g_theInputSystem->WasKeyJustPressed(VK_NEXT))
-   {
-      ShiftHistoryIndexBack();
-   }
-
-   // PgDwn
-   if (g_theInputSystem->WasKeyJustPressed(VK_PRIOR))
-   {
-      ShiftHistoryIndexForward();
-   }
-}
-
-
 //-----------------------------------------------------------------------------------------------
 void GameMessageBox::PrintGoodMessage(const std::string& message)
 {
@@ -118,63 +88,6 @@ void GameMessageBox::ResetHistoryIndex()
 }
 
 
-//-----------------------------------------------------------------------------------------------
-void GameMessageBox::Render() const
-{
-   RenderOverlay();
-   RenderMessages();
-}
-
-
-//-----------------------------------------------------------------------------------------------
-void GameMessageBox::RenderOverlay() const
-{
-   float spacePerLine = m_fontHeight + HISTORY_SPACING;
-   float boxHeight = MAX_HISTORY_SIZE * spacePerLine;
-   if (boxHeight == 0)
-   {
-      boxHeight = spacePerLine;
-   }
-
-   Vector2f botLeft(400.f, 770.f);
-   Vector2f topRight(1550.f, 770.f + boxHeight);
-   Rgba colorToDraw = m_color;
-   if (colorToDraw.a > (.3f * 255))
-   {
-      colorToDraw.a = (char)(.3f * 255);
-   }
-
-   g_theRenderer->DrawAABB2(AABB2(botLeft, topRight), colorToDraw);
-}
-
-
-//-----------------------------------------------------------------------------------------------
-void GameMessageBox::RenderMessages() const
-{
-   Vector2f startPosition(403.f, 770.f + HISTORY_SPACING + m_fontHeight);
-   int drawIndex = 0;
-   for (const GameMessageString& string : m_outputHistory)
-   {
-      if (drawIndex > m_historyDisplayIndex + MAX_HISTORY_SIZE - 1)
-      {
-         break;
-      }
-
-      if (drawIndex < m_historyDisplayIndex)
-      {
-         ++drawIndex;
-         continue;
-      }
-
-      Rgba colorToRender = GetColorForMessageType(string.type);
-      g_theRenderer->DrawText2D(startPosition, string.content, colorToRender, m_fontHeight, m_font);
-
-      startPosition.y += (m_fontHeight + HISTORY_SPACING);
-      ++drawIndex;
-   }
-}
-
-
 //-----------------------------------------------------------------------------------------------
 STATIC Rgba GameMessageBox::GetColorForMessageType(MessageType type)
 {
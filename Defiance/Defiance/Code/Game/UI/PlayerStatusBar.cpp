@@ -17,7 +17,6 @@ PlayerStatusBar::PlayerStatusBar(Player* player)
    : m_color(Rgba(0, 0, 0, 255))
    , m_font(BitmapFont::CreateOrGetFont("CopperplateGothicBold"))
    , m_player(player)
-   , m_isGameOver(false)
 {}
 
 
@@ -26,7 +25,7 @@ void PlayerStatusBar::Render() const
 {
    RenderOverlay();
 
-   if (!m_isGameOver)
+   if (!g_theGame->IsGameOver())
    {
       RenderStats();
    }
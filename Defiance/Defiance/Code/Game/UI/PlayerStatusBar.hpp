@@ -22,11 +22,8 @@ public:
    void RenderStats() const;
    void RenderGameOver() const;
 
-   void SetGameOver() { m_isGameOver = true; }
-
 private:
    Rgba m_color;
    BitmapFont* m_font;
    Player* m_player;
-   bool m_isGameOver;
 };
\ No newline at end of file
@@ -41,7 +41,7 @@ EndianMode GetLocalEndianMode()
    } data;
 
    data.unsignedIntData = 0x04030201;
-   return (data.byteData[0] == 0x01) ? LITTLE_ENDIAN : BIG_ENDIAN;
+   return (data.byteData[0] == 0x01) ? LITTLE_ENDIAN_MODE : BIG_ENDIAN_MODE;
 }
 
 
@@ -16,8 +16,8 @@ typedef unsigned char byte_t;
 //-----------------------------------------------------------------------------------------------
 enum EndianMode
 {
-   LITTLE_ENDIAN,
-   BIG_ENDIAN,
+   LITTLE_ENDIAN_MODE,
+   BIG_ENDIAN_MODE,
    NUM_ENDIAN_MODES,
 };
 EndianMode GetLocalEndianMode();
@@ -1,57 +1,82 @@
+#include <cstddef>
+#include <stdlib.h>
 #include "Engine/Core/Memory.hpp"
 #include "Engine/Profile/MemoryAnalytics.hpp"
 #include "Engine/Debug/ErrorWarningAssert.hpp"
 
 
+//-----------------------------------------------------------------------------------------------
+// Each block's size sits in front of it, padded so the block keeps malloc's alignment
+static const size_t ALLOCATION_HEADER_SIZE = alignof(std::max_align_t);
+
+
+//-----------------------------------------------------------------------------------------------
+// Another thread may raise the peak between the load and the exchange, so retry until ours is
+// stored or no longer the highest
+static void RaisePeakAllocated(size_t totalAllocated)
+{
+   size_t peakAllocated = g_peakAllocated.load();
+   while (totalAllocated > peakAllocated && !g_peakAllocated.compare_exchange_weak(peakAllocated, totalAllocated))
+   {
+   }
+}
+
+
 //-----------------------------------------------------------------------------------------------
 void* operator new(size_t numBytes)
 {
-   size_t* ptr = (size_t*)malloc(sizeof(size_t) + numBytes);
-   /*DebuggerPrintf("Alloc %p of %u bytes.\n", ptr, numBytes);*/
+   unsigned char* block = (unsigned char*)malloc(ALLOCATION_HEADER_SIZE + numBytes);
+   /*DebuggerPrintf("Alloc %p of %u bytes.\n", block, numBytes);*/
    ++g_numAllocations;
-   g_totalAllocated += numBytes;
+   RaisePeakAllocated(g_totalAllocated += numBytes);
 
-   *ptr = numBytes;
-   ++ptr;
-   return ptr;
+   *(size_t*)block = numBytes;
+   return block + ALLOCATION_HEADER_SIZE;
 }
 
 
 //-----------------------------------------------------------------------------------------------
 void* operator new[](size_t numBytes)
 {
-   size_t* ptr = (size_t*)malloc(sizeof(size_t) + numBytes);
-   /*DebuggerPrintf("Alloc %p of %u bytes.\n", ptr, numBytes);*/
+   unsigned char* block = (unsigned char*)malloc(ALLOCATION_HEADER_SIZE + numBytes);
+   /*DebuggerPrintf("Alloc %p of %u bytes.\n", block, numBytes);*/
    ++g_numAllocations;
-   g_totalAllocated += numBytes;
+   RaisePeakAllocated(g_totalAllocated += numBytes);
 
-   *ptr = numBytes;
-   ++ptr;
-   return ptr;
+   *(size_t*)block = numBytes;
+   return block + ALLOCATION_HEADER_SIZE;
 }
 
 
 //-----------------------------------------------------------------------------------------------
-void operator delete(void* ptr)
+void operator delete(void* ptr) noexcept
 {
-   size_t* ptrSize = (size_t*)ptr;
-   --ptrSize;
-   size_t numBytes = *ptrSize;
+   if (ptr == nullptr)
+   {
+      return;
+   }
+
+   unsigned char* block = (unsigned char*)ptr - ALLOCATION_HEADER_SIZE;
+   size_t numBytes = *(size_t*)block;
    g_totalAllocated -= numBytes;
    --g_numAllocations;
 
-   free(ptrSize);
+   free(block);
 }
 
 
 //-----------------------------------------------------------------------------------------------
-void operator delete[](void* ptr)
+void operator delete[](void* ptr) noexcept
 {
-   size_t* ptrSize = (size_t*)ptr;
-   --ptrSize;
-   size_t numBytes = *ptrSize;
+   if (ptr == nullptr)
+   {
+      return;
+   }
+
+   unsigned char* block = (unsigned char*)ptr - ALLOCATION_HEADER_SIZE;
+   size_t numBytes = *(size_t*)block;
    g_totalAllocated -= numBytes;
    --g_numAllocations;
 
-   free(ptrSize);
+   free(block);
 }
\ No newline at end of file
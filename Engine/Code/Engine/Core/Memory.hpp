@@ -1,10 +1,12 @@
 #pragma once
 
+#include <stddef.h>
+
 //-----------------------------------------------------------------------------------------------
 void* operator new(size_t numBytes);
 void* operator new[](size_t numBytes);
-void operator delete(void* ptr);
-void operator delete[](void* ptr);
+void operator delete(void* ptr) noexcept;
+void operator delete[](void* ptr) noexcept;
 
 
 //-----------------------------------------------------------------------------------------------
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include <mutex>
+#include "Engine/Debug/ErrorWarningAssert.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+// Fixed-size storage for one class, carved out of contiguous slabs and recycled through a free
+// list. Meant to back a class's own operator new/delete, so construction and destruction stay
+// with the caller. Only a pool created as shared between threads locks, so pools that never leave
+// the main thread don't pay for a mutex on every allocation and free
+template <typename PooledType>
+class ObjectPool
+{
+public:
+   explicit ObjectPool(int objectsPerSlab, bool isSharedBetweenThreads = false);
+   ~ObjectPool();
+
+   void* Allocate();
+   void Free(void* object);
+   void Reset();
+
+   int GetNumberOfLiveObjects() const;
+   int GetNumberOfSlabs() const;
+
+private:
+   ObjectPool(const ObjectPool&);
+   ObjectPool& operator=(const ObjectPool&);
+
+   // Sits in front of every object so Free can find its slab without searching
+   struct CellHeader
+   {
+      int slabIndex;
+      bool isLive;
+   };
+
+   // cells is memory rounded up to the pool's alignment
+   struct Slab
+   {
+      unsigned char* memory;
+      unsigned char* cells;
+      int numLiveCells;
+   };
+
+   unsigned char* GetCell(int slabIndex, int cellIndex) const;
+   void AddSlab();
+   void PushFreeCell(unsigned char* cell);
+
+   mutable std::mutex m_poolMutex;
+   bool m_isSharedBetweenThreads;
+   std::vector<Slab> m_slabs;
+   void* m_firstFreeObject;
+   size_t m_alignment;
+   size_t m_headerBytes;
+   size_t m_cellBytes;
+   int m_objectsPerSlab;
+   int m_numLiveObjects;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+template <typename PooledType>
+ObjectPool<PooledType>::ObjectPool(int objectsPerSlab, bool isSharedBetweenThreads)
+   : m_isSharedBetweenThreads(isSharedBetweenThreads)
+   , m_firstFreeObject(nullptr)
+   , m_alignment(0)
+   , m_headerBytes(0)
+   , m_cellBytes(0)
+   , m_objectsPerSlab(objectsPerSlab)
+   , m_numLiveObjects(0)
+{
+   // Free cells hold the next free pointer, so objects need at least a pointer's alignment. Header and
+   // cell sizes are rounded up to it, so every object in an aligned slab lands on the boundary
+   m_alignment = std::max(alignof(PooledType), alignof(void*));
+   m_headerBytes = (sizeof(CellHeader) + m_alignment - 1) & ~(m_alignment - 1);
+
+   size_t objectBytes = std::max(sizeof(PooledType), sizeof(void*));
+   m_cellBytes = m_headerBytes + ((objectBytes + m_alignment - 1) & ~(m_alignment - 1));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template <typename PooledType>
+ObjectPool<PooledType>::~ObjectPool()
+{
+   for (Slab& slab : m_slabs)
+   {
+      delete[] slab.memory;
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template <typename PooledType>
+void* ObjectPool<PooledType>::Allocate()
+{
+   std::unique_lock<std::mutex> lock(m_poolMutex, std::defer_lock);
+   if (m_isSharedBetweenThreads)
+   {
+      lock.lock();
+   }
+
+   if (m_firstFreeObject == nullptr)
+   {
+      AddSlab();
+   }
+
+   void* object = m_firstFreeObject;
+   m_firstFreeObject = *(void**)object;
+
+   CellHeader* header = (CellHeader*)((unsigned char*)object - m_headerBytes);
+   header->isLive = true;
+   ++m_slabs[header->slabIndex].numLiveCells;
+   ++m_numLiveObjects;
+   return object;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template <typename PooledType>
+void ObjectPool<PooledType>::Free(void* object)
+{
+   if (object == nullptr)
+   {
+      return;
+   }
+
+   std::unique_lock<std::mutex> lock(m_poolMutex, std::defer_lock);
+   if (m_isSharedBetweenThreads)
+   {
+      lock.lock();
+   }
+
+   CellHeader* header = (CellHeader*)((unsigned char*)object - m_headerBytes);
+   ASSERT_OR_DIE(header->isLive, "ERROR: Object freed twice, or never came from this pool!");
+
+   header->isLive = false;
+   --m_slabs[header->slabIndex].numLiveCells;
+   --m_numLiveObjects;
+
+   *(void**)object = m_firstFreeObject;
+   m_firstFreeObject = object;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Releases every slab with nothing live in it and rebuilds the free list in address order, so the
+// next batch of objects packs into the front of the pool again. Live objects are left alone
+template <typename PooledType>
+void ObjectPool<PooledType>::Reset()
+{
+   std::unique_lock<std::mutex> lock(m_poolMutex, std::defer_lock);
+   if (m_isSharedBetweenThreads)
+   {
+      lock.lock();
+   }
+
+   m_firstFreeObject = nullptr;
+   for (int slabIndex = (int)m_slabs.size() - 1; slabIndex >= 0; --slabIndex)
+   {
+      Slab& slab = m_slabs[slabIndex];
+      if (slab.cells == nullptr)
+      {
+         continue;
+      }
+
+      if (slab.numLiveCells == 0)
+      {
+         delete[] slab.memory;
+         slab.memory = nullptr;
+         slab.cells = nullptr;
+         continue;
+      }
+
+      for (int cellIndex = m_objectsPerSlab - 1; cellIndex >= 0; --cellIndex)
+      {
+         unsigned char* cell = GetCell(slabIndex, cellIndex);
+         if (!((CellHeader*)cell)->isLive)
+         {
+            PushFreeCell(cell);
+         }
+      }
+   }
+
+   while (!m_slabs.empty() && m_slabs.back().cells == nullptr)
+   {
+      m_slabs.pop_back();
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template <typename PooledType>
+int ObjectPool<PooledType>::GetNumberOfLiveObjects() const
+{
+   std::unique_lock<std::mutex> lock(m_poolMutex, std::defer_lock);
+   if (m_isSharedBetweenThreads)
+   {
+      lock.lock();
+   }
+   return m_numLiveObjects;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template <typename PooledType>
+int ObjectPool<PooledType>::GetNumberOfSlabs() const
+{
+   std::unique_lock<std::mutex> lock(m_poolMutex, std::defer_lock);
+   if (m_isSharedBetweenThreads)
+   {
+      lock.lock();
+   }
+
+   int numSlabs = 0;
+   for (const Slab& slab : m_slabs)
+   {
+      if (slab.cells != nullptr)
+      {
+         ++numSlabs;
+      }
+   }
+
+   return numSlabs;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template <typename PooledType>
+unsigned char* ObjectPool<PooledType>::GetCell(int slabIndex, int cellIndex) const
+{
+   return m_slabs[slabIndex].cells + (cellIndex * m_cellBytes);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Expects m_poolMutex to be held if the pool is shared. Reuses a slot released by Reset before growing the list
+template <typename PooledType>
+void ObjectPool<PooledType>::AddSlab()
+{
+   int slabIndex = 0;
+   while (slabIndex < (int)m_slabs.size() && m_slabs[slabIndex].cells != nullptr)
+   {
+      ++slabIndex;
+   }
+
+   if (slabIndex == (int)m_slabs.size())
+   {
+      m_slabs.push_back(Slab());
+   }
+
+   Slab& slab = m_slabs[slabIndex];
+   // The global allocator only promises its own alignment, so over-allocate and round up
+   slab.memory = new unsigned char[(m_cellBytes * m_objectsPerSlab) + m_alignment - 1];
+   slab.cells = (unsigned char*)(((size_t)slab.memory + m_alignment - 1) & ~(m_alignment - 1));
+   slab.numLiveCells = 0;
+
+   // Pushed back to front, so the slab hands out its lowest address first
+   for (int cellIndex = m_objectsPerSlab - 1; cellIndex >= 0; --cellIndex)
+   {
+      unsigned char* cell = GetCell(slabIndex, cellIndex);
+      CellHeader* header = (CellHeader*)cell;
+      header->slabIndex = slabIndex;
+      header->isLive = false;
+      PushFreeCell(cell);
+   }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Expects m_poolMutex to be held if the pool is shared
+template <typename PooledType>
+void ObjectPool<PooledType>::PushFreeCell(unsigned char* cell)
+{
+   void* object = cell + m_headerBytes;
+   *(void**)object = m_firstFreeObject;
+   m_firstFreeObject = object;
+}
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
 #include <ctype.h>
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/Tokenizer.hpp"
@@ -19,7 +21,7 @@ const std::string Stringf( const char* format, ... )
    char textLiteral[ STRINGF_STACK_LOCAL_TEMP_LENGTH ];
    va_list variableArgumentList;
    va_start( variableArgumentList, format );
-   vsnprintf_s( textLiteral, STRINGF_STACK_LOCAL_TEMP_LENGTH, _TRUNCATE, format, variableArgumentList );	
+   vsnprintf( textLiteral, STRINGF_STACK_LOCAL_TEMP_LENGTH, format, variableArgumentList );	
    va_end( variableArgumentList );
    textLiteral[ STRINGF_STACK_LOCAL_TEMP_LENGTH - 1 ] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
 
@@ -37,7 +39,7 @@ const std::string Stringf( const int maxLength, const char* format, ... )
 
    va_list variableArgumentList;
    va_start( variableArgumentList, format );
-   vsnprintf_s( textLiteral, maxLength, _TRUNCATE, format, variableArgumentList );	
+   vsnprintf( textLiteral, maxLength, format, variableArgumentList );	
    va_end( variableArgumentList );
    textLiteral[ maxLength - 1 ] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
 
@@ -1,4 +1,5 @@
 #include "Engine/IO/FileBinaryWriter.hpp"
+#include "Engine/IO/FileUtils.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
@@ -27,7 +28,7 @@ bool FileBinaryWriter::OpenFile(const std::string& fileName, bool append)
    }
 
 
-   errno_t error = fopen_s(&m_fileHandle, fileName.c_str(), writingMode);
+   int error = fopen_s(&m_fileHandle, fileName.c_str(), writingMode);
    {
       if (error != 0)
       {
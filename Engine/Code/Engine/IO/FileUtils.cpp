@@ -1,8 +1,31 @@
+#include <stdio.h>
+#include <errno.h>
+#if defined(_WIN32)
 #include <io.h>
+#include <direct.h>
+#else
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <dirent.h>
+#include <fnmatch.h>
+#include <sys/stat.h>
+#include <algorithm>
+#endif
 #include "Engine/IO/FileUtils.hpp"
 #include "Engine/Core/StringUtils.hpp"
 
 
+#if !defined(_WIN32)
+//-----------------------------------------------------------------------------------------------
+int fopen_s(FILE** out_file, const char* filePath, const char* mode)
+{
+   *out_file = fopen(filePath, mode);
+   return (*out_file == nullptr) ? errno : 0;
+}
+#endif
+
+
 //-----------------------------------------------------------------------------------------------
 bool LoadBinaryFileToBuffer(const std::string& filePath, std::vector<unsigned char>& out_buffer)
 {
@@ -49,7 +72,7 @@ bool LoadBinaryFileToBuffer(const std::string& filePath, std::vector<float>& out
 bool LoadTextFileToBuffer(const std::string& filePath, std::string& out_buffer)
 {
    FILE* fileToLoad = nullptr;
-   errno_t err = fopen_s(&fileToLoad, filePath.c_str(), "rb");
+   int err = fopen_s(&fileToLoad, filePath.c_str(), "rb");
    if (err)
    {
       return false;
@@ -100,10 +123,15 @@ bool SaveBufferToBinaryFile(const std::string& filePath, const std::vector<float
 //-----------------------------------------------------------------------------------------------
 const char* GetFullPath(const std::string& relativePath)
 {
+#if defined(_WIN32)
    return _fullpath(NULL, relativePath.c_str(), _MAX_PATH);
+#else
+   return realpath(relativePath.c_str(), NULL);
+#endif
 }
 
 
+#if defined(_WIN32)
 //-----------------------------------------------------------------------------------------------
 std::vector<std::string> EnumerateFilesInDirectory(const std::string& relativeDirectoryPath, const std::string& filePattern)
 {
@@ -130,4 +158,58 @@ std::vector<std::string> EnumerateFilesInDirectory(const std::string& relativeDi
 
       return foundFiles;
 }
+#else
+//-----------------------------------------------------------------------------------------------
+static bool IsFileNameLessIgnoringCase(const std::string& first, const std::string& second)
+{
+   return strcasecmp(first.c_str(), second.c_str()) < 0;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Matches and sorts by name without case, which is the order _findfirst gives on NTFS, so data files
+// load in the same order as on Windows
+std::vector<std::string> EnumerateFilesInDirectory(const std::string& relativeDirectoryPath, const std::string& filePattern)
+{
+   std::vector<std::string> foundFiles;
+
+   DIR* directory = opendir(relativeDirectoryPath.c_str());
+   if (directory == nullptr)
+   {
+      return foundFiles;
+   }
+
+   for (dirent* entry = readdir(directory); entry != nullptr; entry = readdir(directory))
+   {
+      bool isHidden = (entry->d_name[0] == '.');
+      if (isHidden || fnmatch(filePattern.c_str(), entry->d_name, FNM_CASEFOLD) != 0)
+      {
+         continue;
+      }
+
+      std::string relativePathToFile = Stringf("%s/%s", relativeDirectoryPath.c_str(), entry->d_name);
+      struct stat fileStatus;
+      bool isDirectory = (stat(relativePathToFile.c_str(), &fileStatus) == 0 && S_ISDIR(fileStatus.st_mode));
+      if (!isDirectory)
+      {
+         foundFiles.push_back(relativePathToFile);
+      }
+   }
+   closedir(directory);
+
+   std::sort(foundFiles.begin(), foundFiles.end(), IsFileNameLessIgnoringCase);
+   return foundFiles;
+}
+#endif
+
 
+//-----------------------------------------------------------------------------------------------
+// Only creates the last directory in the path
+bool CreateDirectoryIfMissing(const std::string& relativeDirectoryPath)
+{
+#if defined(_WIN32)
+   return (_mkdir(relativeDirectoryPath.c_str()) == 0 || errno == EEXIST);
+#else
+   return (mkdir(relativeDirectoryPath.c_str(), 0755) == 0 || errno == EEXIST);
+#endif
+}
\ No newline at end of file
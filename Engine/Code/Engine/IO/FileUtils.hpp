@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stdio.h>
 #include <string>
 #include <vector>
 
@@ -17,4 +18,12 @@ bool SaveBufferToBinaryFile(const std::string& filePath, const std::vector<float
 
 //-----------------------------------------------------------------------------------------------
 const char* GetFullPath(const std::string& relativePath);
-std::vector<std::string> EnumerateFilesInDirectory(const std::string& relativeDirectoryPath, const std::string& filePattern);
\ No newline at end of file
+std::vector<std::string> EnumerateFilesInDirectory(const std::string& relativeDirectoryPath, const std::string& filePattern);
+bool CreateDirectoryIfMissing(const std::string& relativeDirectoryPath);
+
+
+#if !defined(_WIN32)
+//-----------------------------------------------------------------------------------------------
+// The CRT's checked fopen, for platforms that don't have it
+int fopen_s(FILE** out_file, const char* filePath, const char* mode);
+#endif
\ No newline at end of file
@@ -8,7 +8,7 @@
 class IBinaryReader
 {
 public:
-   IBinaryReader() : m_mode(LITTLE_ENDIAN) {}
+   IBinaryReader() : m_mode(LITTLE_ENDIAN_MODE) {}
    virtual size_t ReadBytes(void* destination, const size_t numberOfBytesToRead) = 0;
    bool ReadString(std::string* outString);
    bool ReadInt(int* outInt);
@@ -9,7 +9,7 @@
 class IBinaryWriter
 {
 public:
-   IBinaryWriter() : m_mode(LITTLE_ENDIAN) {}
+   IBinaryWriter() : m_mode(LITTLE_ENDIAN_MODE) {}
    virtual size_t WriteBytes(const void* source, const size_t numberOfBytesToWrite) = 0;
    bool WriteString(const std::string& stringToWrite);
    bool WriteInt(int intToWrite);
@@ -0,0 +1,235 @@
+#include "Engine/IO/MemoryMappedFile.hpp"
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <stdint.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+//-----------------------------------------------------------------------------------------------
+// Elsewhere the handle holds a file descriptor
+#if defined(_WIN32)
+static void* const INVALID_FILE_HANDLE = INVALID_HANDLE_VALUE;
+#else
+static void* const INVALID_FILE_HANDLE = (void*)(intptr_t)-1;
+
+static int GetFileDescriptor(void* fileHandle) { return (int)(intptr_t)fileHandle; }
+#endif
+
+
+//-----------------------------------------------------------------------------------------------
+MemoryMappedFile::MemoryMappedFile()
+   : m_fileHandle(INVALID_FILE_HANDLE)
+   , m_mappingHandle(nullptr)
+   , m_data(nullptr)
+   , m_size(0)
+   , m_isWritable(false)
+{}
+
+
+//-----------------------------------------------------------------------------------------------
+MemoryMappedFile::~MemoryMappedFile()
+{
+   Close();
+}
+
+
+#if defined(_WIN32)
+//-----------------------------------------------------------------------------------------------
+bool MemoryMappedFile::OpenForReading(const std::string& filePath)
+{
+   bool didOpen = true;
+   Close();
+
+   m_fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+   if (m_fileHandle == INVALID_HANDLE_VALUE)
+   {
+      return !didOpen;
+   }
+
+   LARGE_INTEGER fileSize;
+   if (!GetFileSizeEx(m_fileHandle, &fileSize) || fileSize.QuadPart == 0)
+   {
+      Close();
+      return !didOpen;
+   }
+
+   m_isWritable = false;
+   return MapFile((size_t)fileSize.QuadPart);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Creates (or truncates) the file at the given size
+bool MemoryMappedFile::CreateForReadWrite(const std::string& filePath, size_t sizeInBytes)
+{
+   bool didCreate = true;
+   Close();
+
+   if (sizeInBytes == 0)
+   {
+      return !didCreate;
+   }
+
+   m_fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+   if (m_fileHandle == INVALID_HANDLE_VALUE)
+   {
+      return !didCreate;
+   }
+
+   m_isWritable = true;
+   return MapFile(sizeInBytes);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void MemoryMappedFile::Close()
+{
+   if (m_data != nullptr)
+   {
+      UnmapViewOfFile(m_data);
+      m_data = nullptr;
+   }
+
+   if (m_mappingHandle != nullptr)
+   {
+      CloseHandle(m_mappingHandle);
+      m_mappingHandle = nullptr;
+   }
+
+   if (m_fileHandle != INVALID_FILE_HANDLE)
+   {
+      CloseHandle(m_fileHandle);
+      m_fileHandle = INVALID_FILE_HANDLE;
+   }
+
+   m_size = 0;
+   m_isWritable = false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool MemoryMappedFile::MapFile(size_t sizeInBytes)
+{
+   bool didMap = true;
+
+   unsigned long long mappingSize = (unsigned long long)sizeInBytes;
+   DWORD protection = m_isWritable ? PAGE_READWRITE : PAGE_READONLY;
+   m_mappingHandle = CreateFileMappingA(m_fileHandle, nullptr, protection, (DWORD)(mappingSize >> 32), (DWORD)(mappingSize & 0xFFFFFFFF), nullptr);
+   if (m_mappingHandle == nullptr)
+   {
+      Close();
+      return !didMap;
+   }
+
+   DWORD access = m_isWritable ? (FILE_MAP_READ | FILE_MAP_WRITE) : FILE_MAP_READ;
+   m_data = (unsigned char*)MapViewOfFile(m_mappingHandle, access, 0, 0, sizeInBytes);
+   if (m_data == nullptr)
+   {
+      Close();
+      return !didMap;
+   }
+
+   m_size = sizeInBytes;
+   return didMap;
+}
+
+#else
+//-----------------------------------------------------------------------------------------------
+bool MemoryMappedFile::OpenForReading(const std::string& filePath)
+{
+   bool didOpen = true;
+   Close();
+
+   int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+   if (fileDescriptor < 0)
+   {
+      return !didOpen;
+   }
+
+   m_fileHandle = (void*)(intptr_t)fileDescriptor;
+   struct stat fileStatus;
+   if (fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size == 0)
+   {
+      Close();
+      return !didOpen;
+   }
+
+   m_isWritable = false;
+   return MapFile((size_t)fileStatus.st_size);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Creates (or truncates) the file at the given size
+bool MemoryMappedFile::CreateForReadWrite(const std::string& filePath, size_t sizeInBytes)
+{
+   bool didCreate = true;
+   Close();
+
+   if (sizeInBytes == 0)
+   {
+      return !didCreate;
+   }
+
+   int fileDescriptor = open(filePath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+   if (fileDescriptor < 0)
+   {
+      return !didCreate;
+   }
+
+   m_fileHandle = (void*)(intptr_t)fileDescriptor;
+   if (ftruncate(fileDescriptor, (off_t)sizeInBytes) != 0)
+   {
+      Close();
+      return !didCreate;
+   }
+
+   m_isWritable = true;
+   return MapFile(sizeInBytes);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void MemoryMappedFile::Close()
+{
+   if (m_data != nullptr)
+   {
+      munmap(m_data, m_size);
+      m_data = nullptr;
+   }
+
+   if (m_fileHandle != INVALID_FILE_HANDLE)
+   {
+      close(GetFileDescriptor(m_fileHandle));
+      m_fileHandle = INVALID_FILE_HANDLE;
+   }
+
+   m_size = 0;
+   m_isWritable = false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool MemoryMappedFile::MapFile(size_t sizeInBytes)
+{
+   bool didMap = true;
+
+   int protection = m_isWritable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+   void* mappedData = mmap(nullptr, sizeInBytes, protection, MAP_SHARED, GetFileDescriptor(m_fileHandle), 0);
+   if (mappedData == MAP_FAILED)
+   {
+      Close();
+      return !didMap;
+   }
+
+   m_data = (unsigned char*)mappedData;
+   m_size = sizeInBytes;
+   return didMap;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+
+
+//-----------------------------------------------------------------------------------------------
+class MemoryMappedFile
+{
+public:
+   MemoryMappedFile();
+   ~MemoryMappedFile();
+
+   bool OpenForReading(const std::string& filePath);
+   bool CreateForReadWrite(const std::string& filePath, size_t sizeInBytes);
+   void Close();
+
+   bool IsOpen() const { return m_data != nullptr; }
+   bool IsWritable() const { return m_isWritable; }
+   unsigned char* GetData() { return m_data; }
+   const unsigned char* GetData() const { return m_data; }
+   size_t GetSize() const { return m_size; }
+
+private:
+   MemoryMappedFile(const MemoryMappedFile&);
+   MemoryMappedFile& operator=(const MemoryMappedFile&);
+
+   bool MapFile(size_t sizeInBytes);
+
+   void* m_fileHandle;
+   void* m_mappingHandle;
+   unsigned char* m_data;
+   size_t m_size;
+   bool m_isWritable;
+};
\ No newline at end of file
@@ -1,8 +1,10 @@
 #include <cmath>
 #include <cstdlib>
+#include <limits>
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/Vector2f.hpp"
 #include "Engine/Math/IntRange.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Math/Vector3f.hpp"
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Math/EulerAngles.hpp"
@@ -84,21 +86,21 @@ float RadiansToDegrees(float radians)
 //-----------------------------------------------------------------------------------------------
 float GetRandomFloatBetween(float low, float high)
 {
-   return low + (rand() / (RAND_MAX / (high - low)));
+   return GetThreadRandomNumberGenerator().GetFloatBetween(low, high);
 }
 
 
 //-----------------------------------------------------------------------------------------------
 bool GetRandomTrueOrFalseWithProbability(float probabilityTrue)
 {
-   return GetRandomFloatBetween(0.f, 1.f) <= probabilityTrue;
+   return GetThreadRandomNumberGenerator().GetTrueOrFalseWithProbability(probabilityTrue);
 }
 
 
 //-----------------------------------------------------------------------------------------------
 bool GetRandomTrueOrFalse()
 {
-   return rand() % 2 ? true : false;
+   return GetThreadRandomNumberGenerator().GetTrueOrFalse();
 }
 
 
@@ -112,7 +114,7 @@ int GetRandomIntBetweenInclusive(const IntRange& range)
 //-----------------------------------------------------------------------------------------------
 int GetRandomIntBetweenInclusive(int low, int high)
 {
-   return (rand() % ((high + 1) - low) + low);
+   return GetThreadRandomNumberGenerator().GetIntBetweenInclusive(low, high);
 }
 
 
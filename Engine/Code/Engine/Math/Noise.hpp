@@ -18,7 +18,10 @@ float GetPseudoRandomNoise1D( int position );
 float GetPseudoRandomNoise2D( int positionX, int positionY );
 float GetPseudoRandomNoise3D( int positionX, int positionY, int positionZ );
 Vector2f GetPseudoRandomNoiseDirection2D( int positionX, int positionY );
+unsigned int GetSeededNoiseUint2D( int positionX, int positionY, unsigned int seed );
+float GetSeededNoiseZeroToOne2D( int positionX, int positionY, unsigned int seed );
 float ComputePerlinNoise2D( const Vector2f& position, float perlinNoiseGridCellSize, float baseAmplitude, int numOctaves, float persistance );
+void ComputePerlinNoiseGrid2D( float* out_values, const Vector2f& origin, int numSamplesX, int numSamplesY, float sampleSpacing, float perlinNoiseGridCellSize, float baseAmplitude, int numOctaves, float persistence );
 
 
 //-----------------------------------------------------------------------------------------------
@@ -74,3 +77,31 @@ inline Vector2f GetPseudoRandomNoiseDirection2D( int xPosition, int yPosition )
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Mixes x and y separately first, so unlike the functions above nearby positions never share a value
+inline unsigned int GetSeededNoiseUint2D( int positionX, int positionY, unsigned int seed )
+{
+	const unsigned int BIT_NOISE1 = 0xB5297A4D;
+	const unsigned int BIT_NOISE2 = 0x68E31DA4;
+	const unsigned int BIT_NOISE3 = 0x1B56C4E9;
+	const unsigned int PRIME_NUMBER = 198491317;
+
+	unsigned int mangledBits = (unsigned int) positionX + (PRIME_NUMBER * (unsigned int) positionY);
+	mangledBits *= BIT_NOISE1;
+	mangledBits += seed;
+	mangledBits ^= (mangledBits >> 8);
+	mangledBits += BIT_NOISE2;
+	mangledBits ^= (mangledBits << 8);
+	mangledBits *= BIT_NOISE3;
+	mangledBits ^= (mangledBits >> 8);
+	return mangledBits;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline float GetSeededNoiseZeroToOne2D( int positionX, int positionY, unsigned int seed )
+{
+	// Keep 24 bits so the result is exact in a float and never rounds up to 1
+	const float ONE_OVER_2_TO_THE_24 = (1.f / 16777216.f);
+	return ONE_OVER_2_TO_THE_24 * (float) (GetSeededNoiseUint2D( positionX, positionY, seed ) >> 8);
+}
@@ -0,0 +1,135 @@
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Math/IntRange.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+static inline unsigned int RotateLeft(unsigned int value, int numBits)
+{
+   return (value << numBits) | (value >> (32 - numBits));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// splitmix64, used only to spread a seed over the whole state
+static unsigned long long GetNextSplitMix(unsigned long long* inOutState)
+{
+   unsigned long long mixed = (*inOutState += 0x9E3779B97F4A7C15ULL);
+   mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+   mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBULL;
+   return mixed ^ (mixed >> 31);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+RandomNumberGenerator::RandomNumberGenerator()
+{
+   Seed(0);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+RandomNumberGenerator::RandomNumberGenerator(unsigned int seed, unsigned int streamID)
+{
+   Seed(seed, streamID);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void RandomNumberGenerator::Seed(unsigned int seed, unsigned int streamID)
+{
+   m_seed = seed;
+   m_streamID = streamID;
+
+   unsigned long long splitMixState = ((unsigned long long)streamID << 32) | seed;
+   unsigned long long firstHalf = GetNextSplitMix(&splitMixState);
+   unsigned long long secondHalf = GetNextSplitMix(&splitMixState);
+
+   // splitmix64 never yields two zero outputs in a row, so the state can't be all zero
+   m_state[0] = (unsigned int)firstHalf;
+   m_state[1] = (unsigned int)(firstHalf >> 32);
+   m_state[2] = (unsigned int)secondHalf;
+   m_state[3] = (unsigned int)(secondHalf >> 32);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+unsigned int RandomNumberGenerator::GetNextUint()
+{
+   unsigned int result = RotateLeft(m_state[1] * 5, 7) * 9;
+   unsigned int shiftedState = m_state[1] << 9;
+
+   m_state[2] ^= m_state[0];
+   m_state[3] ^= m_state[1];
+   m_state[1] ^= m_state[2];
+   m_state[0] ^= m_state[3];
+   m_state[2] ^= shiftedState;
+   m_state[3] = RotateLeft(m_state[3], 11);
+
+   return result;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Scales instead of taking a modulus, so small ranges stay even
+int RandomNumberGenerator::GetIntBetweenInclusive(int low, int high)
+{
+   if (high < low)
+   {
+      int swapTemp = low;
+      low = high;
+      high = swapTemp;
+   }
+
+   unsigned int rangeSize = (unsigned int)(high - low) + 1;
+   if (rangeSize == 0)
+   {
+      return (int)GetNextUint();
+   }
+
+   unsigned int offset = (unsigned int)(((unsigned long long)GetNextUint() * rangeSize) >> 32);
+   return low + (int)offset;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+int RandomNumberGenerator::GetIntBetweenInclusive(const IntRange& range)
+{
+   return GetIntBetweenInclusive(range.x, range.y);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// [0, 1) with 24 bits, which is all a float can hold
+float RandomNumberGenerator::GetFloatZeroToOne()
+{
+   return (float)(GetNextUint() >> 8) * (1.f / 16777216.f);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+float RandomNumberGenerator::GetFloatBetween(float low, float high)
+{
+   return low + ((high - low) * GetFloatZeroToOne());
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool RandomNumberGenerator::GetTrueOrFalse()
+{
+   return (GetNextUint() & 0x80000000) != 0;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+bool RandomNumberGenerator::GetTrueOrFalseWithProbability(float probabilityTrue)
+{
+   return GetFloatZeroToOne() < probabilityTrue;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+RandomNumberGenerator& GetThreadRandomNumberGenerator()
+{
+   static thread_local RandomNumberGenerator s_threadRandomNumberGenerator;
+   return s_threadRandomNumberGenerator;
+}
\ No newline at end of file
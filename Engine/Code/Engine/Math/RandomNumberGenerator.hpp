@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+
+
+//-----------------------------------------------------------------------------------------------
+class IntRange;
+
+
+//-----------------------------------------------------------------------------------------------
+// xoshiro128** - small, fast and explicitly seeded. Each generator is its own stream, so code that
+// owns one never sees draws made anywhere else, on this thread or any other
+class RandomNumberGenerator
+{
+public:
+   RandomNumberGenerator();
+   explicit RandomNumberGenerator(unsigned int seed, unsigned int streamID = 0);
+
+   void Seed(unsigned int seed, unsigned int streamID = 0);
+   unsigned int GetSeed() const { return m_seed; }
+   unsigned int GetStreamID() const { return m_streamID; }
+
+   unsigned int GetNextUint();
+   int GetIntBetweenInclusive(int low, int high);
+   int GetIntBetweenInclusive(const IntRange& range);
+   float GetFloatZeroToOne();
+   float GetFloatBetween(float low, float high);
+   bool GetTrueOrFalse();
+   bool GetTrueOrFalseWithProbability(float probabilityTrue);
+
+   template <typename CollectionType>
+   int GetIndexInCollection(const std::vector<CollectionType>& collection);
+
+   template <typename CollectionType>
+   const CollectionType& GetFromCollection(const std::vector<CollectionType>& collection);
+
+private:
+   unsigned int m_state[4];
+   unsigned int m_seed;
+   unsigned int m_streamID;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Backs the GetRandom* functions in MathUtils. Every thread starts from the same default seed
+RandomNumberGenerator& GetThreadRandomNumberGenerator();
+
+
+//-----------------------------------------------------------------------------------------------
+template <typename CollectionType>
+int RandomNumberGenerator::GetIndexInCollection(const std::vector<CollectionType>& collection)
+{
+   return GetIntBetweenInclusive(0, (int)collection.size() - 1);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+template <typename CollectionType>
+const CollectionType& RandomNumberGenerator::GetFromCollection(const std::vector<CollectionType>& collection)
+{
+   return collection[GetIntBetweenInclusive(0, (int)collection.size() - 1)];
+}
\ No newline at end of file
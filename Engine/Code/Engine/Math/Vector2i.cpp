@@ -1,3 +1,4 @@
+#include <stdio.h>
 #include <cmath>
 #include "Engine/Core/EngineCommon.hpp"
 
@@ -123,10 +124,10 @@ std::string Vector2i::ToString() const
 {
    std::string asString;
    char buf[50];
-   _itoa_s(x, buf, 10);
+   snprintf(buf, sizeof(buf), "%d", x);
    asString += buf;
    asString.push_back(',');
-   _itoa_s(y, buf, 10);
+   snprintf(buf, sizeof(buf), "%d", y);
    asString += buf;
 
    return asString;
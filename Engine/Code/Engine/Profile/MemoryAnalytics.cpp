@@ -2,5 +2,6 @@
 
 
 //-----------------------------------------------------------------------------------------------
-extern size_t g_numAllocations = 0;
-extern size_t g_totalAllocated = 0;
\ No newline at end of file
+std::atomic<size_t> g_numAllocations(0);
+std::atomic<size_t> g_totalAllocated(0);
+std::atomic<size_t> g_peakAllocated(0);
\ No newline at end of file
@@ -1,9 +1,14 @@
 #pragma once
 
+#include <stddef.h>
+#include <atomic>
+
 
 //-----------------------------------------------------------------------------------------------
-extern size_t g_numAllocations;
-extern size_t g_totalAllocated;
+// Updated from any thread that allocates
+extern std::atomic<size_t> g_numAllocations;
+extern std::atomic<size_t> g_totalAllocated;
+extern std::atomic<size_t> g_peakAllocated;
 
 
 //-----------------------------------------------------------------------------------------------
@@ -1,13 +1,17 @@
 //-----------------------------------------------------------------------------------------------
 // Time.cpp
-//	A simple high-precision time utility function for Windows
+//	A simple high-precision time utility function for Windows (and a monotonic clock elsewhere)
 //	based on code by Squirrel Eiserloh
 
 //-----------------------------------------------------------------------------------------------
 #include "Engine/Time/Time.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#if defined(_WIN32)
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
+#else
+#include <time.h>
+#endif
 
 
 //-----------------------------------------------------------------------------------------------
@@ -15,6 +19,7 @@ STATIC double Time::s_timeLastFrameBegan = 0.f;
 STATIC float Time::s_deltaSeconds = 0.f;
 
 
+#if defined(_WIN32)
 //-----------------------------------------------------------------------------------------------
 double InitializeTime( LARGE_INTEGER& out_initialTime )
 {
@@ -37,6 +42,26 @@ double Time::GetCurrentTimeSeconds()
 	double currentSeconds = double( elapsedCountsSinceInitialTime ) * secondsPerCount;
 	return currentSeconds;
 }
+#else
+//-----------------------------------------------------------------------------------------------
+timespec GetMonotonicTime()
+{
+	timespec currentTime;
+	clock_gettime( CLOCK_MONOTONIC, &currentTime );
+	return currentTime;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+double Time::GetCurrentTimeSeconds()
+{
+	static timespec initialTime = GetMonotonicTime();
+	timespec currentTime = GetMonotonicTime();
+
+	double currentSeconds = double( currentTime.tv_sec - initialTime.tv_sec ) + ( double( currentTime.tv_nsec - initialTime.tv_nsec ) * 1.0e-9 );
+	return currentSeconds;
+}
+#endif
 
 
 //-----------------------------------------------------------------------------------------------
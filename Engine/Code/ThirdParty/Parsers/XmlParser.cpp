@@ -57,7 +57,7 @@
 #pragma warning( disable : 4706 ) // assignment within conditional expression
 #pragma warning( disable : 4100 ) // unreferenced formal parameter
 
-#include "xmlParser.h"
+#include "XmlParser.h"
 #ifdef _XMLWINDOWS
 //#ifdef _DEBUG
 //#define _CRTDBG_MAP_ALLOC